@@ -0,0 +1,714 @@
+/* Read and annotate the CFG with a sampled profile.
+   Copyright (C) 2014 Free Software Foundation, Inc.
+
+This file is part of GCC.
+
+GCC is free software; you can redistribute it and/or modify it under
+the terms of the GNU General Public License as published by the Free
+Software Foundation; either version 3, or (at your option) any later
+version.
+
+GCC is distributed in the hope that it will be useful, but WITHOUT ANY
+WARRANTY; without even the implied warranty of MERCHANTABILITY or
+FITNESS FOR A PARTICULAR PURPOSE.  See the GNU General Public License
+for more details.
+
+You should have received a copy of the GNU General Public License
+along with GCC; see the file COPYING3.  If not see
+<http://www.gnu.org/licenses/>.  */
+
+/* -fauto-profile uses a profile collected by sampling an optimized,
+   uninstrumented binary, for example with perf, instead of the counts
+   written by a -fprofile-generate build.  The samples are keyed by
+   source location, so the profile survives changes to the compiler and
+   to the optimization options that would invalidate a .gcda file.
+
+   The profile is a text file.  Blank lines and lines starting with '#'
+   are ignored.  A function record
+
+     function NAME ENTRY-COUNT
+
+   where NAME is the assembler name of a function and ENTRY-COUNT the
+   number of times it was entered, is followed by the records for the
+   lines of its body
+
+     OFFSET[.DISCRIMINATOR] COUNT
+
+   where OFFSET is the line number relative to the line the function is
+   declared on, DISCRIMINATOR tells apart the blocks that share a line
+   (zero if omitted) and COUNT is the number of times the line was
+   executed, conventionally the largest number of samples taken on any
+   one of its instructions.  Samples in code that was inlined into NAME
+   are attributed to the line of the outermost inlined call in NAME,
+   which is the last frame printed by addr2line -i.
+
+   Each function found in the profile has the count of each basic block
+   set to the largest count among the lines of its statements.  The
+   counts of the remaining blocks and of the edges are derived from
+   them by flow conservation, splitting by the guessed branch
+   probabilities where that is not enough.  The function's profile
+   then counts as read, so the rest of the compiler uses it as it
+   would counts from -fprofile-use.  Functions missing from the
+   profile keep their guessed profile.  */
+
+#include "config.h"
+#include "system.h"
+#include "coretypes.h"
+#include "tm.h"
+#include "tree.h"
+#include "flags.h"
+#include "function.h"
+#include "basic-block.h"
+#include "diagnostic-core.h"
+#include "coverage.h"
+#include "tree-ssa-alias.h"
+#include "internal-fn.h"
+#include "gimple-expr.h"
+#include "is-a.h"
+#include "gimple.h"
+#include "gimple-iterator.h"
+#include "cgraph.h"
+#include "tree-cfg.h"
+#include "tree-pass.h"
+#include "profile.h"
+#include "predict.h"
+#include "params.h"
+#include "target.h"
+#include "hash-table.h"
+#include "filenames.h"
+#include "dumpfile.h"
+
+/* The count of one line of a function.  */
+
+struct afdo_line
+{
+  int offset;
+  unsigned discriminator;
+  gcov_type count;
+};
+
+/* The profile of a function.  */
+
+typedef struct afdo_function
+{
+  char *name;
+  gcov_type entry_count;
+  vec<afdo_line> lines;
+
+  /* hash_table support.  */
+  typedef afdo_function value_type;
+  typedef afdo_function compare_type;
+  static inline hashval_t hash (const value_type *);
+  static inline int equal (const value_type *, const compare_type *);
+  static inline void remove (value_type *);
+} afdo_function_t;
+
+inline hashval_t
+afdo_function::hash (const value_type *entry)
+{
+  return htab_hash_string (entry->name);
+}
+
+inline int
+afdo_function::equal (const value_type *entry1, const compare_type *entry2)
+{
+  return strcmp (entry1->name, entry2->name) == 0;
+}
+
+inline void
+afdo_function::remove (value_type *entry)
+{
+  free (entry->name);
+  entry->lines.release ();
+  free (entry);
+}
+
+/* The functions in the profile, by name.  */
+static hash_table <afdo_function> afdo_functions;
+
+/* The summary of the profile, which becomes profile_info.  */
+static struct gcov_ctr_summary afdo_summary;
+
+/* Marks the blocks and edges whose count is known, in their aux
+   fields.  */
+#define AFDO_KNOWN ((void *) 1)
+
+/* Compare line records by offset, then discriminator.  */
+
+static int
+afdo_line_cmp (const void *p1, const void *p2)
+{
+  const struct afdo_line *l1 = (const struct afdo_line *) p1;
+  const struct afdo_line *l2 = (const struct afdo_line *) p2;
+
+  if (l1->offset != l2->offset)
+    return l1->offset < l2->offset ? -1 : 1;
+  if (l1->discriminator != l2->discriminator)
+    return l1->discriminator < l2->discriminator ? -1 : 1;
+  return 0;
+}
+
+/* Parse a count at *P, advancing *P past it.  Return false if there is
+   none.  */
+
+static bool
+afdo_parse_count (char **p, gcov_type *count)
+{
+  char *s = *p;
+  gcov_type value = 0;
+
+  while (*s == ' ' || *s == '\t')
+    s++;
+  if (!ISDIGIT (*s))
+    return false;
+  for (; ISDIGIT (*s); s++)
+    {
+      if (value > (((gcov_type) 1 << 62) - 9) / 10)
+	return false;
+      value = value * 10 + (*s - '0');
+    }
+
+  *p = s;
+  *count = value;
+  return true;
+}
+
+/* Return true if only white space remains at P.  */
+
+static bool
+afdo_end_p (const char *p)
+{
+  while (*p == ' ' || *p == '\t' || *p == '\r')
+    p++;
+  return *p == '\0';
+}
+
+/* Add COUNT to the summary of the profile.  */
+
+static void
+afdo_add_to_summary (gcov_type count)
+{
+  gcov_bucket_type *bucket;
+
+  if (count <= 0)
+    return;
+
+  afdo_summary.num++;
+  afdo_summary.sum_all += count;
+  afdo_summary.sum_max = MAX (afdo_summary.sum_max, count);
+
+  bucket = &afdo_summary.histogram[gcov_histo_index (count)];
+  if (!bucket->num_counters || count < bucket->min_value)
+    bucket->min_value = count;
+  bucket->num_counters++;
+  bucket->cum_value += count;
+}
+
+/* Read the profile in FILENAME.  Return false if it cannot be read.  */
+
+static bool
+afdo_read_profile (const char *filename)
+{
+  FILE *file = fopen (filename, "r");
+  afdo_function_t *fn = NULL;
+  char *buffer;
+  size_t size = 0, allocated = 4096;
+  char *line, *next;
+  int lineno = 0;
+  bool ok = true;
+
+  if (!file)
+    {
+      error ("cannot open auto-profile file %qs: %m", filename);
+      return false;
+    }
+
+  buffer = XNEWVEC (char, allocated);
+  for (;;)
+    {
+      size += fread (buffer + size, 1, allocated - size - 1, file);
+      if (size < allocated - 1)
+	break;
+      allocated *= 2;
+      buffer = XRESIZEVEC (char, buffer, allocated);
+    }
+  buffer[size] = '\0';
+  fclose (file);
+
+  afdo_functions.create (100);
+  memset (&afdo_summary, 0, sizeof (afdo_summary));
+  afdo_summary.runs = 1;
+
+  for (line = buffer; line && ok; line = next)
+    {
+      char *p = line;
+
+      next = strchr (line, '\n');
+      if (next)
+	*next++ = '\0';
+      lineno++;
+
+      while (*p == ' ' || *p == '\t')
+	p++;
+      if (*p == '#' || afdo_end_p (p))
+	continue;
+
+      if (strncmp (p, "function", 8) == 0 && (p[8] == ' ' || p[8] == '\t'))
+	{
+	  afdo_function_t **slot;
+	  char *name;
+
+	  for (p += 8; *p == ' ' || *p == '\t'; p++)
+	    ;
+	  name = p;
+	  while (*p && *p != ' ' && *p != '\t')
+	    p++;
+	  if (*p)
+	    *p++ = '\0';
+
+	  fn = XCNEW (afdo_function_t);
+	  fn->name = xstrdup (name);
+	  if (!*name
+	      || !afdo_parse_count (&p, &fn->entry_count)
+	      || !afdo_end_p (p))
+	    {
+	      afdo_function::remove (fn);
+	      ok = false;
+	      break;
+	    }
+
+	  slot = afdo_functions.find_slot (fn, INSERT);
+	  if (*slot)
+	    {
+	      error ("function %qs appears twice in auto-profile file %qs",
+		     fn->name, filename);
+	      afdo_function::remove (fn);
+	      fn = NULL;
+	      ok = false;
+	      break;
+	    }
+	  *slot = fn;
+	}
+      else
+	{
+	  struct afdo_line rec;
+	  char *end;
+	  long value;
+
+	  value = strtol (p, &end, 10);
+	  if (end == p || !fn)
+	    {
+	      ok = false;
+	      break;
+	    }
+	  rec.offset = value;
+	  rec.discriminator = 0;
+	  p = end;
+	  if (*p == '.')
+	    {
+	      value = strtol (p + 1, &end, 10);
+	      if (end == p + 1 || value < 0)
+		{
+		  ok = false;
+		  break;
+		}
+	      rec.discriminator = value;
+	      p = end;
+	    }
+	  if (!afdo_parse_count (&p, &rec.count) || !afdo_end_p (p))
+	    {
+	      ok = false;
+	      break;
+	    }
+	  fn->lines.safe_push (rec);
+	  afdo_add_to_summary (rec.count);
+	}
+    }
+
+  if (!ok && !seen_error ())
+    error ("malformed record at line %d of auto-profile file %qs",
+	   lineno, filename);
+  free (buffer);
+
+  if (!ok)
+    {
+      afdo_functions.dispose ();
+      return false;
+    }
+
+  for (hash_table <afdo_function>::iterator it = afdo_functions.begin ();
+       it != afdo_functions.end (); ++it)
+    (*it).lines.qsort (afdo_line_cmp);
+
+  afdo_summary.run_max = afdo_summary.sum_max;
+  return true;
+}
+
+/* Return the location that the samples of STMT are attributed to: its
+   own, or if it was inlined the location of the outermost inlined
+   call.  */
+
+static location_t
+afdo_stmt_location (gimple stmt)
+{
+  location_t loc = gimple_location (stmt);
+  tree block;
+
+  for (block = gimple_block (stmt);
+       block && TREE_CODE (block) == BLOCK;
+       block = BLOCK_SUPERCONTEXT (block))
+    if (inlined_function_outer_scope_p (block))
+      loc = BLOCK_SOURCE_LOCATION (block);
+
+  return loc;
+}
+
+/* Look up the count of line OFFSET with DISCRIMINATOR in FN, falling back
+   to the record without a discriminator.  Return false if there is
+   neither.  */
+
+static bool
+afdo_lookup_line (const afdo_function_t *fn, int offset,
+		  unsigned discriminator, gcov_type *count)
+{
+  struct afdo_line key, *rec;
+
+  key.offset = offset;
+  key.discriminator = discriminator;
+  rec = (struct afdo_line *) bsearch (&key, fn->lines.address (),
+				      fn->lines.length (),
+				      sizeof (struct afdo_line),
+				      afdo_line_cmp);
+  if (!rec && discriminator)
+    {
+      key.discriminator = 0;
+      rec = (struct afdo_line *) bsearch (&key, fn->lines.address (),
+					  fn->lines.length (),
+					  sizeof (struct afdo_line),
+					  afdo_line_cmp);
+    }
+  if (!rec)
+    return false;
+
+  *count = rec->count;
+  return true;
+}
+
+/* Set the count of each block of the current function from the lines
+   of its statements in FN, marking the blocks found.  Return the number
+   of blocks found.  */
+
+static int
+afdo_annotate_blocks (const afdo_function_t *fn)
+{
+  expanded_location start = expand_location (DECL_SOURCE_LOCATION
+					     (current_function_decl));
+  basic_block bb;
+  int annotated = 0;
+
+  FOR_ALL_BB_FN (bb, cfun)
+    {
+      gimple_stmt_iterator gsi;
+      edge e;
+      edge_iterator ei;
+      bool found = false;
+
+      bb->count = 0;
+      FOR_EACH_EDGE (e, ei, bb->succs)
+	e->count = 0;
+
+      for (gsi = gsi_start_bb (bb); !gsi_end_p (gsi); gsi_next (&gsi))
+	{
+	  gimple stmt = gsi_stmt (gsi);
+	  expanded_location loc;
+	  gcov_type count;
+
+	  if (is_gimple_debug (stmt))
+	    continue;
+	  loc = expand_location (afdo_stmt_location (stmt));
+	  if (!loc.file || !start.file || filename_cmp (loc.file, start.file))
+	    continue;
+	  if (afdo_lookup_line (fn, loc.line - start.line, bb->discriminator,
+				&count))
+	    {
+	      bb->count = found ? MAX (bb->count, count) : count;
+	      found = true;
+	    }
+	}
+
+      if (found)
+	{
+	  bb->aux = AFDO_KNOWN;
+	  annotated++;
+	}
+    }
+
+  if (fn->entry_count > 0)
+    {
+      ENTRY_BLOCK_PTR_FOR_FN (cfun)->count = fn->entry_count;
+      ENTRY_BLOCK_PTR_FOR_FN (cfun)->aux = AFDO_KNOWN;
+    }
+
+  return annotated;
+}
+
+/* If the count of BB is known and all but one of EDGES are, set the
+   count of that one.  If the count of BB is unknown and those of all
+   EDGES are, set it to their sum.  Return true if anything was set.  */
+
+static bool
+afdo_propagate_edges (basic_block bb, vec<edge, va_gc> *edges)
+{
+  edge e, unknown = NULL;
+  edge_iterator ei;
+  gcov_type total = 0;
+  int num_unknown = 0;
+
+  FOR_EACH_EDGE (e, ei, edges)
+    if (e->aux)
+      total += e->count;
+    else
+      {
+	num_unknown++;
+	unknown = e;
+      }
+
+  if (bb->aux)
+    {
+      if (num_unknown != 1)
+	return false;
+      unknown->count = MAX (bb->count - total, 0);
+      unknown->aux = AFDO_KNOWN;
+      return true;
+    }
+
+  if (num_unknown != 0 || EDGE_COUNT (edges) == 0)
+    return false;
+  bb->count = total;
+  bb->aux = AFDO_KNOWN;
+  return true;
+}
+
+/* Split what remains of the count of each known block among its
+   unknown outgoing edges, by their guessed probabilities.  Return true
+   if any edge was set.  */
+
+static bool
+afdo_split_unknown_edges (void)
+{
+  basic_block bb;
+  bool changed = false;
+
+  FOR_ALL_BB_FN (bb, cfun)
+    {
+      edge e;
+      edge_iterator ei;
+      gcov_type total = 0, remaining;
+      int probability = 0, num_unknown = 0;
+
+      if (!bb->aux)
+	continue;
+
+      FOR_EACH_EDGE (e, ei, bb->succs)
+	if (e->aux)
+	  total += e->count;
+	else
+	  {
+	    probability += e->probability;
+	    num_unknown++;
+	  }
+      if (!num_unknown)
+	continue;
+
+      remaining = MAX (bb->count - total, 0);
+      FOR_EACH_EDGE (e, ei, bb->succs)
+	if (!e->aux)
+	  {
+	    e->count = (probability
+			? RDIV (remaining * e->probability, probability)
+			: remaining / num_unknown);
+	    e->aux = AFDO_KNOWN;
+	  }
+      changed = true;
+    }
+
+  return changed;
+}
+
+/* Derive the counts of the blocks and edges of the current function not
+   set by afdo_annotate_blocks, then the branch probabilities and block
+   frequencies, and mark the profile as read.  */
+
+static void
+afdo_propagate (void)
+{
+  basic_block bb;
+  bool changed;
+
+  do
+    {
+      changed = false;
+      FOR_ALL_BB_FN (bb, cfun)
+	{
+	  changed |= afdo_propagate_edges (bb, bb->succs);
+	  changed |= afdo_propagate_edges (bb, bb->preds);
+	}
+      if (!changed)
+	changed = afdo_split_unknown_edges ();
+    }
+  while (changed);
+
+  /* Whatever is left is not reachable from the known blocks.  */
+  FOR_ALL_BB_FN (bb, cfun)
+    {
+      edge e;
+      edge_iterator ei;
+
+      if (!bb->aux)
+	bb->count = 0;
+      FOR_EACH_EDGE (e, ei, bb->succs)
+	if (!e->aux)
+	  e->count = 0;
+    }
+
+  /* A function that was sampled but never seen entered, typically one
+     that runs a single long loop, was still entered.  */
+  if (ENTRY_BLOCK_PTR_FOR_FN (cfun)->count == 0)
+    FOR_EACH_BB_FN (bb, cfun)
+      if (bb->count > 0)
+	{
+	  ENTRY_BLOCK_PTR_FOR_FN (cfun)->count = 1;
+	  if (single_succ_p (ENTRY_BLOCK_PTR_FOR_FN (cfun)))
+	    single_succ_edge (ENTRY_BLOCK_PTR_FOR_FN (cfun))->count = 1;
+	  break;
+	}
+
+  /* Samples are noisy, so the counts need not add up.  Take the
+     probabilities from the outgoing edge counts and leave the guessed
+     ones where there are none.  */
+  FOR_ALL_BB_FN (bb, cfun)
+    {
+      edge e;
+      edge_iterator ei;
+      gcov_type total = 0;
+
+      FOR_EACH_EDGE (e, ei, bb->succs)
+	total += e->count;
+      FOR_EACH_EDGE (e, ei, bb->succs)
+	{
+	  if (total)
+	    e->probability = GCOV_COMPUTE_SCALE (e->count, total);
+	  e->aux = NULL;
+	}
+      bb->aux = NULL;
+    }
+
+  counts_to_freqs ();
+  profile_status_for_fn (cfun) = PROFILE_READ;
+  compute_function_frequency ();
+}
+
+/* Annotate the functions in the call graph with the profile.  */
+
+static unsigned int
+auto_profile (void)
+{
+  struct cgraph_node *node;
+
+  gcc_assert (cgraph_state == CGRAPH_STATE_IPA_SSA);
+
+  if (!afdo_read_profile (auto_profile_file ? auto_profile_file
+			  : "fbdata.afdo"))
+    return 0;
+
+  /* Blocks are hot if they are among those making up most of the
+     samples, as with the histogram of a .gcda file.  */
+  profile_info = &afdo_summary;
+  get_working_sets ();
+
+  FOR_EACH_DEFINED_FUNCTION (node)
+    {
+      afdo_function_t key, *fn;
+      int annotated;
+
+      if (!gimple_has_body_p (node->decl)
+	  || DECL_SOURCE_LOCATION (node->decl) == BUILTINS_LOCATION)
+	continue;
+
+      key.name = CONST_CAST (char *, targetm.strip_name_encoding
+			     (IDENTIFIER_POINTER
+			      (DECL_ASSEMBLER_NAME (node->decl))));
+      fn = afdo_functions.find (&key);
+      if (!fn)
+	continue;
+
+      push_cfun (DECL_STRUCT_FUNCTION (node->decl));
+
+      annotated = afdo_annotate_blocks (fn);
+      if (dump_file)
+	fprintf (dump_file, "%s: annotated %d of %d blocks\n",
+		 fn->name, annotated, n_basic_blocks_for_fn (cfun));
+      if (annotated)
+	{
+	  afdo_propagate ();
+	  node->count = ENTRY_BLOCK_PTR_FOR_FN (cfun)->count;
+	  rebuild_cgraph_edges ();
+	  if (dump_file)
+	    dump_function_to_file (node->decl, dump_file, dump_flags);
+	}
+      else
+	ENTRY_BLOCK_PTR_FOR_FN (cfun)->aux = NULL;
+
+      pop_cfun ();
+    }
+
+  afdo_functions.dispose ();
+  return 0;
+}
+
+/* Read the sampled profile unless counts come from instrumentation.  */
+
+static bool
+gate_auto_profile_ipa (void)
+{
+  return (flag_auto_profile && !in_lto_p
+	  && !flag_branch_probabilities && !profile_arc_flag);
+}
+
+namespace {
+
+const pass_data pass_data_ipa_auto_profile =
+{
+  SIMPLE_IPA_PASS, /* type */
+  "afdo", /* name */
+  OPTGROUP_NONE, /* optinfo_flags */
+  true, /* has_gate */
+  true, /* has_execute */
+  TV_IPA_AUTOFDO, /* tv_id */
+  0, /* properties_required */
+  0, /* properties_provided */
+  0, /* properties_destroyed */
+  0, /* todo_flags_start */
+  0, /* todo_flags_finish */
+};
+
+class pass_ipa_auto_profile : public simple_ipa_opt_pass
+{
+public:
+  pass_ipa_auto_profile (gcc::context *ctxt)
+    : simple_ipa_opt_pass (pass_data_ipa_auto_profile, ctxt)
+  {}
+
+  /* opt_pass methods: */
+  bool gate () { return gate_auto_profile_ipa (); }
+  unsigned int execute () { return auto_profile (); }
+
+}; // class pass_ipa_auto_profile
+
+} // anon namespace
+
+simple_ipa_opt_pass *
+make_pass_ipa_auto_profile (gcc::context *ctxt)
+{
+  return new pass_ipa_auto_profile (ctxt);
+}
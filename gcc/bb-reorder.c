@@ -70,12 +70,24 @@
    To implement the change for code size optimization, block's index is
    selected as the key and all traces are found in one round.
 
+   With -freorder-blocks-algorithm=ext-tsp, functions optimized for speed
+   are instead laid out by maximizing the Ext-TSP score, which rewards
+   fall-through edges and, to a lesser extent, short jumps, each by the
+   frequency of the edge.  This usually leaves fewer taken branches than
+   the traces above on functions with many hot blocks, such as
+   interpreter loops, at a cost quadratic in the number of blocks, so
+   larger functions still use the traces.
+
    References:
 
    "Software Trace Cache"
    A. Ramirez, J. Larriba-Pey, C. Navarro, J. Torrellas and M. Valero; 1999
    http://citeseer.nj.nec.com/15361.html
 
+   "Improved Basic Block Reordering"
+   A. Newell and S. Pupyrev; 2018
+   https://arxiv.org/abs/1809.04676
+
 */
 
 #include "config.h"
@@ -2213,6 +2225,653 @@ add_reg_crossing_jump_notes (void)
 	add_reg_note (BB_END (e->src), REG_CROSSING_JUMP, NULL_RTX);
 }
 
+/* The Ext-TSP layout.  Blocks start out in chains of their own and
+   chains are merged greedily, at each step picking the merge that most
+   increases the Ext-TSP score of the layout, until no merge increases
+   it.  Besides concatenating two chains X and Y, a merge may split a
+   short chain X into X1 and X2 and form X1 Y X2, Y X2 X1 or X2 X1 Y.
+   The chains are finally laid out by decreasing execution density, the
+   chain of the first block first and the hot partition before the
+   cold one.
+
+   The score of a merge only depends on the edges it changes, which are
+   found from the blocks of the shorter chain, or of X when X is split.
+   The best merge of each pair of adjacent chains is cached until one
+   of the chains changes.  */
+
+/* The chains a merge may split, by number of blocks.  */
+#define EXT_TSP_SPLIT_THRESHOLD 32
+
+/* The longest forward and backward jumps, in bytes, that score
+   anything.  */
+#define EXT_TSP_FORWARD_DISTANCE 1024
+#define EXT_TSP_BACKWARD_DISTANCE 640
+
+/* The ways two chains X and Y can be merged, X being split into X1 and
+   X2.  Concatenating X and Y is X1_Y_X2 with X2 empty.  */
+enum ext_tsp_merge_type
+{
+  EXT_TSP_X1_Y_X2,
+  EXT_TSP_Y_X2_X1,
+  EXT_TSP_X2_X1_Y
+};
+
+/* The best merge found of a chain with another chain.  */
+struct ext_tsp_merge
+{
+  /* The other chain and the versions of both chains the merge was
+     computed for.  */
+  int other;
+  int version, other_version;
+
+  /* The increase of the score, and how to get it: whether this chain
+     is X, the type of merge and the number of blocks in X1.  */
+  gcov_type gain;
+  bool x_is_this;
+  enum ext_tsp_merge_type type;
+  int split;
+};
+
+/* A chain of blocks.  Chains are numbered by the index of the block
+   they started out with.  */
+struct ext_tsp_chain
+{
+  /* The indices of the blocks, in layout order.  Empty once the chain
+     has been merged into another.  */
+  vec<int> blocks;
+
+  /* The Ext-TSP score of the edges within the chain, the sum of the
+     frequencies of its blocks and the sum of their sizes.  */
+  gcov_type score;
+  gcov_type frequency;
+  int size;
+
+  /* Bumped whenever the chain changes.  */
+  int version;
+
+  /* The merges computed with chains of higher numbers.  */
+  vec<ext_tsp_merge> merges;
+};
+
+/* The chains, and for each block, indexed by block index, its chain,
+   its estimated size in bytes, and its position and offset in bytes
+   in its chain.  */
+static struct ext_tsp_chain *ext_tsp_chains;
+static int *ext_tsp_chain_of;
+static int *ext_tsp_size;
+static int *ext_tsp_pos;
+static int *ext_tsp_offset;
+
+/* While the merges of a chain are looked at, the position in its
+   cache of the merge with each other chain, valid where the stamp
+   matches.  */
+static int *ext_tsp_slot;
+static int *ext_tsp_slot_stamp;
+static int ext_tsp_stamp;
+
+/* Return the estimated size in bytes of BB.  */
+
+static int
+ext_tsp_bb_size (basic_block bb)
+{
+  rtx insn;
+  int size = 0;
+
+  FOR_BB_INSNS (bb, insn)
+    if (NONDEBUG_INSN_P (insn))
+      size += get_attr_min_length (insn);
+
+  return size;
+}
+
+/* Return the Ext-TSP score of an edge executed FREQ times from a block
+   at SRC_ADDR of SRC_SIZE bytes to a block at DST_ADDR.  A fall-through
+   scores ten times its frequency, a short jump up to its frequency,
+   decreasing linearly with the distance jumped; the scores are scaled
+   by EXT_TSP_FORWARD_DISTANCE to keep them integral.  */
+
+static gcov_type
+ext_tsp_edge_score (int src_addr, int src_size, int dst_addr, int freq)
+{
+  int src_end = src_addr + src_size;
+
+  if (dst_addr == src_end)
+    return (gcov_type) freq * EXT_TSP_FORWARD_DISTANCE * 10;
+  if (dst_addr > src_end)
+    {
+      int distance = dst_addr - src_end;
+      if (distance < EXT_TSP_FORWARD_DISTANCE)
+	return (gcov_type) freq * (EXT_TSP_FORWARD_DISTANCE - distance);
+    }
+  else
+    {
+      int distance = src_end - dst_addr;
+      if (distance < EXT_TSP_BACKWARD_DISTANCE)
+	return ((gcov_type) freq * (EXT_TSP_BACKWARD_DISTANCE - distance)
+		* EXT_TSP_FORWARD_DISTANCE / EXT_TSP_BACKWARD_DISTANCE);
+    }
+  return 0;
+}
+
+/* Return the address of block INDEX when chains X and Y are merged by
+   TYPE, X1 being the first SPLIT blocks of X.  */
+
+static int
+ext_tsp_merged_addr (int index, struct ext_tsp_chain *x,
+		     struct ext_tsp_chain *y, enum ext_tsp_merge_type type,
+		     int split)
+{
+  int x1_size = ((unsigned int) split < x->blocks.length ()
+		 ? ext_tsp_offset[x->blocks[split]] : x->size);
+  int offset = ext_tsp_offset[index];
+
+  if (&ext_tsp_chains[ext_tsp_chain_of[index]] == y)
+    switch (type)
+      {
+      case EXT_TSP_X1_Y_X2:
+	return x1_size + offset;
+      case EXT_TSP_Y_X2_X1:
+	return offset;
+      case EXT_TSP_X2_X1_Y:
+	return x->size + offset;
+      default:
+	gcc_unreachable ();
+      }
+
+  if (ext_tsp_pos[index] < split)
+    switch (type)
+      {
+      case EXT_TSP_X1_Y_X2:
+	return offset;
+      case EXT_TSP_Y_X2_X1:
+	return y->size + x->size - x1_size + offset;
+      case EXT_TSP_X2_X1_Y:
+	return x->size - x1_size + offset;
+      default:
+	gcc_unreachable ();
+      }
+
+  switch (type)
+    {
+    case EXT_TSP_X1_Y_X2:
+      return y->size + offset;
+    case EXT_TSP_Y_X2_X1:
+      return y->size + offset - x1_size;
+    case EXT_TSP_X2_X1_Y:
+      return offset - x1_size;
+    default:
+      gcc_unreachable ();
+    }
+}
+
+/* Return the increase of the Ext-TSP score from merging chains X and Y
+   by TYPE, X1 being the first SPLIT blocks of X.  */
+
+static gcov_type
+ext_tsp_merge_gain (struct ext_tsp_chain *x, struct ext_tsp_chain *y,
+		    enum ext_tsp_merge_type type, int split)
+{
+  bool x_changed = (unsigned int) split < x->blocks.length () && split > 0;
+  struct ext_tsp_chain *walk, *other;
+  gcov_type gain = 0;
+  unsigned int i;
+  int index;
+
+  /* The edges within Y do not change, nor those within X unless X is
+     split.  */
+  if (x_changed || x->blocks.length () <= y->blocks.length ())
+    walk = x, other = y;
+  else
+    walk = y, other = x;
+
+  FOR_EACH_VEC_ELT (walk->blocks, i, index)
+    {
+      basic_block bb = BASIC_BLOCK_FOR_FN (cfun, index);
+      int addr = ext_tsp_merged_addr (index, x, y, type, split);
+      edge e;
+      edge_iterator ei;
+
+      FOR_EACH_EDGE (e, ei, bb->succs)
+	{
+	  struct ext_tsp_chain *dest_chain;
+
+	  if ((e->flags & EDGE_COMPLEX)
+	      || e->dest == EXIT_BLOCK_PTR_FOR_FN (cfun))
+	    continue;
+	  dest_chain = &ext_tsp_chains[ext_tsp_chain_of[e->dest->index]];
+	  if (dest_chain == other || (dest_chain == walk && x_changed))
+	    gain += ext_tsp_edge_score (addr, ext_tsp_size[index],
+					ext_tsp_merged_addr (e->dest->index,
+							     x, y, type,
+							     split),
+					EDGE_FREQUENCY (e));
+	}
+
+      FOR_EACH_EDGE (e, ei, bb->preds)
+	{
+	  if ((e->flags & EDGE_COMPLEX)
+	      || e->src == ENTRY_BLOCK_PTR_FOR_FN (cfun)
+	      || &ext_tsp_chains[ext_tsp_chain_of[e->src->index]] != other)
+	    continue;
+	  gain += ext_tsp_edge_score (ext_tsp_merged_addr (e->src->index,
+							   x, y, type, split),
+				      ext_tsp_size[e->src->index], addr,
+				      EDGE_FREQUENCY (e));
+	}
+    }
+
+  if (x_changed)
+    gain -= x->score;
+  return gain;
+}
+
+/* Find the best merge with X playing X and Y playing Y, updating MERGE
+   if it is better.  X is only split next to blocks joined to Y by an
+   edge, as other splits are unlikely to help.  */
+
+static void
+ext_tsp_best_merge_1 (struct ext_tsp_merge *merge, bool x_is_this,
+		      struct ext_tsp_chain *x, struct ext_tsp_chain *y)
+{
+  int first = ENTRY_BLOCK_PTR_FOR_FN (cfun)->next_bb->index;
+  int n = x->blocks.length ();
+  bool splits[EXT_TSP_SPLIT_THRESHOLD + 1];
+  int split, type, index;
+  unsigned int i;
+
+  /* Nothing may precede the first block of the function.  */
+  if (y->blocks[0] == first)
+    return;
+
+  memset (splits, 0, sizeof (splits));
+  if (n <= EXT_TSP_SPLIT_THRESHOLD)
+    FOR_EACH_VEC_ELT (x->blocks, i, index)
+      {
+	basic_block bb = BASIC_BLOCK_FOR_FN (cfun, index);
+	edge e;
+	edge_iterator ei;
+	bool joined = false;
+
+	FOR_EACH_EDGE (e, ei, bb->succs)
+	  if (e->dest != EXIT_BLOCK_PTR_FOR_FN (cfun)
+	      && &ext_tsp_chains[ext_tsp_chain_of[e->dest->index]] == y)
+	    joined = true;
+	FOR_EACH_EDGE (e, ei, bb->preds)
+	  if (e->src != ENTRY_BLOCK_PTR_FOR_FN (cfun)
+	      && &ext_tsp_chains[ext_tsp_chain_of[e->src->index]] == y)
+	    joined = true;
+	if (joined)
+	  splits[i] = splits[i + 1] = true;
+      }
+
+  for (type = EXT_TSP_X1_Y_X2; type <= EXT_TSP_X2_X1_Y; type++)
+    {
+      if (type != EXT_TSP_X1_Y_X2 && x->blocks[0] == first)
+	break;
+
+      for (split = 1; split <= n; split++)
+	{
+	  gcov_type gain;
+
+	  /* The other types without a split repeat X1_Y_X2 or Y_X2_X1
+	     with the chains swapped.  */
+	  if (split == n
+	      ? type != EXT_TSP_X1_Y_X2
+	      : n > EXT_TSP_SPLIT_THRESHOLD || !splits[split])
+	    continue;
+
+	  gain = ext_tsp_merge_gain (x, y, (enum ext_tsp_merge_type) type,
+				     split);
+	  if (gain > merge->gain)
+	    {
+	      merge->gain = gain;
+	      merge->x_is_this = x_is_this;
+	      merge->type = (enum ext_tsp_merge_type) type;
+	      merge->split = split;
+	    }
+	}
+    }
+}
+
+/* Return the best merge of chain A with chain B, where A < B, computing
+   it unless it is cached.  The cache of A must have been indexed by
+   ext_tsp_index_merges.  */
+
+static struct ext_tsp_merge *
+ext_tsp_best_merge (int a, int b)
+{
+  struct ext_tsp_chain *ca = &ext_tsp_chains[a];
+  struct ext_tsp_chain *cb = &ext_tsp_chains[b];
+  struct ext_tsp_merge *merge, new_merge;
+  unsigned int i = ca->merges.length ();
+
+  if (ext_tsp_slot_stamp[b] == ext_tsp_stamp)
+    {
+      i = ext_tsp_slot[b];
+      merge = &ca->merges[i];
+      if (merge->version == ca->version
+	  && merge->other_version == cb->version)
+	return merge;
+    }
+
+  new_merge.other = b;
+  new_merge.version = ca->version;
+  new_merge.other_version = cb->version;
+  new_merge.gain = 0;
+  new_merge.x_is_this = true;
+  new_merge.type = EXT_TSP_X1_Y_X2;
+  new_merge.split = 0;
+  ext_tsp_best_merge_1 (&new_merge, true, ca, cb);
+  ext_tsp_best_merge_1 (&new_merge, false, cb, ca);
+
+  if (i < ca->merges.length ())
+    ca->merges[i] = new_merge;
+  else
+    ca->merges.safe_push (new_merge);
+  return &ca->merges[i];
+}
+
+/* Index the cached merges of chain A for ext_tsp_best_merge.  */
+
+static void
+ext_tsp_index_merges (int a)
+{
+  struct ext_tsp_merge *merge;
+  unsigned int i;
+
+  ext_tsp_stamp++;
+  FOR_EACH_VEC_ELT (ext_tsp_chains[a].merges, i, merge)
+    {
+      ext_tsp_slot[merge->other] = i;
+      ext_tsp_slot_stamp[merge->other] = ext_tsp_stamp;
+    }
+}
+
+/* Merge chain B into chain A as described by MERGE.  */
+
+static void
+ext_tsp_apply_merge (int a, int b, const struct ext_tsp_merge *merge)
+{
+  struct ext_tsp_chain *ca = &ext_tsp_chains[a];
+  struct ext_tsp_chain *cb = &ext_tsp_chains[b];
+  struct ext_tsp_chain *x = merge->x_is_this ? ca : cb;
+  struct ext_tsp_chain *y = merge->x_is_this ? cb : ca;
+  vec<int> x1 = vNULL, x2 = vNULL, seq = vNULL;
+  unsigned int i;
+  int index, offset = 0;
+
+  for (i = 0; i < (unsigned int) merge->split; i++)
+    x1.safe_push (x->blocks[i]);
+  for (; i < x->blocks.length (); i++)
+    x2.safe_push (x->blocks[i]);
+
+  switch (merge->type)
+    {
+    case EXT_TSP_X1_Y_X2:
+      seq.safe_splice (x1);
+      seq.safe_splice (y->blocks);
+      seq.safe_splice (x2);
+      break;
+    case EXT_TSP_Y_X2_X1:
+      seq.safe_splice (y->blocks);
+      seq.safe_splice (x2);
+      seq.safe_splice (x1);
+      break;
+    case EXT_TSP_X2_X1_Y:
+      seq.safe_splice (x2);
+      seq.safe_splice (x1);
+      seq.safe_splice (y->blocks);
+      break;
+    default:
+      gcc_unreachable ();
+    }
+
+  FOR_EACH_VEC_ELT (seq, i, index)
+    {
+      ext_tsp_chain_of[index] = a;
+      ext_tsp_pos[index] = i;
+      ext_tsp_offset[index] = offset;
+      offset += ext_tsp_size[index];
+    }
+
+  ca->score += cb->score + merge->gain;
+  ca->frequency += cb->frequency;
+  ca->size += cb->size;
+  ca->version++;
+  ca->merges.truncate (0);
+  ca->blocks.release ();
+  ca->blocks = seq;
+  cb->blocks.release ();
+  cb->merges.release ();
+  x1.release ();
+  x2.release ();
+}
+
+/* Helper for qsort; sort chains for layout.  The chain of the first
+   block comes first, then the chains in its partition, and within a
+   partition the chains by decreasing execution density.  */
+
+static int
+ext_tsp_chain_cmp (const void *pa, const void *pb)
+{
+  const struct ext_tsp_chain *a = *(const struct ext_tsp_chain * const *) pa;
+  const struct ext_tsp_chain *b = *(const struct ext_tsp_chain * const *) pb;
+  basic_block first = ENTRY_BLOCK_PTR_FOR_FN (cfun)->next_bb;
+  basic_block bb_a = BASIC_BLOCK_FOR_FN (cfun, a->blocks[0]);
+  basic_block bb_b = BASIC_BLOCK_FOR_FN (cfun, b->blocks[0]);
+  gcov_type density_a, density_b;
+
+  if (bb_a == first || bb_b == first)
+    return bb_a == first ? -1 : 1;
+  if (BB_PARTITION (bb_a) != BB_PARTITION (bb_b))
+    return BB_PARTITION (bb_a) == BB_PARTITION (first) ? -1 : 1;
+
+  density_a = a->frequency * MAX (b->size, 1);
+  density_b = b->frequency * MAX (a->size, 1);
+  if (density_a != density_b)
+    return density_a > density_b ? -1 : 1;
+  return a->blocks[0] - b->blocks[0];
+}
+
+/* Lay out the blocks of the current function by the Ext-TSP algorithm,
+   chaining them through their aux fields.  */
+
+static void
+reorder_basic_blocks_ext_tsp (void)
+{
+  int n = last_basic_block_for_fn (cfun);
+  vec<ext_tsp_chain *> order = vNULL;
+  int *neighbor_stamp;
+  basic_block bb, prev;
+  gcov_type score = 0;
+  unsigned int i;
+  int index;
+
+  ext_tsp_chains = XCNEWVEC (struct ext_tsp_chain, n);
+  ext_tsp_chain_of = XNEWVEC (int, n);
+  ext_tsp_size = XNEWVEC (int, n);
+  ext_tsp_pos = XCNEWVEC (int, n);
+  ext_tsp_offset = XCNEWVEC (int, n);
+  ext_tsp_slot = XNEWVEC (int, n);
+  ext_tsp_slot_stamp = XCNEWVEC (int, n);
+  ext_tsp_stamp = 0;
+  neighbor_stamp = XCNEWVEC (int, n);
+
+  FOR_EACH_BB_FN (bb, cfun)
+    {
+      struct ext_tsp_chain *chain = &ext_tsp_chains[bb->index];
+      edge e;
+      edge_iterator ei;
+
+      ext_tsp_chain_of[bb->index] = bb->index;
+      ext_tsp_size[bb->index] = ext_tsp_bb_size (bb);
+      chain->blocks.safe_push (bb->index);
+      chain->frequency = bb->frequency;
+      chain->size = ext_tsp_size[bb->index];
+      FOR_EACH_EDGE (e, ei, bb->succs)
+	if (e->dest == bb && !(e->flags & EDGE_COMPLEX))
+	  chain->score += ext_tsp_edge_score (0, chain->size, 0,
+					      EDGE_FREQUENCY (e));
+    }
+
+  for (;;)
+    {
+      struct ext_tsp_merge best;
+      int best_a = -1;
+
+      memset (&best, 0, sizeof (best));
+
+      /* Find the best merge of any two chains joined by an edge.  */
+      FOR_EACH_BB_FN (bb, cfun)
+	{
+	  struct ext_tsp_chain *chain = &ext_tsp_chains[bb->index];
+	  int dir;
+
+	  if (chain->blocks.is_empty ())
+	    continue;
+	  ext_tsp_index_merges (bb->index);
+	  FOR_EACH_VEC_ELT (chain->blocks, i, index)
+	    for (dir = 0; dir < 2; dir++)
+	      {
+		basic_block src = BASIC_BLOCK_FOR_FN (cfun, index);
+		edge e;
+		edge_iterator ei;
+
+		FOR_EACH_EDGE (e, ei, dir ? src->preds : src->succs)
+		  {
+		    basic_block other = dir ? e->src : e->dest;
+		    struct ext_tsp_merge *merge;
+		    int c;
+
+		    if (other == ENTRY_BLOCK_PTR_FOR_FN (cfun)
+			|| other == EXIT_BLOCK_PTR_FOR_FN (cfun)
+			|| (e->flags & EDGE_COMPLEX))
+		      continue;
+		    c = ext_tsp_chain_of[other->index];
+		    if (c <= bb->index || neighbor_stamp[c] == ext_tsp_stamp
+			|| BB_PARTITION (other) != BB_PARTITION (bb))
+		      continue;
+		    neighbor_stamp[c] = ext_tsp_stamp;
+
+		    merge = ext_tsp_best_merge (bb->index, c);
+		    if (merge->gain > 0
+			&& (best_a < 0 || merge->gain > best.gain))
+		      {
+			best = *merge;
+			best_a = bb->index;
+		      }
+		  }
+	      }
+	}
+      if (best_a < 0)
+	break;
+
+      ext_tsp_apply_merge (best_a, best.other, &best);
+    }
+
+  /* Lay out the chains.  */
+  FOR_EACH_BB_FN (bb, cfun)
+    if (!ext_tsp_chains[bb->index].blocks.is_empty ())
+      {
+	order.safe_push (&ext_tsp_chains[bb->index]);
+	score += ext_tsp_chains[bb->index].score;
+      }
+  order.qsort (ext_tsp_chain_cmp);
+
+  prev = NULL;
+  for (i = 0; i < order.length (); i++)
+    {
+      unsigned int j;
+
+      FOR_EACH_VEC_ELT (order[i]->blocks, j, index)
+	{
+	  bb = BASIC_BLOCK_FOR_FN (cfun, index);
+	  if (prev)
+	    prev->aux = bb;
+	  prev = bb;
+	}
+      order[i]->blocks.release ();
+      order[i]->merges.release ();
+    }
+  prev->aux = NULL;
+
+  if (dump_file)
+    fprintf (dump_file, "Ext-TSP layout: %u chains, score "
+	     HOST_WIDEST_INT_PRINT_DEC "\n",
+	     order.length (), (HOST_WIDEST_INT) score);
+
+  order.release ();
+  free (neighbor_stamp);
+  free (ext_tsp_slot_stamp);
+  free (ext_tsp_slot);
+  free (ext_tsp_offset);
+  free (ext_tsp_pos);
+  free (ext_tsp_size);
+  free (ext_tsp_chain_of);
+  free (ext_tsp_chains);
+}
+
+/* Return the sum of the frequencies of the edges that do not fall
+   through in the current order of the blocks.  */
+
+static gcov_type
+taken_branch_frequency (void)
+{
+  gcov_type freq = 0;
+  basic_block bb;
+
+  FOR_EACH_BB_FN (bb, cfun)
+    {
+      edge e;
+      edge_iterator ei;
+
+      FOR_EACH_EDGE (e, ei, bb->succs)
+	if (!(e->flags & EDGE_COMPLEX)
+	    && e->dest != EXIT_BLOCK_PTR_FOR_FN (cfun)
+	    && e->dest != bb->next_bb)
+	  freq += EDGE_FREQUENCY (e);
+    }
+
+  return freq;
+}
+
+
+/* Return the Ext-TSP score of the current order of the blocks.  */
+
+static gcov_type
+ext_tsp_order_score (void)
+{
+  int *addr = XNEWVEC (int, last_basic_block_for_fn (cfun));
+  int *size = XNEWVEC (int, last_basic_block_for_fn (cfun));
+  gcov_type score = 0;
+  basic_block bb;
+  int offset = 0;
+
+  FOR_EACH_BB_FN (bb, cfun)
+    {
+      addr[bb->index] = offset;
+      size[bb->index] = ext_tsp_bb_size (bb);
+      offset += size[bb->index];
+    }
+
+  FOR_EACH_BB_FN (bb, cfun)
+    {
+      edge e;
+      edge_iterator ei;
+
+      FOR_EACH_EDGE (e, ei, bb->succs)
+	if (!(e->flags & EDGE_COMPLEX)
+	    && e->dest != EXIT_BLOCK_PTR_FOR_FN (cfun))
+	  score += ext_tsp_edge_score (addr[bb->index], size[bb->index],
+				       addr[e->dest->index],
+				       EDGE_FREQUENCY (e));
+    }
+
+  free (size);
+  free (addr);
+  return score;
+}
+
 /* Reorder basic blocks.  The main entry point to this file.  FLAGS is
    the set of flags to pass to cfg_layout_initialize().  */
 
@@ -2222,15 +2881,32 @@ reorder_basic_blocks (void)
   int n_traces;
   int i;
   struct trace *traces;
+  gcov_type taken_before = 0, score_before = 0;
 
   gcc_assert (current_ir_type () == IR_RTL_CFGLAYOUT);
 
   if (n_basic_blocks_for_fn (cfun) <= NUM_FIXED_BLOCKS + 1)
     return;
 
+  if (dump_file)
+    {
+      taken_before = taken_branch_frequency ();
+      score_before = ext_tsp_order_score ();
+    }
+
   set_edge_can_fallthru_flag ();
   mark_dfs_back_edges ();
 
+  if (flag_reorder_blocks_algorithm == REORDER_BLOCKS_ALGORITHM_EXT_TSP
+      && optimize_function_for_speed_p (cfun)
+      && (n_basic_blocks_for_fn (cfun)
+	  <= PARAM_VALUE (PARAM_MAX_EXT_TSP_BLOCKS)))
+    {
+      reorder_basic_blocks_ext_tsp ();
+      relink_block_chain (/*stay_in_cfglayout_mode=*/true);
+      goto done;
+    }
+
   /* We are estimating the length of uncond jump insn only once since the code
      for getting the insn length always returns the minimal length now.  */
   if (uncond_jump_length == 0)
@@ -2258,8 +2934,24 @@ reorder_basic_blocks (void)
 
   relink_block_chain (/*stay_in_cfglayout_mode=*/true);
 
+ done:
   if (dump_file)
     {
+      gcov_type taken_after = taken_branch_frequency ();
+      gcov_type score_after = ext_tsp_order_score ();
+
+      /* The differences are printed so that tests can check for an
+	 improvement with a regular expression.  */
+      fprintf (dump_file, "Taken branch frequency " HOST_WIDEST_INT_PRINT_DEC
+	       " before reordering, " HOST_WIDEST_INT_PRINT_DEC " after ("
+	       HOST_WIDEST_INT_PRINT_DEC " fewer)\n",
+	       (HOST_WIDEST_INT) taken_before, (HOST_WIDEST_INT) taken_after,
+	       (HOST_WIDEST_INT) (taken_before - taken_after));
+      fprintf (dump_file, "Ext-TSP score " HOST_WIDEST_INT_PRINT_DEC
+	       " before reordering, " HOST_WIDEST_INT_PRINT_DEC " after ("
+	       HOST_WIDEST_INT_PRINT_DEC " higher)\n",
+	       (HOST_WIDEST_INT) score_before, (HOST_WIDEST_INT) score_after,
+	       (HOST_WIDEST_INT) (score_after - score_before));
       if (dump_flags & TDF_DETAILS)
 	dump_reg_info (dump_file);
       dump_flow_info (dump_file, dump_flags);
@@ -232,6 +232,12 @@ struct GTY(()) cgraph_global_info {
 
 struct GTY(()) cgraph_rtl_info {
    unsigned int preferred_incoming_stack_boundary;
+
+   /* The call-used hard registers the function may change, including
+      those changed by the functions it calls.  */
+   HARD_REG_SET function_used_regs;
+   /* Set if FUNCTION_USED_REGS is valid.  */
+   unsigned function_used_regs_valid : 1;
 };
 
 /* Represent which DECL tree (or reference to such tree)
@@ -407,6 +413,10 @@ public:
   unsigned int profile_id;
   /* Time profiler: first run of function.  */
   int tp_first_run;
+  /* Position of the function in the text section chosen by call-chain
+     clustering at WPA time, counting from 1, or 0 if it was not
+     placed.  */
+  int text_order;
 
   /* Set when decl is an abstract function pointed to by the
      ABSTRACT_DECL_ORIGIN of a reachable function.  */
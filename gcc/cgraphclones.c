@@ -446,6 +446,7 @@ cgraph_clone_node (struct cgraph_node *n, tree decl, gcov_type count, int freq,
   new_node->count = count;
   new_node->frequency = n->frequency;
   new_node->tp_first_run = n->tp_first_run;
+  new_node->text_order = n->text_order;
 
   new_node->clone.tree_map = NULL;
   new_node->clone.args_to_skip = args_to_skip;
@@ -1851,6 +1851,12 @@ node_cmp (const void *pa, const void *pb)
   const struct cgraph_node *a = *(const struct cgraph_node * const *) pa;
   const struct cgraph_node *b = *(const struct cgraph_node * const *) pb;
 
+  /* The order chosen by call-chain clustering takes precedence.  */
+  if (a->text_order || b->text_order)
+    return (!a->text_order || !b->text_order
+	    ? a->text_order - b->text_order
+	    : b->text_order - a->text_order);
+
   /* Functions with time profile must be before these without profile.  */
   if (!a->tp_first_run || !b->tp_first_run)
     return a->tp_first_run - b->tp_first_run;
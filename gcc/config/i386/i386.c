@@ -12108,6 +12108,29 @@ ix86_live_on_entry (bitmap regs)
       bitmap_set_bit (regs, split_stack_prologue_scratch_regno ());
     }
 }
+
+/* Implement TARGET_FN_OTHER_HARD_REG_USAGE.  Direct calls do not go
+   through stubs that change registers, but vzeroupper changes the upper
+   halves of all SSE registers without its pattern saying so.  */
+
+static void
+ix86_fn_other_hard_reg_usage (struct hard_reg_set_container *regs)
+{
+  rtx insn;
+  int i;
+
+  for (insn = get_insns (); insn; insn = NEXT_INSN (insn))
+    if (NONJUMP_INSN_P (insn)
+	&& recog_memoized (insn) == CODE_FOR_avx_vzeroupper)
+      {
+	for (i = FIRST_SSE_REG; i <= LAST_SSE_REG; i++)
+	  SET_HARD_REG_BIT (regs->set, i);
+	if (TARGET_64BIT)
+	  for (i = FIRST_REX_SSE_REG; i <= LAST_REX_SSE_REG; i++)
+	    SET_HARD_REG_BIT (regs->set, i);
+	return;
+      }
+}
 
 /* Extract the parts of an RTL expression that is a valid memory address
    for an instruction.  Return 0 if the structure of the address is
@@ -47116,6 +47139,9 @@ ix86_atomic_assign_expand_fenv (tree *hold, tree *clear, tree *update)
 #undef TARGET_EXTRA_LIVE_ON_ENTRY
 #define TARGET_EXTRA_LIVE_ON_ENTRY ix86_live_on_entry
 
+#undef TARGET_FN_OTHER_HARD_REG_USAGE
+#define TARGET_FN_OTHER_HARD_REG_USAGE ix86_fn_other_hard_reg_usage
+
 #undef TARGET_ASM_CODE_END
 #define TARGET_ASM_CODE_END ix86_code_end
 
@@ -49,6 +49,7 @@ along with GCC; see the file COPYING3.  If not see
 
 #include "tree.h"
 #include "varasm.h"
+#include "hard-reg-set.h"
 #include "rtl.h"
 #include "tm_p.h"
 #include "regs.h"
@@ -57,7 +58,6 @@ along with GCC; see the file COPYING3.  If not see
 #include "recog.h"
 #include "conditions.h"
 #include "flags.h"
-#include "hard-reg-set.h"
 #include "output.h"
 #include "except.h"
 #include "function.h"
@@ -223,6 +223,7 @@ static int alter_cond (rtx);
 static int final_addr_vec_align (rtx);
 #endif
 static int align_fuzz (rtx, rtx, int, unsigned);
+static void collect_fn_hard_reg_usage (void);
 
 /* Initialize data in final at the beginning of a compilation.  */
 
@@ -4425,6 +4426,8 @@ rest_of_handle_final (void)
   assemble_start_function (current_function_decl, fnname);
   final_start_function (get_insns (), asm_out_file, optimize);
   final (get_insns (), asm_out_file, optimize);
+  if (flag_ipa_ra)
+    collect_fn_hard_reg_usage ();
   final_end_function ();
 
   /* The IA-64 ".handlerdata" directive must be issued before the ".endp"
@@ -4720,3 +4723,132 @@ make_pass_clean_state (gcc::context *ctxt)
 {
   return new pass_clean_state (ctxt);
 }
+
+/* Return the FUNCTION_DECL called directly by call insn INSN, or
+   NULL_TREE if the callee is not known.  */
+
+static tree
+get_call_fndecl (rtx insn)
+{
+  rtx call = get_call_rtx_from (insn);
+  rtx addr;
+
+  if (call == NULL_RTX)
+    return NULL_TREE;
+  addr = XEXP (XEXP (call, 0), 0);
+  if (GET_CODE (addr) != SYMBOL_REF
+      || SYMBOL_REF_DECL (addr) == NULL_TREE
+      || TREE_CODE (SYMBOL_REF_DECL (addr)) != FUNCTION_DECL)
+    return NULL_TREE;
+  return SYMBOL_REF_DECL (addr);
+}
+
+/* Store in *REG_SET the hard registers that call insn INSN may change:
+   those of DEFAULT_SET that the callee was found to use if it has
+   already been compiled and -fipa-ra is on, otherwise DEFAULT_SET.
+   Return true if the registers used by the callee were known.  */
+
+bool
+get_call_reg_set_usage (rtx insn, HARD_REG_SET *reg_set,
+			HARD_REG_SET default_set)
+{
+  if (flag_ipa_ra)
+    {
+      tree fndecl = get_call_fndecl (insn);
+      struct cgraph_rtl_info *info
+	= fndecl ? cgraph_rtl_info (fndecl) : NULL;
+
+      if (info != NULL && info->function_used_regs_valid)
+	{
+	  COPY_HARD_REG_SET (*reg_set, info->function_used_regs);
+	  AND_HARD_REG_SET (*reg_set, default_set);
+	  return true;
+	}
+    }
+
+  COPY_HARD_REG_SET (*reg_set, default_set);
+  return false;
+}
+
+/* Add to *USED the hard registers that INSN may change.  Return false
+   if INSN is a call to a function whose register usage is not known.  */
+
+static bool
+collect_insn_hard_reg_usage (rtx insn, HARD_REG_SET *used)
+{
+  HARD_REG_SET insn_used_regs;
+
+  find_all_hard_reg_sets (insn, &insn_used_regs, false);
+  IOR_HARD_REG_SET (*used, insn_used_regs);
+
+  /* A recursive call changes nothing the rest of the function does
+     not.  */
+  if (CALL_P (insn) && get_call_fndecl (insn) != current_function_decl)
+    {
+      if (!get_call_reg_set_usage (insn, &insn_used_regs,
+				   call_used_reg_set))
+	return false;
+      IOR_HARD_REG_SET (*used, insn_used_regs);
+    }
+
+  return true;
+}
+
+/* Record in the cgraph the call-used hard registers that the current
+   function may change, so that callers compiled later need not assume
+   that calls to it change them all.  */
+
+static void
+collect_fn_hard_reg_usage (void)
+{
+  struct hard_reg_set_container other_usage;
+  HARD_REG_SET function_used_regs;
+  struct cgraph_rtl_info *info;
+  rtx insn;
+  int i;
+
+  /* The body seen here must be the one that callers end up calling,
+     and the profiling code emitted as text changes registers too.  */
+  if (!targetm.fn_other_hard_reg_usage
+      || crtl->profile
+      || !decl_binds_to_current_def_p (current_function_decl))
+    return;
+
+  CLEAR_HARD_REG_SET (function_used_regs);
+  for (insn = get_insns (); insn != NULL_RTX; insn = NEXT_INSN (insn))
+    {
+      if (!NONDEBUG_INSN_P (insn))
+	continue;
+      if (GET_CODE (PATTERN (insn)) == SEQUENCE)
+	{
+	  for (i = 0; i < XVECLEN (PATTERN (insn), 0); i++)
+	    if (!collect_insn_hard_reg_usage (XVECEXP (PATTERN (insn), 0, i),
+					      &function_used_regs))
+	      return;
+	}
+      else if (!collect_insn_hard_reg_usage (insn, &function_used_regs))
+	return;
+    }
+
+  /* Be conservative about fixed registers and about the registers the
+     target says change behind the insns' back.  */
+  IOR_HARD_REG_SET (function_used_regs, fixed_reg_set);
+  CLEAR_HARD_REG_SET (other_usage.set);
+  targetm.fn_other_hard_reg_usage (&other_usage);
+  IOR_HARD_REG_SET (function_used_regs, other_usage.set);
+
+#ifdef STACK_REGS
+  /* Dataflow does not track the stack registers precisely.  */
+  for (i = FIRST_STACK_REG; i <= LAST_STACK_REG; i++)
+    SET_HARD_REG_BIT (function_used_regs, i);
+#endif
+
+  /* Nothing is gained unless some call-used register is left alone.  */
+  if (hard_reg_set_subset_p (call_used_reg_set, function_used_regs))
+    return;
+
+  info = cgraph_rtl_info (current_function_decl);
+  gcc_assert (info != NULL);
+  COPY_HARD_REG_SET (info->function_used_regs, function_used_regs);
+  info->function_used_regs_valid = 1;
+}
@@ -199,6 +199,30 @@ enum vect_cost_model {
   VECT_COST_MODEL_DEFAULT = 3
 };
 
+/* How instrumented code updates profile counters.  */
+enum profile_update {
+  PROFILE_UPDATE_SINGLE = 0,
+  PROFILE_UPDATE_ATOMIC = 1
+};
+
+/* Codec used to compress LTO IL sections.  */
+enum lto_compression_algorithm {
+  LTO_COMPRESSION_ZLIB = 0,
+  LTO_COMPRESSION_LZ = 1
+};
+
+/* How -fprofile-reorder-functions orders functions.  */
+enum reorder_functions_algorithm {
+  REORDER_FUNCTIONS_FIRST_RUN = 0,
+  REORDER_FUNCTIONS_CALL_CHAIN_CLUSTERING = 1
+};
+
+/* How -freorder-blocks lays out the blocks of a function.  */
+enum reorder_blocks_algorithm {
+  REORDER_BLOCKS_ALGORITHM_STC = 0,
+  REORDER_BLOCKS_ALGORITHM_EXT_TSP = 1
+};
+
 
 /* Different instrumentation modes.  */
 enum sanitize_code {
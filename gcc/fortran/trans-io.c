@@ -1645,6 +1645,42 @@ transfer_namelist_element (stmtblock_t * block, const char * var_name,
 
 #undef IARG
 
+/* Return true if every item of the data transfer list C is a variable
+   without vector subscripts, so that the library can transfer directly
+   from and to the items after the statement has returned, as it does
+   for ASYNCHRONOUS='yes' data transfers.  */
+
+static bool
+transfer_items_are_variables (gfc_code *c)
+{
+  gfc_ref *ref;
+  int i;
+
+  for (; c; c = c->next)
+    switch (c->op)
+      {
+      case EXEC_TRANSFER:
+	if (c->expr1->expr_type != EXPR_VARIABLE)
+	  return false;
+	for (ref = c->expr1->ref; ref; ref = ref->next)
+	  if (ref->type == REF_ARRAY)
+	    for (i = 0; i < ref->u.ar.dimen; i++)
+	      if (ref->u.ar.dimen_type[i] == DIMEN_VECTOR)
+		return false;
+	break;
+
+      case EXEC_DO:
+	if (!transfer_items_are_variables (c->block->next))
+	  return false;
+	break;
+
+      default:
+	return false;
+      }
+
+  return true;
+}
+
 /* Create a data transfer statement.  Not all of the fields are valid
    for both reading and writing, but improper use has been filtered
    out by now.  */
@@ -1730,8 +1766,16 @@ build_dt (tree function, gfc_code * code)
 				     dt->pos);
 
       if (dt->asynchronous)
-	mask |= set_string (&block, &post_block, var, IOPARM_dt_asynchronous,
-			    dt->asynchronous);
+	{
+	  mask |= set_string (&block, &post_block, var,
+			      IOPARM_dt_asynchronous, dt->asynchronous);
+	  if (dt->asynchronous->expr_type == EXPR_CONSTANT
+	      && gfc_wide_strlen (dt->asynchronous->value.character.string) == 3
+	      && gfc_wide_strncasecmp (dt->asynchronous->value.character.string,
+				       "yes", 3) == 0
+	      && transfer_items_are_variables (code->block->next))
+	    mask |= IOPARM_dt_async_vars;
+	}
 
       if (dt->blank)
 	mask |= set_string (&block, &post_block, var, IOPARM_dt_blank,
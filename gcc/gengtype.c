@@ -2917,12 +2917,15 @@ walk_type (type_p t, struct walk_type_data *d)
 
 		if (d->fn_wants_lvalue)
 		  {
-		    oprintf (d->of, "%*s%s = ", d->indent, "",
-			     d->prev_val[2]);
+		    const char *slot = d->prev_val[2];
+
+		    oprintf (d->of, "%*s%s = ", d->indent, "", slot);
 		    d->prev_val[2] = d->val;
 		    output_escaped_param (d, nested_ptr_d->convert_to,
 					  "nested_ptr");
 		    oprintf (d->of, ";\n");
+		    oprintf (d->of, "%*sgt_pch_note_nested_ptr (&(%s), &(%s), "
+			     "op, cookie);\n", d->indent, "", slot, d->val);
 		  }
 
 		d->indent -= 2;
@@ -27,6 +27,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "ggc.h"
 #include "ggc-internal.h"
 #include "diagnostic-core.h"
+#include "flags.h"
 #include "params.h"
 #include "hosthooks.h"
 #include "hosthooks-def.h"
@@ -379,6 +380,14 @@ struct traversal_state
   size_t count;
   struct ptr_data **ptrs;
   size_t ptrs_i;
+  /* The address the image is laid out for.  */
+  char *base;
+  /* Offsets into the image of every pointer in it, so that the image
+     can be loaded at a different address.  */
+  vec<size_t> relocs;
+  /* The nested_ptr temporary relocate_ptrs was last applied to, whose
+     value gt_pch_note_nested_ptr is about to see stored back.  */
+  void *nested_tmp;
 };
 
 /* Callbacks for htab_traverse.  */
@@ -416,16 +425,32 @@ compare_ptr_data (const void *p1_p, const void *p2_p)
 	  - ((size_t)p1->new_addr < (size_t)p2->new_addr));
 }
 
+/* Record where the pointer at PTR ends up in the image, and return
+   true, if PTR lies in the object being written,
+   STATE->ptrs[STATE->ptrs_i].  */
+
+static bool
+record_reloc (struct traversal_state *state, void *ptr)
+{
+  struct ptr_data *obj = state->ptrs[state->ptrs_i];
+  size_t off = (char *) ptr - (char *) obj->obj;
+
+  if (off >= obj->size)
+    return false;
+  state->relocs.safe_push ((char *) obj->new_addr + off - state->base);
+  return true;
+}
+
 /* Callbacks for note_ptr_fn.  */
 
 static void
 relocate_ptrs (void *ptr_p, void *state_p)
 {
   void **ptr = (void **)ptr_p;
-  struct traversal_state *state ATTRIBUTE_UNUSED
-    = (struct traversal_state *)state_p;
+  struct traversal_state *state = (struct traversal_state *)state_p;
   struct ptr_data *result;
 
+  state->nested_tmp = NULL;
   if (*ptr == NULL || *ptr == (void *)1)
     return;
 
@@ -433,6 +458,139 @@ relocate_ptrs (void *ptr_p, void *state_p)
     saving_htab.find_with_hash (*ptr, POINTER_HASH (*ptr));
   gcc_assert (result);
   *ptr = result->new_addr;
+
+  /* A pointer outside the object is either not part of what gets
+     written, or a nested_ptr temporary, whose slot in the object
+     gt_pch_note_nested_ptr records once the value is stored back.  */
+  if (!record_reloc (state, ptr))
+    state->nested_tmp = ptr;
+}
+
+/* Called by the gt_pch_p_* routines once SLOT has been set from the
+   nested_ptr temporary TMP that OP was applied to.  The conversions
+   only offset the pointer, so SLOT relocates like TMP would have.  */
+
+void
+gt_pch_note_nested_ptr (void *slot, void *tmp, gt_pointer_operator op,
+			void *cookie)
+{
+  struct traversal_state *state = (struct traversal_state *) cookie;
+
+  if (op != relocate_ptrs || state->nested_tmp != tmp)
+    return;
+  state->nested_tmp = NULL;
+  record_reloc (state, slot);
+}
+
+/* Callback for qsort.  */
+
+static int
+compare_size_t (const void *p1_p, const void *p2_p)
+{
+  const size_t p1 = *(const size_t *) p1_p;
+  const size_t p2 = *(const size_t *) p2_p;
+  return (p1 > p2) - (p1 < p2);
+}
+
+/* Write the relocations recorded in STATE to its file, as the number of
+   bytes in the encoding followed by the ULEB128-encoded differences
+   between consecutive offsets.  Pointers are usually close together,
+   so this mostly takes one byte per pointer.  */
+
+static void
+write_pch_relocs (struct traversal_state *state)
+{
+  vec<unsigned char> buf = vNULL;
+  size_t prev = 0, len;
+  unsigned i;
+
+  state->relocs.qsort (compare_size_t);
+  for (i = 0; i < state->relocs.length (); i++)
+    {
+      size_t delta = state->relocs[i] - prev;
+      /* Each pointer is relocated only once, but be safe.  */
+      if (i > 0 && delta == 0)
+	continue;
+      prev = state->relocs[i];
+      do
+	{
+	  unsigned char byte = delta & 0x7f;
+	  delta >>= 7;
+	  if (delta)
+	    byte |= 0x80;
+	  buf.safe_push (byte);
+	}
+      while (delta);
+    }
+
+  len = buf.length ();
+  if (fwrite (&len, sizeof (len), 1, state->f) != 1
+      || (len && fwrite (buf.address (), len, 1, state->f) != 1))
+    fatal_error ("can%'t write PCH file: %m");
+  buf.release ();
+}
+
+/* Read the relocations written by write_pch_relocs from F, and add BIAS
+   to every pointer they describe in the image loaded at BASE.  */
+
+static void
+read_pch_relocs (FILE *f, char *base, ptrdiff_t bias)
+{
+  unsigned char *buf, *p, *end;
+  size_t len, off = 0;
+
+  if (fread (&len, sizeof (len), 1, f) != 1)
+    fatal_error ("can%'t read PCH file: %m");
+  if (bias == 0)
+    {
+      if (len && fseek (f, len, SEEK_CUR) != 0)
+	fatal_error ("can%'t read PCH file: %m");
+      return;
+    }
+
+  timevar_push (TV_PCH_RELOCATE);
+  buf = XNEWVEC (unsigned char, len);
+  if (len && fread (buf, len, 1, f) != 1)
+    fatal_error ("can%'t read PCH file: %m");
+  for (p = buf, end = buf + len; p < end; )
+    {
+      size_t delta = 0;
+      unsigned shift = 0;
+      unsigned char byte;
+      do
+	{
+	  byte = *p++;
+	  delta |= (size_t) (byte & 0x7f) << shift;
+	  shift += 7;
+	}
+      while (byte & 0x80);
+      off += delta;
+
+      char **ptr = (char **) (base + off);
+      *ptr += bias;
+    }
+  XDELETEVEC (buf);
+  timevar_pop (TV_PCH_RELOCATE);
+}
+
+/* Add BIAS to the global pointers in TAB, which were read from a PCH
+   image loaded BIAS bytes away from where it was written for.  */
+
+static void
+relocate_pch_globals (const struct ggc_root_tab * const *tab, ptrdiff_t bias)
+{
+  const struct ggc_root_tab *const *rt;
+  const struct ggc_root_tab *rti;
+  size_t i;
+
+  for (rt = tab; *rt; rt++)
+    for (rti = *rt; rti->base != NULL; rti++)
+      for (i = 0; i < rti->nelt; i++)
+	{
+	  char **ptr = (char **)((char *)rti->base + rti->stride * i);
+	  if (*ptr != NULL && *ptr != (char *)1)
+	    *ptr += bias;
+	}
 }
 
 /* Write out, after relocation, the pointers in TAB.  */
@@ -524,6 +682,9 @@ gt_pch_save (FILE *f)
 
   state.ptrs = XNEWVEC (struct ptr_data *, state.count);
   state.ptrs_i = 0;
+  state.base = (char *) mmi.preferred_base;
+  state.relocs = vNULL;
+  state.nested_tmp = NULL;
 
   saving_htab.traverse <traversal_state *, ggc_call_alloc> (&state);
   timevar_pop (TV_PCH_PTR_REALLOC);
@@ -619,6 +780,7 @@ gt_pch_save (FILE *f)
 	}
 #endif
       memcpy (this_object, state.ptrs[i]->obj, state.ptrs[i]->size);
+      state.ptrs_i = i;
       if (state.ptrs[i]->reorder_fn != NULL)
 	state.ptrs[i]->reorder_fn (state.ptrs[i]->obj,
 				   state.ptrs[i]->note_ptr_cookie,
@@ -650,13 +812,45 @@ gt_pch_save (FILE *f)
 #endif
 
   ggc_pch_finish (state.d, state.f);
+  write_pch_relocs (&state);
   gt_pch_fixup_stringpool ();
 
+  state.relocs.release ();
   XDELETE (state.ptrs);
   XDELETE (this_object);
   saving_htab.dispose ();
 }
 
+/* Find room for the SIZE bytes of PCH image at OFFSET in FD at any
+   suitably aligned address, for when the one it was laid out for is
+   not available.  Map the image there and set *RESULT to 1 if
+   possible, otherwise set *RESULT to 0 so that the caller reads it
+   in.  */
+
+static char *
+pch_alloc_anywhere (size_t size, int fd ATTRIBUTE_UNUSED,
+		    size_t offset ATTRIBUTE_UNUSED, int *result)
+{
+  size_t align = host_hooks.gt_pch_alloc_granularity ();
+  char *p;
+
+#if HAVE_MMAP_FILE
+  p = (char *) mmap (NULL, size, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+		     fd, offset);
+  if (p != (char *) MAP_FAILED)
+    {
+      *result = 1;
+      return p;
+    }
+#endif
+
+  /* The garbage collector needs the image to start on a page boundary.
+     Like the image itself, this memory is never freed.  */
+  p = XNEWVEC (char, size + align);
+  *result = 0;
+  return p + (align - (uintptr_t) p % align) % align;
+}
+
 /* Read the state of the compiler back in from F.  */
 
 void
@@ -666,6 +860,7 @@ gt_pch_restore (FILE *f)
   const struct ggc_root_tab *rti;
   size_t i;
   struct mmap_info mmi;
+  char *base;
   int result;
 
   /* Delete any deletable objects.  This makes ggc_pch_read much
@@ -699,20 +894,35 @@ gt_pch_restore (FILE *f)
   if (fread (&mmi, sizeof (mmi), 1, f) != 1)
     fatal_error ("can%'t read PCH file: %m");
 
-  result = host_hooks.gt_pch_use_address (mmi.preferred_base, mmi.size,
-					  fileno (f), mmi.offset);
+  base = (char *) mmi.preferred_base;
+  if (PARAM_VALUE (PARAM_PCH_FORCE_RELOCATION))
+    result = -1;
+  else
+    result = host_hooks.gt_pch_use_address (base, mmi.size,
+					    fileno (f), mmi.offset);
   if (result < 0)
-    fatal_error ("had to relocate PCH");
+    /* The address the image was laid out for is not available, or we
+       were asked to pretend so.  Load it wherever we can and relocate
+       the pointers in it below.  */
+    base = pch_alloc_anywhere (mmi.size, fileno (f), mmi.offset, &result);
   if (result == 0)
     {
       if (fseek (f, mmi.offset, SEEK_SET) != 0
-	  || fread (mmi.preferred_base, mmi.size, 1, f) != 1)
+	  || fread (base, mmi.size, 1, f) != 1)
 	fatal_error ("can%'t read PCH file: %m");
     }
   else if (fseek (f, mmi.offset + mmi.size, SEEK_SET) != 0)
     fatal_error ("can%'t read PCH file: %m");
 
-  ggc_pch_read (f, mmi.preferred_base);
+  ggc_pch_read (f, base);
+
+  ptrdiff_t bias = base - (char *) mmi.preferred_base;
+  read_pch_relocs (f, base, bias);
+  if (bias != 0)
+    {
+      relocate_pch_globals (gt_ggc_rtab, bias);
+      relocate_pch_globals (gt_pch_cache_rtab, bias);
+    }
 
   gt_pch_restore_stringpool ();
 }
@@ -2073,15 +2073,19 @@ ggc_collect (void)
 
   invoke_plugin_callbacks (PLUGIN_GGC_START, NULL);
 
+  timevar_start (TV_GC_MARK);
   clear_marks ();
   ggc_mark_roots ();
+  timevar_stop (TV_GC_MARK);
 
   if (GATHER_STATISTICS)
     ggc_prune_overhead_list ();
 
+  timevar_start (TV_GC_SWEEP);
   poison_pages ();
   validate_free_objects ();
   sweep_pages ();
+  timevar_stop (TV_GC_SWEEP);
 
   G.allocated_last_gc = G.allocated;
 
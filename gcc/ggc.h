@@ -54,6 +54,12 @@ extern int gt_pch_note_object (void *, void *, gt_note_pointers);
    function.  */
 extern void gt_pch_note_reorder (void *, void *, gt_handle_reorder);
 
+/* Used by the gt_pch_p_* routines.  Register that the pointer in the
+   first parameter was stored back from the nested_ptr temporary in the
+   second, which the third parameter was applied to.  */
+extern void gt_pch_note_nested_ptr (void *, void *, gt_pointer_operator,
+				    void *);
+
 /* Mark the object in the first parameter and anything it points to.  */
 typedef void (*gt_pointer_walker) (void *);
 
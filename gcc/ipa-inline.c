@@ -1666,7 +1666,8 @@ inline_small_functions (void)
 
   gcc_assert (in_lto_p
 	      || !max_count
-	      || (profile_info && flag_branch_probabilities));
+	      || (profile_info
+		  && (flag_branch_probabilities || flag_auto_profile)));
 
   while (!fibheap_empty (edge_heap))
     {
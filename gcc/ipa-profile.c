@@ -43,7 +43,10 @@ along with GCC; see the file COPYING3.  If not see
    - Finally we propagate the following flags: unlikely executed, executed
      once, executed at startup and executed at exit.  These flags are used to
      control code size/performance threshold and and code placement (by producing
-     .text.unlikely/.text.hot/.text.startup/.text.exit subsections).  */
+     .text.unlikely/.text.hot/.text.startup/.text.exit subsections).
+
+   At WPA time ipa_call_chain_clustering can in addition choose the order
+   of the executed functions within those subsections.  */
 #include "config.h"
 #include "system.h"
 #include "coretypes.h"
@@ -68,6 +71,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "lto-streamer.h"
 #include "data-streamer.h"
 #include "ipa-inline.h"
+#include "sreal.h"
 
 /* Entry in the histogram.  */
 
@@ -711,6 +715,291 @@ ipa_profile (void)
   return 0;
 }
 
+/* Call-chain clustering, after Ottoni and Maher, "Optimizing Function
+   Placement for Large-Scale Data-Center Applications" (CGO 2017).
+   Each executed function starts out in a cluster of its own.  Taking
+   the functions from the most to the least densely executed, the
+   cluster of each is appended to the cluster of its most frequent
+   caller, unless the result would not fit in a page or would be much
+   less densely executed than the caller's cluster.  The clusters are
+   then laid out from the most to the least densely executed, so that
+   hot callers and callees share pages.  */
+
+/* Merging a cluster must not make the caller's cluster more than this
+   many times less dense.  */
+#define C3_MAX_DENSITY_DEGRADATION 8
+
+struct c3_cluster
+{
+  /* The functions in the cluster, in the order they are placed.  */
+  vec<cgraph_node_ptr> nodes;
+  /* The sum of their counts and their estimated size in bytes.  */
+  gcov_type count;
+  HOST_WIDE_INT size;
+  /* COUNT divided by SIZE.  */
+  sreal density;
+};
+
+/* The calls to a function from one caller.  */
+
+struct c3_caller
+{
+  struct cgraph_node *caller;
+  gcov_type count;
+};
+
+/* Set the density of CLUSTER from its count and size.  */
+
+static void
+c3_update_density (struct c3_cluster *cluster)
+{
+  sreal size;
+
+  sreal_init (&cluster->density, cluster->count, 0);
+  sreal_init (&size, MAX (cluster->size, 1), 0);
+  sreal_div (&cluster->density, &cluster->density, &size);
+}
+
+/* Helper for qsort; sort clusters by decreasing density, then by the
+   order of their first function.  */
+
+static int
+c3_cluster_cmp (const void *pa, const void *pb)
+{
+  struct c3_cluster *a = *(struct c3_cluster * const *) pa;
+  struct c3_cluster *b = *(struct c3_cluster * const *) pb;
+  int cmp = sreal_compare (&b->density, &a->density);
+
+  if (cmp)
+    return cmp;
+  return a->nodes[0]->order - b->nodes[0]->order;
+}
+
+/* Helper for qsort; sort calls by caller.  */
+
+static int
+c3_caller_cmp (const void *pa, const void *pb)
+{
+  const struct c3_caller *a = (const struct c3_caller *) pa;
+  const struct c3_caller *b = (const struct c3_caller *) pb;
+
+  return a->caller->order - b->caller->order;
+}
+
+/* Return the function placed by call-chain clustering that calls NODE
+   most often, or NULL if there is none.  CALLERS is scratch space.  */
+
+static struct cgraph_node *
+c3_hottest_caller (struct cgraph_node *node, vec<c3_caller> *callers)
+{
+  struct cgraph_node *best = NULL;
+  gcov_type best_count = 0;
+  struct cgraph_edge *e;
+  unsigned int i, j;
+
+  callers->truncate (0);
+  for (e = node->callers; e; e = e->next_caller)
+    {
+      struct c3_caller call;
+
+      call.caller = (e->caller->global.inlined_to
+		     ? e->caller->global.inlined_to : e->caller);
+      call.count = e->count;
+      if (call.caller != node && call.caller->aux && call.count > 0)
+	callers->safe_push (call);
+    }
+
+  callers->qsort (c3_caller_cmp);
+  for (i = 0; i < callers->length (); i = j)
+    {
+      gcov_type count = 0;
+
+      for (j = i;
+	   j < callers->length () && (*callers)[j].caller == (*callers)[i].caller;
+	   j++)
+	count += (*callers)[j].count;
+      if (count > best_count)
+	{
+	  best = (*callers)[i].caller;
+	  best_count = count;
+	}
+    }
+
+  return best;
+}
+
+/* Helper for qsort; sort nodes by order.  */
+
+static int
+c3_node_order_cmp (const void *pa, const void *pb)
+{
+  const struct cgraph_node *a = *(const struct cgraph_node * const *) pa;
+  const struct cgraph_node *b = *(const struct cgraph_node * const *) pb;
+
+  return a->order - b->order;
+}
+
+/* Return the number of pages of PAGE_SIZE bytes that the functions
+   placed by call-chain clustering would span if all functions were
+   laid out in source order, assuming INSN_SIZE bytes per instruction.  */
+
+static HOST_WIDE_INT
+c3_source_order_pages (HOST_WIDE_INT page_size, HOST_WIDE_INT insn_size)
+{
+  vec<cgraph_node_ptr> nodes = vNULL;
+  struct cgraph_node *node;
+  HOST_WIDE_INT offset = 0, last_page = -1, pages = 0;
+  unsigned int i;
+
+  FOR_EACH_DEFINED_FUNCTION (node)
+    if (!node->global.inlined_to && !node->alias)
+      nodes.safe_push (node);
+  nodes.qsort (c3_node_order_cmp);
+
+  FOR_EACH_VEC_ELT (nodes, i, node)
+    {
+      HOST_WIDE_INT size = (node->thunk.thunk_p ? 1
+			    : inline_summary (node)->size) * insn_size;
+
+      if (node->text_order && size)
+	{
+	  HOST_WIDE_INT first = offset / page_size;
+	  HOST_WIDE_INT last = (offset + size - 1) / page_size;
+
+	  pages += last - MAX (first, last_page + 1) + 1;
+	  last_page = last;
+	}
+      offset += size;
+    }
+
+  nodes.release ();
+  return pages;
+}
+
+/* Order the executed functions by call-chain clustering, setting their
+   text_order, and report the expected page footprint of the hot code
+   in the dump file and, unless quiet, on stderr.  */
+
+void
+ipa_call_chain_clustering (void)
+{
+  HOST_WIDE_INT page_size = PARAM_VALUE (PARAM_REORDER_FUNCTIONS_PAGE_SIZE);
+  HOST_WIDE_INT insn_size = PARAM_VALUE (PARAM_REORDER_FUNCTIONS_INSN_SIZE);
+  vec<c3_cluster *> clusters = vNULL;
+  vec<cgraph_node_ptr> nodes = vNULL;
+  vec<c3_caller> callers = vNULL;
+  struct cgraph_node *node;
+  struct c3_cluster *cluster;
+  HOST_WIDE_INT hot_size = 0, pages;
+  int n_clusters = 0, text_order = 0;
+  unsigned int i, j;
+
+  FOR_EACH_DEFINED_FUNCTION (node)
+    {
+      node->text_order = 0;
+      if (node->global.inlined_to || node->alias || node->thunk.thunk_p
+	  || node->count <= 0)
+	continue;
+
+      cluster = XCNEW (struct c3_cluster);
+      cluster->nodes.safe_push (node);
+      cluster->count = node->count;
+      cluster->size = inline_summary (node)->size * insn_size;
+      c3_update_density (cluster);
+      node->aux = cluster;
+      clusters.safe_push (cluster);
+    }
+  if (clusters.is_empty ())
+    return;
+
+  /* Visit the functions from the most densely executed.  */
+  clusters.qsort (c3_cluster_cmp);
+  FOR_EACH_VEC_ELT (clusters, i, cluster)
+    nodes.safe_push (cluster->nodes[0]);
+
+  FOR_EACH_VEC_ELT (nodes, i, node)
+    {
+      struct cgraph_node *caller = c3_hottest_caller (node, &callers);
+      struct cgraph_node *member;
+      struct c3_cluster *pred;
+      sreal merged, threshold, degradation;
+
+      if (!caller)
+	continue;
+      cluster = (struct c3_cluster *) node->aux;
+      pred = (struct c3_cluster *) caller->aux;
+      if (pred == cluster || pred->size + cluster->size > page_size)
+	continue;
+
+      sreal_init (&merged, pred->count + cluster->count, 0);
+      sreal_init (&threshold, pred->size + cluster->size, 0);
+      sreal_div (&merged, &merged, &threshold);
+      sreal_init (&degradation, C3_MAX_DENSITY_DEGRADATION, 0);
+      sreal_div (&threshold, &pred->density, &degradation);
+      if (sreal_compare (&merged, &threshold) < 0)
+	continue;
+
+      FOR_EACH_VEC_ELT (cluster->nodes, j, member)
+	{
+	  pred->nodes.safe_push (member);
+	  member->aux = pred;
+	}
+      pred->count += cluster->count;
+      pred->size += cluster->size;
+      c3_update_density (pred);
+      cluster->nodes.release ();
+    }
+
+  /* Lay out the clusters that are left.  */
+  j = 0;
+  FOR_EACH_VEC_ELT (clusters, i, cluster)
+    if (cluster->nodes.is_empty ())
+      free (cluster);
+    else
+      clusters[j++] = cluster;
+  clusters.truncate (j);
+  clusters.qsort (c3_cluster_cmp);
+
+  FOR_EACH_VEC_ELT (clusters, i, cluster)
+    {
+      if (cgraph_dump_file)
+	fprintf (cgraph_dump_file, "Cluster %i, count " HOST_WIDEST_INT_PRINT_DEC
+		 ", " HOST_WIDE_INT_PRINT_DEC " bytes:", n_clusters,
+		 (HOST_WIDEST_INT) cluster->count, cluster->size);
+      FOR_EACH_VEC_ELT (cluster->nodes, j, node)
+	{
+	  node->text_order = ++text_order;
+	  node->aux = NULL;
+	  if (cgraph_dump_file)
+	    fprintf (cgraph_dump_file, " %s", node->asm_name ());
+	}
+      if (cgraph_dump_file)
+	fprintf (cgraph_dump_file, "\n");
+      hot_size += cluster->size;
+      n_clusters++;
+      cluster->nodes.release ();
+      free (cluster);
+    }
+
+  pages = c3_source_order_pages (page_size, insn_size);
+  if (cgraph_dump_file)
+    fprintf (cgraph_dump_file,
+	     "Call-chain clustering placed %i functions in %i clusters: "
+	     HOST_WIDE_INT_PRINT_DEC " bytes of hot code span "
+	     HOST_WIDE_INT_PRINT_DEC " pages, " HOST_WIDE_INT_PRINT_DEC
+	     " in source order\n",
+	     text_order, n_clusters, hot_size,
+	     (hot_size + page_size - 1) / page_size, pages);
+  if (!quiet_flag)
+    fprintf (stderr, " [hot text: %i functions, " HOST_WIDE_INT_PRINT_DEC
+	     " pages, " HOST_WIDE_INT_PRINT_DEC " in source order]",
+	     text_order, (hot_size + page_size - 1) / page_size, pages);
+
+  clusters.release ();
+  nodes.release ();
+  callers.release ();
+}
+
 static bool
 gate_ipa_profile (void)
 {
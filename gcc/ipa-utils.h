@@ -65,6 +65,7 @@ bool recursive_call_p (tree, tree);
 
 /* In ipa-profile.c  */
 bool ipa_propagate_frequency (struct cgraph_node *node);
+void ipa_call_chain_clustering (void);
 
 /* In ipa-devirt.c  */
 
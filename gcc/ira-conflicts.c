@@ -748,30 +748,40 @@ ira_build_conflicts (void)
 	  ira_object_t obj = ALLOCNO_OBJECT (a, i);
 	  rtx allocno_reg = regno_reg_rtx [ALLOCNO_REGNO (a)];
 
-	  if ((! flag_caller_saves && ALLOCNO_CALLS_CROSSED_NUM (a) != 0)
-	      /* For debugging purposes don't put user defined variables in
-		 callee-clobbered registers.  However, do allow parameters
-		 in callee-clobbered registers to improve debugging.  This
-		 is a bit of a fragile hack.  */
-	      || (optimize == 0
-		  && REG_USERVAR_P (allocno_reg)
-		  && ! reg_is_parm_p (allocno_reg)))
+	  /* For debugging purposes don't put user defined variables in
+	     callee-clobbered registers.  However, do allow parameters
+	     in callee-clobbered registers to improve debugging.  This
+	     is a bit of a fragile hack.  */
+	  if (optimize == 0
+	      && REG_USERVAR_P (allocno_reg)
+	      && ! reg_is_parm_p (allocno_reg))
 	    {
 	      IOR_HARD_REG_SET (OBJECT_TOTAL_CONFLICT_HARD_REGS (obj),
 				call_used_reg_set);
 	      IOR_HARD_REG_SET (OBJECT_CONFLICT_HARD_REGS (obj),
 				call_used_reg_set);
 	    }
-	  else if (ALLOCNO_CALLS_CROSSED_NUM (a) != 0)
+	  else if (! flag_caller_saves && ALLOCNO_CALLS_CROSSED_NUM (a) != 0)
 	    {
 	      IOR_HARD_REG_SET (OBJECT_TOTAL_CONFLICT_HARD_REGS (obj),
-				no_caller_save_reg_set);
-	      IOR_HARD_REG_SET (OBJECT_TOTAL_CONFLICT_HARD_REGS (obj),
-				temp_hard_reg_set);
+				ALLOCNO_CROSSED_CALLS_CLOBBERED_REGS (a));
 	      IOR_HARD_REG_SET (OBJECT_CONFLICT_HARD_REGS (obj),
-				no_caller_save_reg_set);
+				ALLOCNO_CROSSED_CALLS_CLOBBERED_REGS (a));
+	    }
+	  else if (ALLOCNO_CALLS_CROSSED_NUM (a) != 0)
+	    {
+	      HARD_REG_SET unsaved_regs;
+
+	      /* Only the registers the crossed calls clobber need
+		 saving.  */
+	      COPY_HARD_REG_SET (unsaved_regs, no_caller_save_reg_set);
+	      IOR_HARD_REG_SET (unsaved_regs, temp_hard_reg_set);
+	      AND_HARD_REG_SET (unsaved_regs,
+				ALLOCNO_CROSSED_CALLS_CLOBBERED_REGS (a));
+	      IOR_HARD_REG_SET (OBJECT_TOTAL_CONFLICT_HARD_REGS (obj),
+				unsaved_regs);
 	      IOR_HARD_REG_SET (OBJECT_CONFLICT_HARD_REGS (obj),
-				temp_hard_reg_set);
+				unsaved_regs);
 	    }
 
 	  if (ALLOCNO_CALLS_CROSSED_NUM (a) != 0)
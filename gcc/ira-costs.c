@@ -2272,7 +2272,8 @@ ira_tune_allocno_costs (void)
 		continue;
 	      rclass = REGNO_REG_CLASS (regno);
 	      cost = 0;
-	      if (ira_hard_reg_set_intersection_p (regno, mode, call_used_reg_set)
+	      if (ira_hard_reg_set_intersection_p
+		    (regno, mode, ALLOCNO_CROSSED_CALLS_CLOBBERED_REGS (a))
 		  || HARD_REGNO_CALL_PART_CLOBBERED (regno, mode))
 		cost += (ALLOCNO_CALL_FREQ (a)
 			 * (ira_memory_move_cost[mode][rclass][0]
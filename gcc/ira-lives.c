@@ -1262,9 +1262,14 @@ process_bb_node_lives (ira_loop_tree_node_t loop_tree_node)
 		 there, try to find a pseudo that is live across the call but
 		 can be cheaply reconstructed from the return value.  */
 	      rtx cheap_reg = find_call_crossed_cheap_reg (insn);
+	      HARD_REG_SET this_call_used_reg_set;
+
 	      if (cheap_reg != NULL_RTX)
 		add_reg_note (insn, REG_RETURNED, cheap_reg);
 
+	      get_call_reg_set_usage (insn, &this_call_used_reg_set,
+				      call_used_reg_set);
+
 	      last_call_num++;
 	      sparseset_clear (allocnos_processed);
 	      /* The current set of live allocnos are live across the call.  */
@@ -1295,6 +1300,8 @@ process_bb_node_lives (ira_loop_tree_node_t loop_tree_node)
 		  if (sparseset_bit_p (allocnos_processed, num))
 		    continue;
 		  sparseset_set_bit (allocnos_processed, num);
+		  IOR_HARD_REG_SET (ALLOCNO_CROSSED_CALLS_CLOBBERED_REGS (a),
+				    this_call_used_reg_set);
 
 		  if (allocno_saved_at_call[num] != last_call_num)
 		    /* Here we are mimicking caller-save.c behaviour
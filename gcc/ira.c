@@ -2520,8 +2520,9 @@ setup_reg_renumber (void)
 				      reg_class_contents[pclass]);
 	    }
 	  if (ALLOCNO_CALLS_CROSSED_NUM (a) != 0
-	      && ira_hard_reg_set_intersection_p (hard_regno, ALLOCNO_MODE (a),
-						  call_used_reg_set))
+	      && ira_hard_reg_set_intersection_p
+		   (hard_regno, ALLOCNO_MODE (a),
+		    ALLOCNO_CROSSED_CALLS_CLOBBERED_REGS (a)))
 	    {
 	      ira_assert (!optimize || flag_caller_saves
 			  || (ALLOCNO_CALLS_CROSSED_NUM (a)
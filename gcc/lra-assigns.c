@@ -1463,7 +1463,9 @@ lra_assign (void)
   for (i = FIRST_PSEUDO_REGISTER; i < max_regno; i++)
     if (lra_reg_info[i].nrefs != 0 && reg_renumber[i] >= 0
 	&& lra_reg_info[i].call_p
-	&& overlaps_hard_reg_set_p (call_used_reg_set,
+	&& overlaps_hard_reg_set_p (flag_ipa_ra
+				    ? lra_reg_info[i].actual_call_used_reg_set
+				    : call_used_reg_set,
 				    PSEUDO_REGNO_MODE (i), reg_renumber[i]))
       gcc_unreachable ();
 #endif
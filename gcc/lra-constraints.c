@@ -4313,6 +4313,10 @@ static int reloads_num;
 /* Number of calls passed so far in current EBB.  */
 static int calls_num;
 
+/* For each hard register, the value of CALLS_NUM after the last call
+   passed that clobbers it, or zero.  */
+static int last_call_clobber[FIRST_PSEUDO_REGISTER];
+
 /* Current reload pseudo check for validity of elements in
    USAGE_INSNS.	 */
 static int curr_usage_insns_check;
@@ -4647,13 +4651,20 @@ inherit_reload_reg (bool def_p, int original_regno,
 static inline bool
 need_for_call_save_p (int regno)
 {
+  int hard_regno, i;
+  enum machine_mode mode = PSEUDO_REGNO_MODE (regno);
+
   lra_assert (regno >= FIRST_PSEUDO_REGISTER && reg_renumber[regno] >= 0);
-  return (usage_insns[regno].calls_num < calls_num
-	  && (overlaps_hard_reg_set_p
-	      (call_used_reg_set,
-	       PSEUDO_REGNO_MODE (regno), reg_renumber[regno])
-	      || HARD_REGNO_CALL_PART_CLOBBERED (reg_renumber[regno],
-						 PSEUDO_REGNO_MODE (regno))));
+  if (usage_insns[regno].calls_num >= calls_num)
+    return false;
+  hard_regno = reg_renumber[regno];
+  if (HARD_REGNO_CALL_PART_CLOBBERED (hard_regno, mode))
+    return true;
+  /* Only the calls passed since the usage matter.  */
+  for (i = hard_regno_nregs[hard_regno][mode] - 1; i >= 0; i--)
+    if (last_call_clobber[hard_regno + i] > usage_insns[regno].calls_num)
+      return true;
+  return false;
 }
 
 /* Global registers occurring in the current EBB.  */
@@ -5173,6 +5184,7 @@ inherit_in_ebb (rtx head, rtx tail)
   change_p = false;
   curr_usage_insns_check++;
   reloads_num = calls_num = 0;
+  memset (last_call_clobber, 0, sizeof (last_call_clobber));
   bitmap_clear (&check_only_regs);
   last_processed_bb = NULL;
   CLEAR_HARD_REG_SET (potential_reload_hard_regs);
@@ -5362,8 +5374,15 @@ inherit_in_ebb (rtx head, rtx tail)
 	    {
 	      rtx cheap, pat, dest, restore;
 	      int regno, hard_regno;
+	      HARD_REG_SET clobbered;
 
 	      calls_num++;
+	      get_call_reg_set_usage (curr_insn, &clobbered,
+				      call_used_reg_set);
+	      for (hard_regno = 0; hard_regno < FIRST_PSEUDO_REGISTER;
+		   hard_regno++)
+		if (TEST_HARD_REG_BIT (clobbered, hard_regno))
+		  last_call_clobber[hard_regno] = calls_num;
 	      if ((cheap = find_reg_note (curr_insn,
 					  REG_RETURNED, NULL_RTX)) != NULL_RTX
 		  && ((cheap = XEXP (cheap, 0)), true)
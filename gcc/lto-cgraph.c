@@ -489,6 +489,7 @@ lto_output_node (struct lto_simple_output_block *ob, struct cgraph_node *node,
   streamer_write_hwi_stream (ob->main_stream, ref);
 
   streamer_write_hwi_stream (ob->main_stream, node->tp_first_run);
+  streamer_write_hwi_stream (ob->main_stream, node->text_order);
 
   bp = bitpack_create (ob->main_stream);
   bp_pack_value (&bp, node->local.local, 1);
@@ -1090,6 +1091,7 @@ input_node (struct lto_file_decl_data *file_data,
 		    "node with uid %d", node->uid);
 
   node->tp_first_run = streamer_read_uhwi (ib);
+  node->text_order = streamer_read_uhwi (ib);
 
   bp = streamer_read_bitpack (ib);
 
@@ -36,11 +36,13 @@ along with GCC; see the file COPYING3.  If not see
 #include "gimple.h"
 #include "diagnostic-core.h"
 #include "langhooks.h"
+#include "opts.h"
 #include "lto-streamer.h"
 #include "lto-compress.h"
 
 /* Compression stream structure, holds the flush callback and opaque token,
-   the buffered data, and a note of whether compressing or uncompressing.  */
+   the buffered data, the codec and level to compress it with, and a note
+   of whether compressing or uncompressing.  */
 
 struct lto_compression_stream
 {
@@ -49,6 +51,8 @@ struct lto_compression_stream
   char *buffer;
   size_t bytes;
   size_t allocation;
+  enum lto_compression_algorithm algorithm;
+  int level;
   bool is_compression;
 };
 
@@ -57,6 +61,49 @@ struct lto_compression_stream
 static const size_t Z_BUFFER_LENGTH = 4096;
 static const size_t MIN_STREAM_ALLOCATION = 1024;
 
+/* Compressed sections are framed.  A frame starts with a header of
+   LTO_FRAME_HEADER_SIZE bytes:
+
+     bytes 0-3	LTO_FRAME_MAGIC
+     byte 4	the codec, an enum lto_compression_algorithm
+     byte 5	log2 of the uncompressed block size
+     bytes 6-7	zero
+     bytes 8-15	the uncompressed size, little-endian
+
+   followed by a table holding the compressed size of each block as a
+   4-byte little-endian word, with LTO_FRAME_STORED set for blocks that
+   did not compress and are stored as is, followed by the blocks.  Every
+   block is compressed on its own, so any part of the section can be
+   recovered by decoding only the blocks that cover it.
+
+   No zlib stream starts with LTO_FRAME_MAGIC, so unframed zlib streams
+   written by earlier compilers are still read.  */
+
+static const unsigned char LTO_FRAME_MAGIC[4] = { 'L', 'T', 'O', 'F' };
+static const size_t LTO_FRAME_HEADER_SIZE = 16;
+static const unsigned int LTO_FRAME_STORED = 0x80000000;
+static const unsigned int LTO_FRAME_BLOCK_BITS = 16;
+
+/* The lz codec is a byte-oriented LZ77 that trades compression ratio for
+   speed.  A block is a sequence of tokens, each a run of literals followed
+   by a copy of earlier output.  The first byte of a token holds the
+   number of literals in its high nibble and the copy length less
+   LZ_MIN_MATCH in its low nibble; a nibble of 15 is extended by the
+   following bytes, which are added to it up to and including the first
+   byte below 255.  The literals come next, then the distance back to the
+   copied data as a 2-byte little-endian word, then the extension of the
+   copy length.  The last token of a block has no copy.  */
+
+#define LZ_MIN_MATCH 4
+#define LZ_HASH_BITS 14
+
+/* Per-section compression levels, indexed by enum lto_section_type and
+   filled in from -flto-compression-level= and
+   -flto-section-compression-level= on first use.  */
+
+static int lto_section_levels[LTO_N_SECTION_TYPES];
+static bool lto_section_levels_initialized;
+
 /* For zlib, allocate SIZE count of ITEMS and return the address, OPAQUE
    is unused.  */
 
@@ -77,14 +124,12 @@ lto_zfree (void *opaque, void *address)
 }
 
 /* Return a zlib compression level that zlib will not reject.  Normalizes
-   the compression level from the command line flag, clamping non-default
-   values to the appropriate end of their valid range.  */
+   LEVEL, clamping non-default values to the appropriate end of their
+   valid range.  */
 
 static int
-lto_normalized_zlib_level (void)
+lto_normalized_zlib_level (int level)
 {
-  int level = flag_lto_compression_level;
-
   if (level != Z_DEFAULT_COMPRESSION)
     {
       if (level < Z_NO_COMPRESSION)
@@ -96,6 +141,70 @@ lto_normalized_zlib_level (void)
   return level;
 }
 
+/* Return the number of candidate matches the lz codec examines at each
+   position for compression LEVEL.  The default level is the fastest.  */
+
+static int
+lto_lz_search_depth (int level)
+{
+  if (level < 1)
+    level = 1;
+  else if (level > 9)
+    level = 9;
+
+  return 1 << (level - 1);
+}
+
+/* Fill in lto_section_levels.  -flto-section-compression-level= takes a
+   comma-separated list of SECTION:LEVEL pairs, where SECTION is one of
+   the names in lto_section_name.  */
+
+static void
+lto_init_section_levels (void)
+{
+  char *spec, *p;
+  int i;
+
+  lto_section_levels_initialized = true;
+  for (i = 0; i < LTO_N_SECTION_TYPES; i++)
+    lto_section_levels[i] = flag_lto_compression_level;
+
+  if (!flag_lto_section_compression_level)
+    return;
+
+  spec = xstrdup (flag_lto_section_compression_level);
+  for (p = strtok (spec, ","); p; p = strtok (NULL, ","))
+    {
+      char *colon = strchr (p, ':');
+      int level;
+
+      if (!colon)
+	{
+	  error ("missing level for LTO section %qs in "
+		 "%<-flto-section-compression-level=%>", p);
+	  continue;
+	}
+      *colon = '\0';
+      level = integral_argument (colon + 1);
+      if (level < 0)
+	{
+	  error ("invalid compression level %qs for LTO section %qs",
+		 colon + 1, p);
+	  continue;
+	}
+
+      for (i = 0; i < LTO_N_SECTION_TYPES; i++)
+	if (strcmp (p, lto_section_name[i]) == 0)
+	  break;
+      if (i == LTO_N_SECTION_TYPES)
+	error ("unknown LTO section %qs in "
+	       "%<-flto-section-compression-level=%>", p);
+      else
+	lto_section_levels[i] = level;
+    }
+  free (spec);
+}
+
 /* Create a new compression stream, with CALLBACK flush function passed
    OPAQUE token, IS_COMPRESSION indicates if compressing or uncompressing.  */
 
@@ -145,14 +254,317 @@ lto_destroy_compression_stream (struct lto_compression_stream *stream)
   free (stream);
 }
 
+/* Store VALUE as a little-endian word of SIZE bytes at P.  */
+
+static void
+lto_put_le (unsigned char *p, unsigned HOST_WIDE_INT value, size_t size)
+{
+  size_t i;
+
+  for (i = 0; i < size; i++, value >>= 8)
+    p[i] = value & 0xff;
+}
+
+/* Return the little-endian word of SIZE bytes at P.  */
+
+static unsigned HOST_WIDE_INT
+lto_get_le (const unsigned char *p, size_t size)
+{
+  unsigned HOST_WIDE_INT value = 0;
+
+  while (size-- > 0)
+    value = (value << 8) | p[size];
+
+  return value;
+}
+
+/* Return the lz hash of the LZ_MIN_MATCH bytes at P.  */
+
+static inline unsigned int
+lto_lz_hash (const unsigned char *p)
+{
+  unsigned int v = p[0] | (p[1] << 8) | (p[2] << 16) | ((unsigned) p[3] << 24);
+
+  return (v * 2654435761U) >> (32 - LZ_HASH_BITS);
+}
+
+/* Write the extension of a token length VALUE that did not fit in its
+   nibble at DST and return the address after it.  */
+
+static unsigned char *
+lto_lz_put_length (unsigned char *dst, size_t value)
+{
+  for (; value >= 255; value -= 255)
+    *dst++ = 255;
+  *dst++ = value;
+
+  return dst;
+}
+
+/* Append an lz token to the output at *DST, which ends at DST_END: the
+   NUM_LITERALS literals at LITERALS followed by a copy of MATCH_LENGTH
+   bytes from DISTANCE back, or no copy if MATCH_LENGTH is zero.  Return
+   false if the token does not fit.  */
+
+static bool
+lto_lz_put_token (unsigned char **dst, unsigned char *dst_end,
+		  const unsigned char *literals, size_t num_literals,
+		  size_t distance, size_t match_length)
+{
+  unsigned char *p = *dst;
+  size_t extra = match_length ? match_length - LZ_MIN_MATCH : 0;
+
+  if ((size_t) (dst_end - p)
+      < 1 + num_literals / 255 + 1 + num_literals + 2 + extra / 255 + 1)
+    return false;
+
+  *p++ = ((num_literals < 15 ? num_literals : 15) << 4
+	  | (extra < 15 ? extra : 15));
+  if (num_literals >= 15)
+    p = lto_lz_put_length (p, num_literals - 15);
+  memcpy (p, literals, num_literals);
+  p += num_literals;
+
+  if (match_length)
+    {
+      lto_put_le (p, distance, 2);
+      p += 2;
+      if (extra >= 15)
+	p = lto_lz_put_length (p, extra - 15);
+    }
+
+  *dst = p;
+  return true;
+}
+
+/* Compress the LEN bytes at SRC with the lz codec into DST, which has
+   room for DST_SIZE bytes, examining up to DEPTH earlier positions for
+   each match.  HEAD and PREV are the hash table and chains, of
+   1 << LZ_HASH_BITS and LEN entries.  Return the compressed size, or
+   zero if it would not fit.  */
+
+static size_t
+lto_lz_compress (const unsigned char *src, size_t len,
+		 unsigned char *dst, size_t dst_size, int depth,
+		 unsigned int *head, unsigned int *prev)
+{
+  unsigned char *out = dst, *out_end = dst + dst_size;
+  size_t pos = 0, anchor = 0;
+  unsigned int misses = 0;
+
+  memset (head, 0, sizeof (unsigned int) << LZ_HASH_BITS);
+
+  while (pos + LZ_MIN_MATCH <= len)
+    {
+      unsigned int hash = lto_lz_hash (src + pos);
+      unsigned int candidate = head[hash];
+      size_t best_length = 0, best_pos = 0, end;
+      int n;
+
+      /* HEAD and PREV hold positions plus one so that zero ends a
+	 chain.  */
+      for (n = depth; candidate && n > 0; n--)
+	{
+	  size_t cpos = candidate - 1, length = 0;
+
+	  while (pos + length < len && src[cpos + length] == src[pos + length])
+	    length++;
+	  if (length > best_length)
+	    {
+	      best_length = length;
+	      best_pos = cpos;
+	    }
+	  candidate = prev[cpos];
+	}
+      prev[pos] = head[hash];
+      head[hash] = pos + 1;
+
+      if (best_length < LZ_MIN_MATCH)
+	{
+	  /* Skip ahead faster through data that does not compress.  */
+	  pos += 1 + (misses++ >> 5);
+	  continue;
+	}
+
+      if (!lto_lz_put_token (&out, out_end, src + anchor, pos - anchor,
+			     pos - best_pos, best_length))
+	return 0;
+
+      /* Make the positions inside the copy available to later matches.  */
+      end = pos + best_length;
+      for (pos++; pos < end && pos + LZ_MIN_MATCH <= len; pos++)
+	{
+	  hash = lto_lz_hash (src + pos);
+	  prev[pos] = head[hash];
+	  head[hash] = pos + 1;
+	}
+      anchor = pos = end;
+      misses = 0;
+    }
+
+  if (!lto_lz_put_token (&out, out_end, src + anchor, len - anchor, 0, 0))
+    return 0;
+
+  return out - dst;
+}
+
+/* Read the extension of a token length at *SRC, which ends at SRC_END,
+   into *VALUE.  Return false if the input ends first.  */
+
+static bool
+lto_lz_get_length (const unsigned char **src, const unsigned char *src_end,
+		   size_t *value)
+{
+  const unsigned char *p = *src;
+  unsigned char byte;
+
+  do
+    {
+      if (p == src_end)
+	return false;
+      byte = *p++;
+      *value += byte;
+    }
+  while (byte == 255);
+
+  *src = p;
+  return true;
+}
+
+/* Uncompress the LEN bytes of lz data at SRC into the DST_SIZE bytes at
+   DST.  Return false unless the data is well formed and fills DST
+   exactly.  */
+
+static bool
+lto_lz_uncompress (const unsigned char *src, size_t len,
+		   unsigned char *dst, size_t dst_size)
+{
+  const unsigned char *src_end = src + len;
+  unsigned char *out = dst, *out_end = dst + dst_size;
+
+  while (src < src_end)
+    {
+      unsigned int token = *src++;
+      size_t num_literals = token >> 4, length = token & 15, distance;
+
+      if (num_literals == 15
+	  && !lto_lz_get_length (&src, src_end, &num_literals))
+	return false;
+      if (num_literals > (size_t) (src_end - src)
+	  || num_literals > (size_t) (out_end - out))
+	return false;
+      memcpy (out, src, num_literals);
+      src += num_literals;
+      out += num_literals;
+
+      /* The last token has no copy.  */
+      if (src == src_end)
+	break;
+
+      if (src_end - src < 2)
+	return false;
+      distance = lto_get_le (src, 2);
+      src += 2;
+      if (length == 15 && !lto_lz_get_length (&src, src_end, &length))
+	return false;
+      length += LZ_MIN_MATCH;
+      if (distance == 0
+	  || distance > (size_t) (out - dst)
+	  || length > (size_t) (out_end - out))
+	return false;
+
+      if (distance >= length)
+	memcpy (out, out - distance, length);
+      else
+	{
+	  /* The copy overlaps its own output, repeating the last DISTANCE
+	     bytes.  */
+	  const unsigned char *from = out - distance;
+	  size_t i;
+
+	  for (i = 0; i < length; i++)
+	    out[i] = from[i];
+	}
+      out += length;
+    }
+
+  return out == out_end;
+}
+
+/* Compress the LEN bytes at SRC with zlib stream ZS into DST, which has
+   room for DST_SIZE bytes.  Return the compressed size, or zero if it
+   would not fit.  */
+
+static size_t
+lto_zlib_compress (z_stream *zs, const unsigned char *src, size_t len,
+		   unsigned char *dst, size_t dst_size)
+{
+  int status;
+
+  status = deflateReset (zs);
+  if (status != Z_OK)
+    internal_error ("compressed stream: %s", zError (status));
+
+  zs->next_in = CONST_CAST (unsigned char *, src);
+  zs->avail_in = len;
+  zs->next_out = dst;
+  zs->avail_out = dst_size;
+
+  status = deflate (zs, Z_FINISH);
+  if (status == Z_STREAM_END)
+    return dst_size - zs->avail_out;
+  if (status != Z_OK && status != Z_BUF_ERROR)
+    internal_error ("compressed stream: %s", zError (status));
+
+  /* The block did not fit.  Reset ZS, as deflateEnd objects to a stream
+     left unfinished.  */
+  status = deflateReset (zs);
+  if (status != Z_OK)
+    internal_error ("compressed stream: %s", zError (status));
+
+  return 0;
+}
+
+/* Uncompress the LEN bytes of zlib data at SRC with zlib stream ZS into
+   the DST_SIZE bytes at DST.  Return false unless the data is well formed
+   and fills DST exactly.  */
+
+static bool
+lto_zlib_uncompress (z_stream *zs, const unsigned char *src, size_t len,
+		     unsigned char *dst, size_t dst_size)
+{
+  int status;
+
+  status = inflateReset (zs);
+  if (status != Z_OK)
+    internal_error ("compressed stream: %s", zError (status));
+
+  zs->next_in = CONST_CAST (unsigned char *, src);
+  zs->avail_in = len;
+  zs->next_out = dst;
+  zs->avail_out = dst_size;
+
+  status = inflate (zs, Z_FINISH);
+  return status == Z_STREAM_END && zs->avail_in == 0 && zs->avail_out == 0;
+}
+
 /* Return a new compression stream, with CALLBACK flush function passed
-   OPAQUE token.  */
+   OPAQUE token, for a section of type SECTION_TYPE.  */
 
 struct lto_compression_stream *
 lto_start_compression (void (*callback) (const char *, unsigned, void *),
-		       void *opaque)
+		       void *opaque, enum lto_section_type section_type)
 {
-  return lto_new_compression_stream (callback, opaque, true);
+  struct lto_compression_stream *stream
+    = lto_new_compression_stream (callback, opaque, true);
+
+  if (!lto_section_levels_initialized)
+    lto_init_section_levels ();
+  stream->algorithm
+    = (enum lto_compression_algorithm) flag_lto_compression_algorithm;
+  stream->level = lto_section_levels[section_type];
+
+  return stream;
 }
 
 /* Append NUM_CHARS from address BASE to STREAM.  */
@@ -167,63 +579,103 @@ lto_compress_block (struct lto_compression_stream *stream,
   lto_stats.num_output_il_bytes += num_chars;
 }
 
-/* Finalize STREAM compression, and free stream allocations.  */
+/* Finalize STREAM compression, and free stream allocations.  The data is
+   split into blocks that are compressed one at a time into a single
+   frame, see LTO_FRAME_MAGIC.  */
 
 void
 lto_end_compression (struct lto_compression_stream *stream)
 {
-  unsigned char *cursor = (unsigned char *) stream->buffer;
-  size_t remaining = stream->bytes;
-  const size_t outbuf_length = Z_BUFFER_LENGTH;
-  unsigned char *outbuf = (unsigned char *) xmalloc (outbuf_length);
-  z_stream out_stream;
-  size_t compressed_bytes = 0;
-  int status;
+  const unsigned char *data = (const unsigned char *) stream->buffer;
+  const size_t block_size = (size_t) 1 << LTO_FRAME_BLOCK_BITS;
+  size_t num_blocks = (stream->bytes + block_size - 1) / block_size;
+  size_t table_size = 4 * num_blocks;
+  unsigned char *header = XNEWVEC (unsigned char,
+				   LTO_FRAME_HEADER_SIZE + table_size);
+  unsigned char *table = header + LTO_FRAME_HEADER_SIZE;
+  unsigned char *outbuf = XNEWVEC (unsigned char, stream->bytes);
+  unsigned int *head = NULL, *prev = NULL;
+  size_t out_bytes = 0, i;
+  z_stream zs;
+  int status, depth = 0;
 
   gcc_assert (stream->is_compression);
 
-  out_stream.next_out = outbuf;
-  out_stream.avail_out = outbuf_length;
-  out_stream.next_in = cursor;
-  out_stream.avail_in = remaining;
-  out_stream.zalloc = lto_zalloc;
-  out_stream.zfree = lto_zfree;
-  out_stream.opaque = Z_NULL;
-
-  status = deflateInit (&out_stream, lto_normalized_zlib_level ());
-  if (status != Z_OK)
-    internal_error ("compressed stream: %s", zError (status));
-
-  do
+  if (stream->algorithm == LTO_COMPRESSION_LZ)
     {
-      size_t in_bytes, out_bytes;
-
-      status = deflate (&out_stream, Z_FINISH);
-      if (status != Z_OK && status != Z_STREAM_END)
+      depth = lto_lz_search_depth (stream->level);
+      head = XNEWVEC (unsigned int, 1 << LZ_HASH_BITS);
+      prev = XNEWVEC (unsigned int, MIN (stream->bytes, block_size));
+    }
+  else
+    {
+      memset (&zs, 0, sizeof (zs));
+      zs.zalloc = lto_zalloc;
+      zs.zfree = lto_zfree;
+      zs.opaque = Z_NULL;
+      status = deflateInit (&zs, lto_normalized_zlib_level (stream->level));
+      if (status != Z_OK)
 	internal_error ("compressed stream: %s", zError (status));
+    }
 
-      in_bytes = remaining - out_stream.avail_in;
-      out_bytes = outbuf_length - out_stream.avail_out;
+  for (i = 0; i < num_blocks; i++)
+    {
+      const unsigned char *block = data + i * block_size;
+      size_t len = MIN (block_size, stream->bytes - i * block_size);
+      size_t compressed = 0;
 
-      stream->callback ((const char *) outbuf, out_bytes, stream->opaque);
-      lto_stats.num_compressed_il_bytes += out_bytes;
-      compressed_bytes += out_bytes;
+      /* Level zero stores every block.  Otherwise store the blocks whose
+	 compressed form would be no smaller.  */
+      if (stream->level != 0)
+	{
+	  if (stream->algorithm == LTO_COMPRESSION_LZ)
+	    compressed = lto_lz_compress (block, len, outbuf + out_bytes,
+					  len - 1, depth, head, prev);
+	  else
+	    compressed = lto_zlib_compress (&zs, block, len,
+					    outbuf + out_bytes, len - 1);
+	}
 
-      cursor += in_bytes;
-      remaining -= in_bytes;
+      if (compressed == 0)
+	{
+	  memcpy (outbuf + out_bytes, block, len);
+	  lto_put_le (table + 4 * i, len | LTO_FRAME_STORED, 4);
+	  out_bytes += len;
+	}
+      else
+	{
+	  lto_put_le (table + 4 * i, compressed, 4);
+	  out_bytes += compressed;
+	}
+    }
 
-      out_stream.next_out = outbuf;
-      out_stream.avail_out = outbuf_length;
-      out_stream.next_in = cursor;
-      out_stream.avail_in = remaining;
+  if (stream->algorithm == LTO_COMPRESSION_LZ)
+    {
+      free (head);
+      free (prev);
+    }
+  else
+    {
+      status = deflateEnd (&zs);
+      if (status != Z_OK)
+	internal_error ("compressed stream: %s", zError (status));
     }
-  while (status != Z_STREAM_END);
 
-  status = deflateEnd (&out_stream);
-  if (status != Z_OK)
-    internal_error ("compressed stream: %s", zError (status));
+  memcpy (header, LTO_FRAME_MAGIC, sizeof (LTO_FRAME_MAGIC));
+  header[4] = stream->algorithm;
+  header[5] = LTO_FRAME_BLOCK_BITS;
+  header[6] = header[7] = 0;
+  lto_put_le (header + 8, stream->bytes, 8);
+
+  stream->callback ((const char *) header, LTO_FRAME_HEADER_SIZE + table_size,
+		    stream->opaque);
+  if (out_bytes)
+    stream->callback ((const char *) outbuf, out_bytes, stream->opaque);
+  lto_stats.num_compressed_il_bytes
+    += LTO_FRAME_HEADER_SIZE + table_size + out_bytes;
 
   lto_destroy_compression_stream (stream);
+  free (header);
   free (outbuf);
 }
 
@@ -249,71 +701,178 @@ lto_uncompress_block (struct lto_compression_stream *stream,
   lto_stats.num_input_il_bytes += num_chars;
 }
 
-/* Finalize STREAM uncompression, and free stream allocations.
+/* Uncompress the frame at the start of the REMAINING bytes at CURSOR,
+   passing the data to the flush callback of STREAM.  Return the size of
+   the frame.  */
 
-   Because of the way LTO IL streams are compressed, there may be several
-   concatenated compressed segments in the accumulated data, so for this
-   function we iterate decompressions until no data remains.  */
+static size_t
+lto_uncompress_frame (struct lto_compression_stream *stream,
+		      const unsigned char *cursor, size_t remaining)
+{
+  unsigned HOST_WIDE_INT size;
+  size_t block_size, num_blocks, offset, i;
+  enum lto_compression_algorithm algorithm;
+  const unsigned char *table;
+  unsigned char *outbuf;
+  z_stream zs;
+  int status;
 
-void
-lto_end_uncompression (struct lto_compression_stream *stream)
+  if (remaining < LTO_FRAME_HEADER_SIZE
+      || cursor[4] > LTO_COMPRESSION_LZ
+      || cursor[5] == 0 || cursor[5] > 24
+      || cursor[6] != 0 || cursor[7] != 0)
+    internal_error ("compressed stream: invalid frame header");
+
+  algorithm = (enum lto_compression_algorithm) cursor[4];
+  block_size = (size_t) 1 << cursor[5];
+  size = lto_get_le (cursor + 8, 8);
+  num_blocks = size / block_size + (size % block_size != 0);
+  if (num_blocks > (remaining - LTO_FRAME_HEADER_SIZE) / 4)
+    internal_error ("compressed stream: truncated frame");
+
+  table = cursor + LTO_FRAME_HEADER_SIZE;
+  offset = LTO_FRAME_HEADER_SIZE + 4 * num_blocks;
+  outbuf = XNEWVEC (unsigned char, size);
+
+  if (algorithm == LTO_COMPRESSION_ZLIB)
+    {
+      memset (&zs, 0, sizeof (zs));
+      zs.zalloc = lto_zalloc;
+      zs.zfree = lto_zfree;
+      zs.opaque = Z_NULL;
+      status = inflateInit (&zs);
+      if (status != Z_OK)
+	internal_error ("compressed stream: %s", zError (status));
+    }
+
+  for (i = 0; i < num_blocks; i++)
+    {
+      unsigned int entry = lto_get_le (table + 4 * i, 4);
+      size_t len = entry & ~LTO_FRAME_STORED;
+      size_t out_len = MIN (block_size, size - i * block_size);
+      unsigned char *out = outbuf + i * block_size;
+      bool ok;
+
+      if (len > remaining - offset)
+	internal_error ("compressed stream: truncated frame");
+
+      if (entry & LTO_FRAME_STORED)
+	{
+	  ok = len == out_len;
+	  if (ok)
+	    memcpy (out, cursor + offset, len);
+	}
+      else if (algorithm == LTO_COMPRESSION_LZ)
+	ok = lto_lz_uncompress (cursor + offset, len, out, out_len);
+      else
+	ok = lto_zlib_uncompress (&zs, cursor + offset, len, out, out_len);
+      if (!ok)
+	internal_error ("compressed stream: corrupt block");
+
+      offset += len;
+    }
+
+  if (algorithm == LTO_COMPRESSION_ZLIB)
+    {
+      status = inflateEnd (&zs);
+      if (status != Z_OK)
+	internal_error ("compressed stream: %s", zError (status));
+    }
+
+  if (size)
+    stream->callback ((const char *) outbuf, size, stream->opaque);
+  lto_stats.num_uncompressed_il_bytes += size;
+  free (outbuf);
+
+  return offset;
+}
+
+/* Uncompress the unframed zlib stream at the start of the REMAINING bytes
+   at CURSOR, passing the data to the flush callback of STREAM.  Return the
+   size of the zlib stream.  */
+
+static size_t
+lto_uncompress_zlib_stream (struct lto_compression_stream *stream,
+			    const unsigned char *cursor, size_t remaining)
 {
-  unsigned char *cursor = (unsigned char *) stream->buffer;
-  size_t remaining = stream->bytes;
   const size_t outbuf_length = Z_BUFFER_LENGTH;
   unsigned char *outbuf = (unsigned char *) xmalloc (outbuf_length);
-  size_t uncompressed_bytes = 0;
+  const size_t length = remaining;
+  z_stream in_stream;
+  size_t out_bytes;
+  int status;
 
-  gcc_assert (!stream->is_compression);
+  in_stream.next_out = outbuf;
+  in_stream.avail_out = outbuf_length;
+  in_stream.next_in = CONST_CAST (unsigned char *, cursor);
+  in_stream.avail_in = remaining;
+  in_stream.zalloc = lto_zalloc;
+  in_stream.zfree = lto_zfree;
+  in_stream.opaque = Z_NULL;
 
-  while (remaining > 0)
+  status = inflateInit (&in_stream);
+  if (status != Z_OK)
+    internal_error ("compressed stream: %s", zError (status));
+
+  do
     {
-      z_stream in_stream;
-      size_t out_bytes;
-      int status;
+      size_t in_bytes;
+
+      status = inflate (&in_stream, Z_SYNC_FLUSH);
+      if (status != Z_OK && status != Z_STREAM_END)
+	internal_error ("compressed stream: %s", zError (status));
+
+      in_bytes = remaining - in_stream.avail_in;
+      out_bytes = outbuf_length - in_stream.avail_out;
+
+      stream->callback ((const char *) outbuf, out_bytes, stream->opaque);
+      lto_stats.num_uncompressed_il_bytes += out_bytes;
+
+      cursor += in_bytes;
+      remaining -= in_bytes;
 
       in_stream.next_out = outbuf;
       in_stream.avail_out = outbuf_length;
-      in_stream.next_in = cursor;
+      in_stream.next_in = CONST_CAST (unsigned char *, cursor);
       in_stream.avail_in = remaining;
-      in_stream.zalloc = lto_zalloc;
-      in_stream.zfree = lto_zfree;
-      in_stream.opaque = Z_NULL;
+    }
+  while (!(status == Z_STREAM_END && out_bytes == 0));
 
-      status = inflateInit (&in_stream);
-      if (status != Z_OK)
-	internal_error ("compressed stream: %s", zError (status));
+  status = inflateEnd (&in_stream);
+  if (status != Z_OK)
+    internal_error ("compressed stream: %s", zError (status));
 
-      do
-	{
-	  size_t in_bytes;
+  free (outbuf);
+  return length - remaining;
+}
 
-	  status = inflate (&in_stream, Z_SYNC_FLUSH);
-	  if (status != Z_OK && status != Z_STREAM_END)
-	    internal_error ("compressed stream: %s", zError (status));
+/* Finalize STREAM uncompression, and free stream allocations.
 
-	  in_bytes = remaining - in_stream.avail_in;
-	  out_bytes = outbuf_length - in_stream.avail_out;
+   Because of the way LTO IL streams are compressed, there may be several
+   concatenated compressed segments in the accumulated data, so for this
+   function we iterate decompressions until no data remains.  */
+
+void
+lto_end_uncompression (struct lto_compression_stream *stream)
+{
+  const unsigned char *cursor = (const unsigned char *) stream->buffer;
+  size_t remaining = stream->bytes;
 
-	  stream->callback ((const char *) outbuf, out_bytes, stream->opaque);
-	  lto_stats.num_uncompressed_il_bytes += out_bytes;
-	  uncompressed_bytes += out_bytes;
+  gcc_assert (!stream->is_compression);
 
-	  cursor += in_bytes;
-	  remaining -= in_bytes;
+  while (remaining > 0)
+    {
+      size_t consumed;
 
-	  in_stream.next_out = outbuf;
-	  in_stream.avail_out = outbuf_length;
-	  in_stream.next_in = cursor;
-	  in_stream.avail_in = remaining;
-	}
-      while (!(status == Z_STREAM_END && out_bytes == 0));
+      if (remaining >= sizeof (LTO_FRAME_MAGIC)
+	  && memcmp (cursor, LTO_FRAME_MAGIC, sizeof (LTO_FRAME_MAGIC)) == 0)
+	consumed = lto_uncompress_frame (stream, cursor, remaining);
+      else
+	consumed = lto_uncompress_zlib_stream (stream, cursor, remaining);
 
-      status = inflateEnd (&in_stream);
-      if (status != Z_OK)
-	internal_error ("compressed stream: %s", zError (status));
+      cursor += consumed;
+      remaining -= consumed;
     }
 
   lto_destroy_compression_stream (stream);
-  free (outbuf);
 }
@@ -27,7 +27,7 @@ struct lto_compression_stream;
 /* In lto-compress.c.  */
 extern struct lto_compression_stream
   *lto_start_compression (void (*callback) (const char *, unsigned, void *),
-			  void *opaque);
+			  void *opaque, enum lto_section_type section_type);
 extern void lto_compress_block (struct lto_compression_stream *stream,
 				const char *base, size_t num_chars);
 extern void lto_end_compression (struct lto_compression_stream *stream);
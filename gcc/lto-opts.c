@@ -75,7 +75,7 @@ lto_write_options (void)
   bool first_p = true;
 
   section_name = lto_get_section_name (LTO_section_opts, NULL, NULL);
-  lto_begin_section (section_name, false);
+  lto_begin_section (section_name, LTO_section_opts, false);
   memset (&stream, 0, sizeof (stream));
 
   obstack_init (&temporary_obstack);
@@ -145,6 +145,12 @@ lto_write_options (void)
 	case OPT_SPECIAL_input_file:
 	  continue;
 
+	/* The WPA output list is a temporary file whose name would
+	   otherwise make the LTRANS units of identical links differ,
+	   defeating -flto-incremental.  LTRANS does not use it.  */
+	case OPT_fltrans_output_list_:
+	  continue;
+
 	default:
 	  break;
       }
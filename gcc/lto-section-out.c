@@ -68,11 +68,12 @@ lto_append_data (const char *chars, unsigned int num_chars, void *opaque)
 
 static struct lto_compression_stream *compression_stream = NULL;
 
-/* Begin a new output section named NAME. If COMPRESS is true, zlib compress
-   the section. */
+/* Begin a new output section named NAME holding data of type SECTION_TYPE.
+   If COMPRESS is true, compress the section.  */
 
 void
-lto_begin_section (const char *name, bool compress)
+lto_begin_section (const char *name, enum lto_section_type section_type,
+		   bool compress)
 {
   lang_hooks.lto.begin_section (name);
 
@@ -81,7 +82,8 @@ lto_begin_section (const char *name, bool compress)
      we get compression of IL only in non-ltrans object files.  */
   gcc_assert (compression_stream == NULL);
   if (compress)
-    compression_stream = lto_start_compression (lto_append_data, NULL);
+    compression_stream = lto_start_compression (lto_append_data, NULL,
+						 section_type);
 }
 
 
@@ -342,7 +344,7 @@ lto_destroy_simple_output_block (struct lto_simple_output_block *ob)
   struct lto_output_stream *header_stream;
 
   section_name = lto_get_section_name (ob->section_type, NULL, NULL);
-  lto_begin_section (section_name, !flag_wpa);
+  lto_begin_section (section_name, ob->section_type, !flag_wpa);
   free (section_name);
 
   /* Write the header which says how to decode the pieces of the
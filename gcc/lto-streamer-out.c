@@ -1720,7 +1720,7 @@ produce_asm (struct output_block *ob, tree fn)
   else
     section_name = lto_get_section_name (section_type, NULL, NULL);
 
-  lto_begin_section (section_name, !flag_wpa);
+  lto_begin_section (section_name, section_type, !flag_wpa);
   free (section_name);
 
   /* The entire header is stream computed here.  */
@@ -1936,7 +1936,7 @@ lto_output_toplevel_asms (void)
   streamer_write_string_cst (ob, ob->main_stream, NULL_TREE);
 
   section_name = lto_get_section_name (LTO_section_asm, NULL, NULL);
-  lto_begin_section (section_name, !flag_wpa);
+  lto_begin_section (section_name, LTO_section_asm, !flag_wpa);
   free (section_name);
 
   /* The entire header stream is computed here.  */
@@ -1982,7 +1982,7 @@ copy_function (struct cgraph_node *node)
   struct lto_in_decl_state *in_state;
   struct lto_out_decl_state *out_state = lto_get_out_decl_state ();
 
-  lto_begin_section (section_name, !flag_wpa);
+  lto_begin_section (section_name, LTO_section_function_body, !flag_wpa);
   free (section_name);
 
   /* We may have renamed the declaration, e.g., a static function.  */
@@ -2385,7 +2385,7 @@ produce_symtab (struct output_block *ob)
   lto_symtab_encoder_t encoder = ob->decl_state->symtab_node_encoder;
   lto_symtab_encoder_iterator lsei;
 
-  lto_begin_section (section_name, false);
+  lto_begin_section (section_name, LTO_section_symtab, false);
   free (section_name);
 
   seen = pointer_set_create ();
@@ -2445,7 +2445,7 @@ produce_asm_for_decls (void)
   memset (&header, 0, sizeof (struct lto_decl_header));
 
   section_name = lto_get_section_name (LTO_section_decls, NULL, NULL);
-  lto_begin_section (section_name, !flag_wpa);
+  lto_begin_section (section_name, LTO_section_decls, !flag_wpa);
   free (section_name);
 
   /* Make string 0 be a NULL string.  */
@@ -46,6 +46,12 @@ along with GCC; see the file COPYING3.  If not see
 #include "opts.h"
 #include "options.h"
 #include "simple-object.h"
+#include "md5.h"
+#include "version.h"
+
+#ifndef HOST_EXECUTABLE_SUFFIX
+#define HOST_EXECUTABLE_SUFFIX ""
+#endif
 
 /* From lto-streamer.h which we cannot include with -fkeep-inline-functions.
    ???  Split out a lto-streamer-core.h.  */
@@ -73,6 +79,10 @@ static unsigned int nr;
 static char **input_names;
 static char **output_names;
 static char *makefile;
+static char **cache_names;
+
+/* Directory holding LTRANS results reused across links, if any.  */
+static const char *incremental_dir;
 
 static void maybe_unlink_file (const char *);
 
@@ -287,6 +297,144 @@ fork_execute (char **argv)
   free (at_args);
 }
 
+/* Copy the file SRC to DEST.  Return true on success.  */
+
+static bool
+copy_file (const char *src, const char *dest)
+{
+  char buf[65536];
+  size_t len;
+  bool ok = true;
+  FILE *in, *out;
+
+  in = fopen (src, "rb");
+  if (!in)
+    return false;
+  out = fopen (dest, "wb");
+  if (!out)
+    {
+      fclose (in);
+      return false;
+    }
+  while ((len = fread (buf, 1, sizeof (buf), in)) > 0)
+    if (fwrite (buf, 1, len, out) != len)
+      {
+	ok = false;
+	break;
+      }
+  if (ferror (in))
+    ok = false;
+  fclose (in);
+  if (fclose (out) != 0)
+    ok = false;
+  return ok;
+}
+
+/* Return a string identifying the compiler that compiles the LTRANS
+   units: its version, and the name and modification time of the lto1
+   the driver finds first in COMPILER_PATH.  Mixed into the cache keys,
+   it keeps a rebuilt or different compiler from reusing objects that
+   an older one produced.  */
+
+static const char *
+ltrans_cache_compiler_id (void)
+{
+  static char *id;
+  const char *path, *end;
+  struct stat st;
+  char mtime[32];
+
+  if (id)
+    return id;
+
+  id = xstrdup (version_string);
+  path = getenv ("COMPILER_PATH");
+  while (path && *path)
+    {
+      char *dir, *name;
+
+      end = strchr (path, PATH_SEPARATOR);
+      if (!end)
+	end = path + strlen (path);
+      dir = xstrndup (path, end - path);
+      name = concat (dir, "/lto1", HOST_EXECUTABLE_SUFFIX, NULL);
+      free (dir);
+      if (stat (name, &st) == 0)
+	{
+	  char *version = id;
+
+	  sprintf (mtime, "%ld", (long) st.st_mtime);
+	  id = concat (version, "\n", name, "\n", mtime, NULL);
+	  free (version);
+	  free (name);
+	  break;
+	}
+      free (name);
+      path = *end ? end + 1 : end;
+    }
+  return id;
+}
+
+/* Return the name of the file in INCREMENTAL_DIR that caches the result
+   of compiling the LTRANS unit INPUT_NAME with the ARGC leading options
+   of ARGV.  The name is derived from a checksum of both and of the
+   compiler identity, so it changes whenever the symbols, IPA decisions
+   or options of the unit, or the compiler itself, do.  */
+
+static char *
+ltrans_cache_name (const char *input_name, const char **argv, unsigned argc)
+{
+  struct md5_ctx ctx;
+  unsigned char digest[16];
+  char buf[65536], hex[2 * sizeof (digest) + 1];
+  const char *id;
+  size_t len;
+  unsigned i;
+  FILE *in;
+
+  md5_init_ctx (&ctx);
+  id = ltrans_cache_compiler_id ();
+  md5_process_bytes (id, strlen (id) + 1, &ctx);
+  for (i = 0; i < argc; ++i)
+    md5_process_bytes (argv[i], strlen (argv[i]) + 1, &ctx);
+
+  in = fopen (input_name, "rb");
+  if (!in)
+    fatal_perror ("fopen: %s", input_name);
+  while ((len = fread (buf, 1, sizeof (buf), in)) > 0)
+    md5_process_bytes (buf, len, &ctx);
+  if (ferror (in))
+    fatal_perror ("read: %s", input_name);
+  fclose (in);
+  md5_finish_ctx (&ctx, digest);
+
+  for (i = 0; i < sizeof (digest); ++i)
+    sprintf (&hex[2 * i], "%02x", digest[i]);
+  return concat (incremental_dir, "/", hex, ".ltrans.o", NULL);
+}
+
+/* Store OUTPUT_NAME as CACHE_NAME in the incremental LTO cache.  The
+   copy is made under a temporary name and renamed into place so that
+   concurrent links never see a partially written entry.  Failure is
+   not fatal; the entry is simply not reused.  */
+
+static void
+ltrans_cache_store (const char *output_name, const char *cache_name)
+{
+  char pid[32];
+  char *tmp;
+
+  sprintf (pid, ".%d", (int) getpid ());
+  tmp = concat (cache_name, pid, NULL);
+
+  if (!copy_file (output_name, tmp) || rename (tmp, cache_name) != 0)
+    unlink (tmp);
+  else if (verbose)
+    fprintf (stderr, "Caching LTRANS output %s as %s\n",
+	     output_name, cache_name);
+  free (tmp);
+}
+
 /* Template of LTRANS dumpbase suffix.  */
 #define DUMPBASE_SUFFIX ".ltrans18446744073709551615"
 
@@ -731,6 +879,11 @@ run_gcc (unsigned argc, char *argv[])
 	  no_partition = true;
 	  break;
 
+	case OPT_flto_incremental_:
+	  incremental_dir = option->arg;
+	  /* This is handled here, do not pass it on.  */
+	  continue;
+
 	case OPT_flto_:
 	  if (strcmp (option->arg, "jobserver") == 0)
 	    {
@@ -844,6 +997,12 @@ run_gcc (unsigned argc, char *argv[])
       tmp += list_option_len;
       strcpy (tmp, ltrans_output_file);
 
+      /* The names of the sections WPA writes include the random seed.
+	 Fix it so that unchanged partitions produce identical LTRANS
+	 units and hit in the cache.  */
+      if (incremental_dir)
+	obstack_ptr_grow (&argv_obstack, "-frandom-seed=0");
+
       if (jobserver)
 	obstack_ptr_grow (&argv_obstack, xstrdup ("-fwpa=jobserver"));
       else if (parallel > 1)
@@ -921,6 +1080,8 @@ cont:
 	  makefile = make_temp_file (".mk");
 	  mstream = fopen (makefile, "w");
 	}
+      if (incremental_dir)
+	cache_names = XCNEWVEC (char *, nr);
 
       /* Execute the LTRANS stage for each input file (or prepare a
 	 makefile to invoke this in parallel).  */
@@ -938,6 +1099,25 @@ cont:
 	  obstack_grow (&env_obstack, ".ltrans.o", sizeof (".ltrans.o"));
 	  output_name = XOBFINISH (&env_obstack, char *);
 
+	  /* Reuse the result of a previous link if the unit did not
+	     change.  */
+	  if (incremental_dir)
+	    {
+	      cache_names[i] = ltrans_cache_name (input_name, new_argv,
+						  new_head_argc);
+	      if (copy_file (cache_names[i], output_name))
+		{
+		  if (verbose)
+		    fprintf (stderr, "Reusing cached LTRANS output %s\n",
+			     cache_names[i]);
+		  maybe_unlink_file (input_name);
+		  free (cache_names[i]);
+		  cache_names[i] = NULL;
+		  output_names[i] = output_name;
+		  continue;
+		}
+	    }
+
 	  /* Adjust the dumpbase if the linker output file was seen.  */
 	  if (linker_output)
 	    {
@@ -973,6 +1153,8 @@ cont:
 	    {
 	      fork_execute (CONST_CAST (char **, new_argv));
 	      maybe_unlink_file (input_name);
+	      if (incremental_dir)
+		ltrans_cache_store (output_name, cache_names[i]);
 	    }
 
 	  output_names[i] = output_name;
@@ -1012,14 +1194,22 @@ cont:
 	  maybe_unlink_file (makefile);
 	  makefile = NULL;
 	  for (i = 0; i < nr; ++i)
-	    maybe_unlink_file (input_names[i]);
+	    {
+	      maybe_unlink_file (input_names[i]);
+	      if (incremental_dir && cache_names[i])
+		ltrans_cache_store (output_names[i], cache_names[i]);
+	    }
 	}
       for (i = 0; i < nr; ++i)
 	{
 	  fputs (output_names[i], stdout);
 	  putc ('\n', stdout);
 	  free (input_names[i]);
+	  if (cache_names)
+	    free (cache_names[i]);
 	}
+      free (cache_names);
+      cache_names = NULL;
       nr = 0;
       free (output_names);
       free (input_names);
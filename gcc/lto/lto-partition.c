@@ -339,6 +339,53 @@ lto_max_map (void)
     new_partition ("empty");
 }
 
+/* Group symbols into N_BUCKETS partitions chosen by a hash of the name
+   of the object file they originate from.  Unlike lto_balanced_map,
+   the partition a symbol lands in does not depend on the rest of the
+   program, so a change to one input file leaves the partitions not
+   containing its symbols unchanged.  This is what makes the LTRANS
+   cache of -flto-incremental effective.  */
+
+void
+lto_stable_map (int n_buckets)
+{
+  symtab_node *node;
+  ltrans_partition *buckets;
+  int i, npartitions = 0;
+
+  buckets = XCNEWVEC (ltrans_partition, n_buckets);
+
+  FOR_EACH_SYMBOL (node)
+    {
+      if (symtab_get_symbol_partitioning_class (node) != SYMBOL_PARTITION
+	  || symbol_partitioned_p (node))
+	continue;
+
+      struct lto_file_decl_data *file_data = node->lto_file_data;
+      hashval_t hash = file_data ? htab_hash_string (file_data->file_name) : 0;
+      int bucket = hash % n_buckets;
+
+      if (!buckets[bucket])
+	{
+	  buckets[bucket]
+	    = new_partition (file_data ? file_data->file_name : "");
+	  npartitions++;
+	}
+      add_symbol_to_partition (buckets[bucket], node);
+    }
+
+  /* Emit the partitions in bucket order rather than in the order their
+     first symbol was seen, which again depends on the whole program.  */
+  ltrans_partitions.truncate (0);
+  for (i = 0; i < n_buckets; i++)
+    if (buckets[i])
+      ltrans_partitions.safe_push (buckets[i]);
+  free (buckets);
+
+  if (!npartitions)
+    new_partition ("empty");
+}
+
 /* Helper function for qsort; sort nodes by order.  */
 static int
 node_cmp (const void *pa, const void *pb)
@@ -352,6 +399,13 @@ node_cmp (const void *pa, const void *pb)
 
   if (flag_profile_reorder_functions)
   {
+    /* Functions placed by call-chain clustering come first, in the order
+       it chose.  */
+    if (a->text_order && b->text_order)
+      return a->text_order - b->text_order;
+    if (a->text_order || b->text_order)
+      return b->text_order - a->text_order;
+
     /* Functions with time profile are sorted in ascending order.  */
     if (a->tp_first_run && b->tp_first_run)
       return a->tp_first_run != b->tp_first_run
@@ -33,6 +33,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "langhooks.h"
 #include "bitmap.h"
 #include "ipa-prop.h"
+#include "ipa-utils.h"
 #include "common.h"
 #include "debug.h"
 #include "tree-ssa-alias.h"
@@ -49,6 +50,7 @@ along with GCC; see the file COPYING3.  If not see
 #include "data-streamer.h"
 #include "context.h"
 #include "pass_manager.h"
+#include "params.h"
 
 
 /* Number of parallel tasks to run, -1 if we want to use GNU Make jobserver.  */
@@ -2588,7 +2590,10 @@ lto_wpa_write_files (void)
      FIXME: Even when not reordering we may want to output one list for parallel make
      and other for final link command.  */
 
-  if (!flag_profile_reorder_functions || !flag_profile_use)
+  if (!flag_profile_reorder_functions
+      || (!flag_profile_use
+	  && (flag_reorder_functions_algorithm
+	      != REORDER_FUNCTIONS_CALL_CHAIN_CLUSTERING)))
     ltrans_partitions.qsort (flag_toplevel_reorder
 			   ? cmp_partitions_size
 			   : cmp_partitions_order);
@@ -3266,10 +3271,16 @@ do_whole_program_analysis (void)
   timevar_pop (TV_WHOPR_WPA);
 
   timevar_push (TV_WHOPR_PARTITIONING);
+  if (flag_profile_reorder_functions
+      && (flag_reorder_functions_algorithm
+	  == REORDER_FUNCTIONS_CALL_CHAIN_CLUSTERING))
+    ipa_call_chain_clustering ();
   if (flag_lto_partition_1to1)
     lto_1_to_1_map ();
   else if (flag_lto_partition_max)
     lto_max_map ();
+  else if (flag_lto_partition_stable)
+    lto_stable_map (PARAM_VALUE (PARAM_LTO_PARTITIONS));
   else
     lto_balanced_map ();
 
@@ -421,4 +421,7 @@ range_in_hard_reg_set_p (const HARD_REG_SET set, unsigned regno, int nregs)
   return true;
 }
 
+/* In final.c.  */
+extern bool get_call_reg_set_usage (rtx, HARD_REG_SET *, HARD_REG_SET);
+
 #endif /* GCC_REGS_H */
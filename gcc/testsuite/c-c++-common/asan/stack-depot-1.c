@@ -0,0 +1,127 @@
+/* Threads allocate from many distinct call stacks at once, racing to
+   insert both the same stacks and stacks of their own into the stack
+   depot.  A use-after-free report then checks that the depot gives back
+   the right allocation stack for one of them.  */
+/* { dg-do run { target pthread } } */
+/* { dg-options "-pthread -fno-builtin-malloc -fno-builtin-free -fno-omit-frame-pointer" } */
+/* { dg-shouldfail "asan" } */
+
+#include <pthread.h>
+#include <stdlib.h>
+
+#define NTHREADS 8
+#define DEPTH 10
+#define NPATHS (1 << DEPTH)
+#define ROUNDS 4
+#define KEPT_PATH 0x2b5
+
+static volatile int sink;
+static char *kept;
+
+static char *walk_a (int, int);
+static char *walk_b (int, int);
+
+__attribute__((noinline, noclone)) static char *
+leaf (int path)
+{
+  char *p = (char *) malloc (16 + (path & 7));
+  sink++;
+  return p;
+}
+
+/* Bit DEPTH - 1 of PATH picks the next function, so each PATH is
+   its own call stack.  */
+
+__attribute__((noinline, noclone)) static char *
+walk_a (int path, int depth)
+{
+  char *p;
+  if (depth == 0)
+    p = leaf (path);
+  else if (path & (1 << (depth - 1)))
+    p = walk_b (path, depth - 1);
+  else
+    p = walk_a (path, depth - 1);
+  sink++;
+  return p;
+}
+
+__attribute__((noinline, noclone)) static char *
+walk_b (int path, int depth)
+{
+  char *p;
+  if (depth == 0)
+    p = leaf (path);
+  else if (path & (1 << (depth - 1)))
+    p = walk_b (path, depth - 1);
+  else
+    p = walk_a (path, depth - 1);
+  sink += 2;
+  return p;
+}
+
+/* Walk PATH below N more frames, which makes the stacks of each thread
+   different from those of the others.  */
+
+__attribute__((noinline, noclone)) static char *
+pad (int path, int n)
+{
+  char *p = n ? pad (path, n - 1) : walk_a (path, DEPTH);
+  sink++;
+  return p;
+}
+
+static void *
+worker (void *arg)
+{
+  int tid = (int) (long) arg;
+  int r, i;
+
+  for (r = 0; r < ROUNDS; r++)
+    for (i = 0; i < NPATHS; i++)
+      {
+	/* Start each thread at a different path, so that they insert the
+	   shared stacks in different orders.  */
+	int path = (i + tid * 97) % NPATHS;
+	free (walk_a (path, DEPTH));
+	free (pad (path, tid + 1));
+      }
+  if (tid == 0)
+    kept = walk_a (KEPT_PATH, DEPTH);
+  return NULL;
+}
+
+int
+main ()
+{
+  pthread_t threads[NTHREADS];
+  int i;
+
+  for (i = 0; i < NTHREADS; i++)
+    pthread_create (&threads[i], NULL, worker, (void *) (long) i);
+  for (i = 0; i < NTHREADS; i++)
+    pthread_join (threads[i], NULL);
+  free (kept);
+  return kept[0];
+}
+
+/* { dg-output "ERROR: AddressSanitizer:? heap-use-after-free on address\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "\[^\n\r]*READ of size 1 at 0x\[0-9a-f\]+ thread T0\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output ".*freed by thread T0 here:\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #0 0x\[0-9a-f\]+ (in _*(interceptor_|)free|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #1 0x\[0-9a-f\]+ (in _*main|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output ".*previously allocated by thread T1 here:\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #0 0x\[0-9a-f\]+ (in _*(interceptor_|)malloc|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #1 0x\[0-9a-f\]+ (in _*leaf|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #2 0x\[0-9a-f\]+ (in _*walk_b|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #3 0x\[0-9a-f\]+ (in _*walk_a|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #4 0x\[0-9a-f\]+ (in _*walk_b|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #5 0x\[0-9a-f\]+ (in _*walk_a|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #6 0x\[0-9a-f\]+ (in _*walk_b|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #7 0x\[0-9a-f\]+ (in _*walk_b|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #8 0x\[0-9a-f\]+ (in _*walk_a|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #9 0x\[0-9a-f\]+ (in _*walk_b|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #10 0x\[0-9a-f\]+ (in _*walk_a|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #11 0x\[0-9a-f\]+ (in _*walk_b|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #12 0x\[0-9a-f\]+ (in _*walk_a|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
+/* { dg-output "    #13 0x\[0-9a-f\]+ (in _*worker|\[(\])\[^\n\r]*(\n|\r\n|\r)" } */
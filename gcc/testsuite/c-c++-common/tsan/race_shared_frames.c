@@ -0,0 +1,43 @@
+/* Two races reported with the same frames must both be fully
+   symbolized, the second one from the symbolizer cache.  */
+/* { dg-shouldfail "tsan" } */
+/* { dg-additional-options "-fno-inline" } */
+
+#include <pthread.h>
+#include <unistd.h>
+
+int Global1, Global2;
+
+void __attribute__((noinline)) Store (int *p, int v) {
+  *p = v;
+}
+
+void *Thread1(void *x) {
+  usleep(100000);
+  Store(&Global1, 42);
+  usleep(100000);
+  Store(&Global2, 42);
+  return NULL;
+}
+
+void *Thread2(void *x) {
+  Store(&Global1, 43);
+  Store(&Global2, 43);
+  return NULL;
+}
+
+int main() {
+  pthread_t t[2];
+  pthread_create(&t[0], NULL, Thread1, NULL);
+  pthread_create(&t[1], NULL, Thread2, NULL);
+  pthread_join(t[0], NULL);
+  pthread_join(t[1], NULL);
+  return 0;
+}
+
+/* { dg-output "WARNING: ThreadSanitizer: data race.*(\n|\r\n|\r)" } */
+/* { dg-output "(.*(\n|\r\n|\r))*.*#0 Store .*race_shared_frames.c:12.*(\n|\r\n|\r)" } */
+/* { dg-output "(.*(\n|\r\n|\r))*.*Global1.*(\n|\r\n|\r)" } */
+/* { dg-output "(.*(\n|\r\n|\r))*WARNING: ThreadSanitizer: data race.*(\n|\r\n|\r)" } */
+/* { dg-output "(.*(\n|\r\n|\r))*.*#0 Store .*race_shared_frames.c:12.*(\n|\r\n|\r)" } */
+/* { dg-output "(.*(\n|\r\n|\r))*.*Global2.*" } */
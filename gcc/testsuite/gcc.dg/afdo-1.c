@@ -0,0 +1,33 @@
+/* { dg-do compile } */
+/* { dg-options "-O2 -fauto-profile=$srcdir/gcc.dg/afdo-1.afdo -fdump-ipa-afdo-blocks-details" } */
+
+extern void cold_path (int);
+
+int
+loop (int *a, int n)
+{
+  int i, sum = 0;
+
+  for (i = 0; i < n; i++)
+    if (a[i] < 0)
+      cold_path (a[i]);
+    else
+      sum += a[i];
+
+  return sum;
+}
+
+int
+never_sampled (int x)
+{
+  return x * 3;
+}
+
+/* { dg-final { scan-ipa-dump "loop: annotated \[1-9\]\[0-9\]* of" "afdo" } } */
+/* { dg-final { scan-ipa-dump-not "never_sampled: annotated" "afdo" } } */
+/* The block calling cold_path was never sampled, and the other arm of
+   the branch gets all of the count of its line.  */
+/* { dg-final { scan-ipa-dump "count 0, freq 0, probably never executed\n(\[^\n\]*\n)\{0,8\}\[^\n\]*cold_path \\(" "afdo" } } */
+/* { dg-final { scan-ipa-dump "loop depth 1, count 99900, freq \[0-9\]+, maybe hot" "afdo" } } */
+/* { dg-final { scan-ipa-dump "\\\[100.0%\\\]  count:99900" "afdo" } } */
+/* { dg-final { cleanup-ipa-dump "afdo" } } */
@@ -0,0 +1,23 @@
+/* { dg-lto-do run } */
+/* { dg-lto-options {{-O2 -flto -flto-compression-algorithm=lz} {-O2 -flto -flto-compression-algorithm=lz -flto-compression-level=9} {-O2 -flto -flto-compression-algorithm=zlib -flto-section-compression-level=function_body:0,decls:9} {-O2 -flto -flto-compression-algorithm=lz -flto-section-compression-level=decls:0}} } */
+
+/* Check that sections spanning several compression blocks survive.  */
+
+#define S1 "the quick brown fox jumps over the lazy dog 0123456789\n"
+#define S2 S1 S1 S1 S1 S1 S1 S1 S1
+#define S3 S2 S2 S2 S2 S2 S2 S2 S2
+#define S4 S3 S3 S3 S3 S3 S3 S3 S3
+#define S5 S4 S4 S4 S4 S4 S4 S4 S4
+
+extern void abort (void);
+extern int check (const char *, unsigned long);
+
+const char text[] = S5;
+
+int
+main (void)
+{
+  if (!check (text, sizeof (text) - 1))
+    abort ();
+  return 0;
+}
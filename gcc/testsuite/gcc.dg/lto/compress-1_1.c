@@ -0,0 +1,14 @@
+int
+check (const char *text, unsigned long len)
+{
+  static const char line[]
+    = "the quick brown fox jumps over the lazy dog 0123456789\n";
+  unsigned long i;
+
+  if (len != 4096 * (sizeof (line) - 1))
+    return 0;
+  for (i = 0; i < len; i++)
+    if (text[i] != line[i % (sizeof (line) - 1)])
+      return 0;
+  return 1;
+}
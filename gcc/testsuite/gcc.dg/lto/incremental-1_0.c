@@ -0,0 +1,17 @@
+/* { dg-lto-do run } */
+/* { dg-lto-options {{-O2 -flto -flto-partition=stable --param lto-partitions=4}} } */
+
+/* lto.exp also links these files twice with -flto-incremental and
+   checks that the second link reuses the cached LTRANS objects.  */
+
+extern void abort (void);
+extern int f1 (int);
+extern int f2 (int);
+
+int
+main (void)
+{
+  if (f1 (3) != 7 || f2 (3) != 9)
+    abort ();
+  return 0;
+}
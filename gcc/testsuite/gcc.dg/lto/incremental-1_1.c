@@ -0,0 +1,5 @@
+__attribute__ ((noinline)) int
+f1 (int x)
+{
+  return 2 * x + 1;
+}
@@ -0,0 +1,15 @@
+/* lto.exp compiles this file again with -DCHANGED to check that only
+   some of the partitions are recompiled.  */
+
+#ifdef CHANGED
+static volatile int calls;
+#endif
+
+__attribute__ ((noinline)) int
+f2 (int x)
+{
+#ifdef CHANGED
+  calls++;
+#endif
+  return 3 * x;
+}
@@ -0,0 +1,106 @@
+/* { dg-options "-O2 -freorder-blocks-algorithm=ext-tsp -fdump-rtl-bbro" } */
+
+extern void abort (void);
+
+enum op { OP_PUSH, OP_ADD, OP_OVER, OP_DUP, OP_JNZ, OP_DEC, OP_SWAP, OP_HALT };
+
+/* A small bytecode interpreter; most of its blocks are hot and most of
+   them jump back to the dispatch.  */
+
+__attribute__ ((noinline)) long
+run (const int *code)
+{
+  long stack[16];
+  int sp = 0, pc = 0;
+
+  for (;;)
+    switch (code[pc++])
+      {
+      case OP_PUSH:
+	stack[sp++] = code[pc++];
+	break;
+      case OP_ADD:
+	sp--;
+	stack[sp - 1] += stack[sp];
+	break;
+      case OP_OVER:
+	stack[sp] = stack[sp - 2];
+	sp++;
+	break;
+      case OP_DUP:
+	stack[sp] = stack[sp - 1];
+	sp++;
+	break;
+      case OP_JNZ:
+	if (stack[--sp])
+	  pc = code[pc];
+	else
+	  pc++;
+	break;
+      case OP_DEC:
+	stack[sp - 1]--;
+	break;
+      case OP_SWAP:
+	{
+	  long t = stack[sp - 1];
+	  stack[sp - 1] = stack[sp - 2];
+	  stack[sp - 2] = t;
+	}
+	break;
+      case OP_HALT:
+	return stack[sp - 1];
+      default:
+	abort ();
+      }
+}
+
+/* A loop whose hot path zigzags through rarely taken checks.  */
+
+__attribute__ ((noinline)) int
+classify (const unsigned char *s, int n)
+{
+  int i, digits = 0, letters = 0, other = 0;
+
+  for (i = 0; i < n; i++)
+    {
+      unsigned char c = s[i];
+      if (c >= '0' && c <= '9')
+	digits++;
+      else if ((c | 0x20) >= 'a' && (c | 0x20) <= 'z')
+	letters++;
+      else if (c == 0)
+	abort ();
+      else
+	other++;
+    }
+  return digits * 10000 + letters * 100 + other;
+}
+
+/* Sum 1000 down to 1.  */
+static const int program[] = {
+  OP_PUSH, 0, OP_PUSH, 1000,
+  /* 4: */ OP_SWAP, OP_OVER, OP_ADD, OP_SWAP, OP_DEC, OP_DUP, OP_JNZ, 4,
+  OP_SWAP, OP_HALT
+};
+
+int
+main (void)
+{
+  static const unsigned char text[] = "Hello, world 2018!";
+  int i, r = 0;
+
+  for (i = 0; i < 100; i++)
+    r += classify (text, sizeof text - 1);
+  if (r != 100 * (4 * 10000 + 10 * 100 + 4))
+    abort ();
+  if (run (program) != 500500)
+    abort ();
+  return 0;
+}
+
+/* { dg-final-use { scan-rtl-dump "Ext-TSP layout" "bbro" } } */
+/* The hot loop of classify takes fewer branches, and scores higher,
+   than in the order the blocks came in.  */
+/* { dg-final-use { scan-rtl-dump "Function classify\[^;\]*Taken branch frequency \[0-9\]+ before reordering, \[0-9\]+ after \\(\[1-9\]\[0-9\]* fewer\\)" "bbro" } } */
+/* { dg-final-use { scan-rtl-dump "Function classify\[^;\]*Ext-TSP score \[0-9\]+ before reordering, \[0-9\]+ after \\(\[1-9\]\[0-9\]* higher\\)" "bbro" } } */
+/* { dg-final-use { cleanup-rtl-dump "bbro" } } */
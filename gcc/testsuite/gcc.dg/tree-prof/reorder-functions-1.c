@@ -0,0 +1,54 @@
+/* { dg-require-effective-target lto } */
+/* { dg-options "-O2 -flto -fprofile-reorder-functions -freorder-functions-algorithm=call-chain-clustering -fdump-ipa-cgraph" } */
+
+extern void abort (void);
+
+int n;
+
+__attribute__ ((noinline)) void
+leaf (int i)
+{
+  n += i;
+}
+
+__attribute__ ((noinline)) void
+never_called (int i)
+{
+  n -= i;
+}
+
+__attribute__ ((noinline)) void
+middle (int i)
+{
+  leaf (i);
+  leaf (i + 1);
+}
+
+__attribute__ ((noinline)) void
+once (void)
+{
+  n = 0;
+}
+
+int
+main (void)
+{
+  int i;
+
+  once ();
+  for (i = 0; i < 100000; i++)
+    middle (i & 1);
+  if (n != 200000)
+    abort ();
+  if (n < 0)
+    never_called (n);
+  return 0;
+}
+
+/* The clustering is done at WPA time, so it is reported in the cgraph
+   dump of the WPA stage, which is named after the executable of the
+   feedback-directed compilation.  The callees follow their hottest
+   callers, and the function never executed is left out.  */
+/* { dg-final-use { scan-file reorder-functions-1.x02.wpa.000i.cgraph "Cluster 0, count \[0-9\]+, \[0-9\]+ bytes: main middle leaf once\n" } } */
+/* { dg-final-use { scan-file-not reorder-functions-1.x02.wpa.000i.cgraph "Cluster \[^\n\]*never_called" } } */
+/* { dg-final-use { scan-file reorder-functions-1.x02.wpa.000i.cgraph "Call-chain clustering placed 4 functions in 1 clusters: \[0-9\]+ bytes of hot code span 1 pages, \[0-9\]+ in source order" } } */
@@ -0,0 +1,39 @@
+/* Test that -fprofile-update=atomic keeps counts exact when several
+   threads run the same code.  */
+
+/* { dg-options "-fprofile-arcs -ftest-coverage -fprofile-update=atomic -pthread" } */
+/* { dg-do run { target native } } */
+/* { dg-require-effective-target pthread } */
+
+#include <pthread.h>
+
+#define THREADS 8
+#define ITERATIONS 100000
+
+static void *
+worker (void *arg)
+{
+  volatile int sink = 0;
+  int i;
+
+  for (i = 0; i < ITERATIONS; i++)	/* count(800008) */
+    sink++;				/* count(800000) */
+
+  return arg;				/* count(8) */
+}
+
+int
+main ()
+{
+  pthread_t threads[THREADS];
+  int i;
+
+  for (i = 0; i < THREADS; i++)
+    pthread_create (&threads[i], 0, worker, 0);
+  for (i = 0; i < THREADS; i++)
+    pthread_join (threads[i], 0);
+
+  return 0;				/* count(1) */
+}
+
+/* { dg-final { run-gcov gcov-16.c } } */
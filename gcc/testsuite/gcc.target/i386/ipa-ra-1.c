@@ -0,0 +1,19 @@
+/* { dg-do compile { target { ! ia32 } } } */
+/* { dg-options "-O2 -fipa-ra" } */
+
+static int __attribute__ ((noinline))
+bar (int x)
+{
+  return x + 3;
+}
+
+int __attribute__ ((noinline))
+foo (int y)
+{
+  return y + bar (y);
+}
+
+/* BAR does not clobber the register holding Y, so Y can stay in a
+   call-used register across the call and FOO needs no saves.  */
+/* { dg-final { scan-assembler-not "push" } } */
+/* { dg-final { scan-assembler-not "pop" } } */
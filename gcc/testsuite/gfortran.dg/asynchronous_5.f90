@@ -0,0 +1,53 @@
+! { dg-do run }
+! Check asynchronous unformatted data transfers on stream and sequential
+! units: ID=, WAIT with and without ID=, INQUIRE with PENDING=, items
+! that are not variables, and errors reported by WAIT.
+program main
+  implicit none
+  integer, parameter :: n = 100000, m = 5
+  real(8), asynchronous :: a(n, m), b(n, m)
+  integer :: id(m), id2, i, j, ios
+  logical :: pend
+  character(len=10) :: acc(2) = [character(len=10) :: 'stream', 'sequential']
+
+  do j = 1, m
+     do i = 1, n
+        a(i, j) = j * 1000000 + i
+     end do
+  end do
+
+  do i = 1, 2
+     open (10, file='asynchronous_5.dat', access=acc(i), form='unformatted', &
+           asynchronous='yes', status='replace')
+     do j = 1, m
+        write (10, asynchronous='yes', id=id(j)) a(:, j)
+     end do
+     write (10, asynchronous='yes', id=id2) 2 * a(:, 1), j
+     write (10) a(1:10, m)
+
+     inquire (10, pending=pend, id=id(1))
+     if (pend) call abort
+     wait (10, id=id2)
+     inquire (10, pending=pend)
+     if (pend) call abort
+
+     rewind (10)
+     b = 0
+     do j = 1, m
+        read (10, asynchronous='yes', id=id(j)) b(:, j)
+     end do
+     wait (10, id=id(m - 1))
+     if (any (b(:, 1:m-1) /= a(:, 1:m-1))) call abort
+     wait (10)
+     if (any (b /= a)) call abort
+     read (10) b(:, 1), j
+     if (any (b(:, 1) /= 2 * a(:, 1)) .or. j /= m + 1) call abort
+     read (10) b(1:10, 1)
+     if (any (b(1:10, 1) /= a(1:10, m))) call abort
+
+     read (10, asynchronous='yes', id=id2) b(:, 1)
+     wait (10, id=id2, iostat=ios)
+     if (ios == 0) call abort
+     close (10, status='delete')
+  end do
+end program main
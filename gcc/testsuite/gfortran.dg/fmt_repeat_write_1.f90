@@ -0,0 +1,64 @@
+! { dg-do run }
+! Check that a repeated I or F edit descriptor applied to an array writes
+! the same as writing the elements one at a time, including rounding
+! ties, negative zero, values that do not fit and special values.
+program main
+  implicit none
+  integer, parameter :: n = 40
+  real(8) :: x(n)
+  real(4) :: y(n)
+  integer :: k(n), i
+  character(len=16*n) :: a, b
+
+  do i = 1, n
+     x(i) = (-1)**i * (i * 1234.5678_8 / 7) / 10.0_8**mod(i, 7)
+     k(i) = (-1)**i * 37**mod(i, 6) * i
+  end do
+  x(1:12) = (/ 0.125_8, 0.375_8, -0.125_8, 2.5_8, 3.5_8, -0.0_8, &
+               -0.001_8, 0.0_8, 99999.995_8, huge(1.0_8), &
+               1.0e-320_8, -huge(1.0_8) /)
+  x(13) = x(13) / 0.0_8
+  y = x(1:n)
+  k(1:3) = (/ 0, -huge(1) - 1, huge(1) /)
+
+  write (a, '(40F16.2)') x
+  do i = 1, n
+     write (b(16*i-15:16*i), '(F16.2)') x(i)
+  end do
+  if (a /= b) call abort
+
+  write (a, '(SP,40F8.0)') x
+  b = ''
+  do i = 1, n
+     write (b(8*i-7:8*i), '(SP,F8.0)') x(i)
+  end do
+  if (a /= b) call abort
+
+  write (a, '(DC,40F12.5)') y
+  b = ''
+  do i = 1, n
+     write (b(12*i-11:12*i), '(DC,F12.5)') y(i)
+  end do
+  if (a /= b) call abort
+
+  write (a, '(40I7)') k
+  b = ''
+  do i = 1, n
+     write (b(7*i-6:7*i), '(I7)') k(i)
+  end do
+  if (a /= b) call abort
+
+  write (a, '(SP,40I12.4)') k
+  b = ''
+  do i = 1, n
+     write (b(12*i-11:12*i), '(SP,I12.4)') k(i)
+  end do
+  if (a /= b) call abort
+
+  write (a, '(40I3.0)') k
+  b = ''
+  do i = 1, n
+     write (b(3*i-2:3*i), '(I3.0)') k(i)
+  end do
+  if (a /= b) call abort
+end program main
@@ -54,6 +54,9 @@ along with GCC; see the file COPYING3.  If not see
 #include "value-prof.h"
 #include "profile.h"
 #include "target.h"
+#include "stor-layout.h"
+#include "expr.h"
+#include "optabs.h"
 #include "tree-cfgcleanup.h"
 #include "tree-nested.h"
 
@@ -147,6 +150,20 @@ init_ic_make_global_vars (void)
   varpool_finalize_decl (ic_gcov_type_ptr_var);
 }
 
+/* Return NAME, the name of a libgcov profiler, or for
+   -fprofile-update=atomic the name of its variant that updates the
+   counters atomically.  */
+
+static const char *
+profiler_fn_name (const char *name)
+{
+  if (flag_profile_update != PROFILE_UPDATE_ATOMIC)
+    return name;
+
+  return IDENTIFIER_POINTER (get_identifier (ACONCAT ((name, "_atomic",
+						       NULL))));
+}
+
 /* Create the type and function decls for the interface with gcov.  */
 
 void
@@ -172,7 +189,7 @@ gimple_init_edge_profiler (void)
 					  integer_type_node,
 					  unsigned_type_node, NULL_TREE);
       tree_interval_profiler_fn
-	      = build_fn_decl ("__gcov_interval_profiler",
+	      = build_fn_decl (profiler_fn_name ("__gcov_interval_profiler"),
 				     interval_profiler_fn_type);
       TREE_NOTHROW (tree_interval_profiler_fn) = 1;
       DECL_ATTRIBUTES (tree_interval_profiler_fn)
@@ -184,8 +201,9 @@ gimple_init_edge_profiler (void)
 	      = build_function_type_list (void_type_node,
 					  gcov_type_ptr, gcov_type_node,
 					  NULL_TREE);
-      tree_pow2_profiler_fn = build_fn_decl ("__gcov_pow2_profiler",
-						   pow2_profiler_fn_type);
+      tree_pow2_profiler_fn
+	      = build_fn_decl (profiler_fn_name ("__gcov_pow2_profiler"),
+			       pow2_profiler_fn_type);
       TREE_NOTHROW (tree_pow2_profiler_fn) = 1;
       DECL_ATTRIBUTES (tree_pow2_profiler_fn)
 	= tree_cons (get_identifier ("leaf"), NULL,
@@ -197,7 +215,7 @@ gimple_init_edge_profiler (void)
 					  gcov_type_ptr, gcov_type_node,
 					  NULL_TREE);
       tree_one_value_profiler_fn
-	      = build_fn_decl ("__gcov_one_value_profiler",
+	      = build_fn_decl (profiler_fn_name ("__gcov_one_value_profiler"),
 				     one_value_profiler_fn_type);
       TREE_NOTHROW (tree_one_value_profiler_fn) = 1;
       DECL_ATTRIBUTES (tree_one_value_profiler_fn)
@@ -216,8 +234,9 @@ gimple_init_edge_profiler (void)
 					      ptr_void, ptr_void,
 					      NULL_TREE);
 	  tree_indirect_call_profiler_fn
-		  = build_fn_decl ("__gcov_indirect_call_profiler",
-					 ic_profiler_fn_type);
+		  = build_fn_decl (profiler_fn_name
+				     ("__gcov_indirect_call_profiler"),
+				   ic_profiler_fn_type);
         }
       else
         {
@@ -228,8 +247,9 @@ gimple_init_edge_profiler (void)
 					      ptr_void,
 					      NULL_TREE);
 	  tree_indirect_call_profiler_fn
-		  = build_fn_decl ("__gcov_indirect_call_profiler_v2",
-					 ic_profiler_fn_type);
+		  = build_fn_decl (profiler_fn_name
+				     ("__gcov_indirect_call_profiler_v2"),
+				   ic_profiler_fn_type);
         }
       TREE_NOTHROW (tree_indirect_call_profiler_fn) = 1;
       DECL_ATTRIBUTES (tree_indirect_call_profiler_fn)
@@ -241,7 +261,7 @@ gimple_init_edge_profiler (void)
 	       = build_function_type_list (void_type_node,
 					  gcov_type_ptr, NULL_TREE);
       tree_time_profiler_fn
-	      = build_fn_decl ("__gcov_time_profiler",
+	      = build_fn_decl (profiler_fn_name ("__gcov_time_profiler"),
 				     time_profiler_fn_type);
       TREE_NOTHROW (tree_time_profiler_fn) = 1;
       DECL_ATTRIBUTES (tree_time_profiler_fn)
@@ -253,14 +273,14 @@ gimple_init_edge_profiler (void)
 	      = build_function_type_list (void_type_node,
 					  gcov_type_ptr, gcov_type_node, NULL_TREE);
       tree_average_profiler_fn
-	      = build_fn_decl ("__gcov_average_profiler",
+	      = build_fn_decl (profiler_fn_name ("__gcov_average_profiler"),
 				     average_profiler_fn_type);
       TREE_NOTHROW (tree_average_profiler_fn) = 1;
       DECL_ATTRIBUTES (tree_average_profiler_fn)
 	= tree_cons (get_identifier ("leaf"), NULL,
 		     DECL_ATTRIBUTES (tree_average_profiler_fn));
       tree_ior_profiler_fn
-	      = build_fn_decl ("__gcov_ior_profiler",
+	      = build_fn_decl (profiler_fn_name ("__gcov_ior_profiler"),
 				     average_profiler_fn_type);
       TREE_NOTHROW (tree_ior_profiler_fn) = 1;
       DECL_ATTRIBUTES (tree_ior_profiler_fn)
@@ -281,7 +301,9 @@ gimple_init_edge_profiler (void)
 
 /* Output instructions as GIMPLE trees to increment the edge
    execution count, and insert them on E.  We rely on
-   gsi_insert_on_edge to preserve the order.  */
+   gsi_insert_on_edge to preserve the order.  For
+   -fprofile-update=atomic the count is incremented with a single
+   relaxed atomic add instead.  */
 
 void
 gimple_gen_edge_profiler (int edgeno, edge e)
@@ -289,8 +311,25 @@ gimple_gen_edge_profiler (int edgeno, edge e)
   tree ref, one, gcov_type_tmp_var;
   gimple stmt1, stmt2, stmt3;
 
-  ref = tree_coverage_counter_ref (GCOV_COUNTER_ARCS, edgeno);
   one = build_int_cst (gcov_type_node, 1);
+
+  if (flag_profile_update == PROFILE_UPDATE_ATOMIC)
+    {
+      /* __atomic_fetch_add (&counter, 1, MEMMODEL_RELAXED);  */
+      tree addr = tree_coverage_counter_addr (GCOV_COUNTER_ARCS, edgeno);
+      enum built_in_function fcode
+	= (enum built_in_function)
+	  ((int) BUILT_IN_ATOMIC_FETCH_ADD_1
+	   + exact_log2 (tree_to_uhwi (TYPE_SIZE_UNIT (gcov_type_node))));
+      gimple stmt
+	= gimple_build_call (builtin_decl_explicit (fcode), 3, addr, one,
+			     build_int_cst (integer_type_node,
+					    MEMMODEL_RELAXED));
+      gsi_insert_on_edge (e, stmt);
+      return;
+    }
+
+  ref = tree_coverage_counter_ref (GCOV_COUNTER_ARCS, edgeno);
   gcov_type_tmp_var = make_temp_ssa_name (gcov_type_node,
 					  NULL, "PROF_edge_counter");
   stmt1 = gimple_build_assign (gcov_type_tmp_var, ref);
@@ -569,6 +608,14 @@ tree_profiling (void)
      cgraphunit.c:ipa_passes().  */
   gcc_assert (cgraph_state == CGRAPH_STATE_IPA_SSA);
 
+  if (flag_profile_update == PROFILE_UPDATE_ATOMIC
+      && !can_compare_and_swap_p (TYPE_MODE (get_gcov_type ()), false))
+    {
+      warning (0, "target does not support atomic profile update, "
+	       "single mode is selected");
+      flag_profile_update = PROFILE_UPDATE_SINGLE;
+    }
+
   init_node_map (true);
 
   FOR_EACH_DEFINED_FUNCTION (node)
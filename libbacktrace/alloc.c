@@ -70,6 +70,14 @@ backtrace_free (struct backtrace_state *state ATTRIBUTE_UNUSED,
   free (p);
 }
 
+/* Merge free lists.  With this allocator there is no free list.  */
+
+void
+backtrace_merge_freelist (struct backtrace_state *state ATTRIBUTE_UNUSED,
+			  struct backtrace_state *from ATTRIBUTE_UNUSED)
+{
+}
+
 /* Grow VEC by SIZE bytes.  */
 
 void *
@@ -166,6 +166,24 @@ extern int backtrace_pcinfo (struct backtrace_state *state, uintptr_t pc,
 			     backtrace_error_callback error_callback,
 			     void *data);
 
+/* Read ahead of time the debug info that backtrace_pcinfo uses, so
+   that later calls to backtrace_pcinfo do not have to.  Normally the
+   debug info of each compilation unit is read the first time a PC in
+   that unit is looked up.  The work is divided into PARTS parts, and
+   this call reads part PART, which must be at least 0 and less than
+   PARTS.  If STATE was created with THREADED non-zero, the parts may
+   be read by different threads at the same time, typically one part
+   per thread at program startup.  The executable itself is read by
+   the first call that needs it, so before starting the threads make
+   one such call, for instance to backtrace_syminfo, or every thread
+   will read the executable.  Returns 1 on success, 0 on error, in
+   which case ERROR_CALLBACK has been called.  */
+
+extern int backtrace_pcinfo_prewarm (struct backtrace_state *state,
+				     int part, int parts,
+				     backtrace_error_callback error_callback,
+				     void *data);
+
 /* The type of the callback argument to backtrace_syminfo.  DATA and
    PC are the arguments passed to backtrace_syminfo.  SYMNAME is the
    name of the symbol for the corresponding code.  SYMVAL is the
@@ -0,0 +1,237 @@
+/* bench.c -- Benchmark for reading the debug info of a large program
+   Copyright (C) 2026 Free Software Foundation, Inc.
+
+Redistribution and use in source and binary forms, with or without
+modification, are permitted provided that the following conditions are
+met:
+
+    (1) Redistributions of source code must retain the above copyright
+    notice, this list of conditions and the following disclaimer. 
+
+    (2) Redistributions in binary form must reproduce the above copyright
+    notice, this list of conditions and the following disclaimer in
+    the documentation and/or other materials provided with the
+    distribution.  
+    
+    (3) The name of the author may not be used to
+    endorse or promote products derived from this software without
+    specific prior written permission.
+
+THIS SOFTWARE IS PROVIDED BY THE AUTHOR ``AS IS'' AND ANY EXPRESS OR
+IMPLIED WARRANTIES, INCLUDING, BUT NOT LIMITED TO, THE IMPLIED
+WARRANTIES OF MERCHANTABILITY AND FITNESS FOR A PARTICULAR PURPOSE ARE
+DISCLAIMED. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR ANY DIRECT,
+INDIRECT, INCIDENTAL, SPECIAL, EXEMPLARY, OR CONSEQUENTIAL DAMAGES
+(INCLUDING, BUT NOT LIMITED TO, PROCUREMENT OF SUBSTITUTE GOODS OR
+SERVICES; LOSS OF USE, DATA, OR PROFITS; OR BUSINESS INTERRUPTION)
+HOWEVER CAUSED AND ON ANY THEORY OF LIABILITY, WHETHER IN CONTRACT,
+STRICT LIABILITY, OR TORT (INCLUDING NEGLIGENCE OR OTHERWISE) ARISING
+IN ANY WAY OUT OF THE USE OF THIS SOFTWARE, EVEN IF ADVISED OF THE
+POSSIBILITY OF SUCH DAMAGE.  */
+
+/* This program is linked with the synthetic compilation units that
+   bench.sh generates, and measures how long libbacktrace takes to
+   answer the first backtrace_pcinfo call, to look up every function
+   of the program, and to prewarm the debug info with several
+   threads.  It also checks that every lookup finds the right
+   function.  */
+
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include "backtrace.h"
+
+#ifndef ATTRIBUTE_UNUSED
+# define ATTRIBUTE_UNUSED __attribute__ ((__unused__))
+#endif
+
+/* Defined by the generated code.  */
+
+extern void *bench_table[];
+extern const char *bench_names[];
+extern int bench_count;
+
+/* The number of lookups that found the wrong function.  */
+
+static int failures;
+
+/* The current time in seconds.  */
+
+static double
+now (void)
+{
+  struct timeval tv;
+
+  gettimeofday (&tv, NULL);
+  return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+/* The resident set size of the process in kilobytes, or 0 if it is
+   not known.  */
+
+static long
+rss_kb (void)
+{
+  FILE *f;
+  long size;
+  long resident;
+
+  f = fopen ("/proc/self/statm", "r");
+  if (f == NULL)
+    return 0;
+  if (fscanf (f, "%ld %ld", &size, &resident) != 2)
+    resident = 0;
+  fclose (f);
+  return resident * (sysconf (_SC_PAGESIZE) / 1024);
+}
+
+static void
+error_callback (void *data ATTRIBUTE_UNUSED, const char *msg, int errnum)
+{
+  fprintf (stderr, "%s", msg);
+  if (errnum > 0)
+    fprintf (stderr, ": %s", strerror (errnum));
+  fprintf (stderr, "\n");
+  exit (EXIT_FAILURE);
+}
+
+/* Check that the function reported for bench_table[*DATA] is the
+   right one.  */
+
+static int
+check_callback (void *data, uintptr_t pc ATTRIBUTE_UNUSED,
+		const char *filename ATTRIBUTE_UNUSED,
+		int lineno ATTRIBUTE_UNUSED, const char *function)
+{
+  int i = *(int *) data;
+
+  if (function == NULL || strcmp (function, bench_names[i]) != 0)
+    {
+      fprintf (stderr, "%s: got %s\n", bench_names[i],
+	       function == NULL ? "NULL" : function);
+      ++failures;
+    }
+  return 1;
+}
+
+static void
+syminfo_callback (void *data ATTRIBUTE_UNUSED, uintptr_t pc ATTRIBUTE_UNUSED,
+		  const char *symname ATTRIBUTE_UNUSED,
+		  uintptr_t symval ATTRIBUTE_UNUSED,
+		  uintptr_t symsize ATTRIBUTE_UNUSED)
+{
+}
+
+/* Look up entry I of the function table.  */
+
+static void
+lookup (struct backtrace_state *state, int i)
+{
+  backtrace_pcinfo (state, (uintptr_t) bench_table[i], check_callback,
+		    error_callback, &i);
+}
+
+/* Look up every entry of the function table.  */
+
+static double
+lookup_all (struct backtrace_state *state)
+{
+  double start;
+  int i;
+
+  start = now ();
+  for (i = 0; i < bench_count; ++i)
+    lookup (state, i);
+  return now () - start;
+}
+
+struct prewarm_arg
+{
+  struct backtrace_state *state;
+  int part;
+  int parts;
+};
+
+static void *
+prewarm_thread (void *varg)
+{
+  struct prewarm_arg *arg = (struct prewarm_arg *) varg;
+
+  backtrace_pcinfo_prewarm (arg->state, arg->part, arg->parts,
+			    error_callback, NULL);
+  return NULL;
+}
+
+int
+main (int argc, char **argv)
+{
+  int threads;
+  struct backtrace_state *state;
+  long rss;
+  double start;
+  double first;
+  double all;
+  pthread_t *tids;
+  struct prewarm_arg *args;
+  int i;
+
+  threads = argc > 1 ? atoi (argv[1]) : 4;
+  if (threads < 1)
+    threads = 1;
+
+  printf ("%d functions\n", bench_count);
+
+  /* Lazy reading: only the units that are looked up are read.  */
+  rss = rss_kb ();
+  start = now ();
+  state = backtrace_create_state (NULL, 1, error_callback, NULL);
+  lookup (state, bench_count / 2);
+  first = now () - start;
+  printf ("first lookup: %.3f s, %ld kB\n", first, rss_kb () - rss);
+
+  all = lookup_all (state);
+  printf ("all lookups: %.3f s, %ld kB\n", all, rss_kb () - rss);
+
+  /* Prewarming with THREADS threads before looking anything up.  The
+     executable is read by the first call that needs it, here
+     backtrace_syminfo, so that the threads do not all read it.  */
+  rss = rss_kb ();
+  start = now ();
+  state = backtrace_create_state (NULL, 1, error_callback, NULL);
+  backtrace_syminfo (state, (uintptr_t) bench_table[0], syminfo_callback,
+		     error_callback, NULL);
+  tids = (pthread_t *) malloc (threads * sizeof *tids);
+  args = (struct prewarm_arg *) malloc (threads * sizeof *args);
+  if (tids == NULL || args == NULL)
+    error_callback (NULL, "malloc", 0);
+  for (i = 0; i < threads; ++i)
+    {
+      args[i].state = state;
+      args[i].part = i;
+      args[i].parts = threads;
+      if (pthread_create (&tids[i], NULL, prewarm_thread, &args[i]) != 0)
+	error_callback (NULL, "pthread_create", 0);
+    }
+  for (i = 0; i < threads; ++i)
+    pthread_join (tids[i], NULL);
+  printf ("prewarm, %d threads: %.3f s, %ld kB\n", threads, now () - start,
+	  rss_kb () - rss);
+
+  all = lookup_all (state);
+  printf ("all lookups after prewarm: %.3f s\n", all);
+
+  free (tids);
+  free (args);
+
+  if (failures != 0)
+    {
+      fprintf (stderr, "%d lookups failed\n", failures);
+      exit (EXIT_FAILURE);
+    }
+
+  exit (EXIT_SUCCESS);
+}
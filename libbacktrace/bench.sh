@@ -0,0 +1,55 @@
+#! /bin/sh
+# Build and run the libbacktrace debug info benchmark.
+# Copyright (C) 2026 Free Software Foundation, Inc.
+
+# Usage: bench.sh SRCDIR CC CFLAGS LIBS [THREADS]
+#
+# Generate a large synthetic program, BENCH_FILES compilation units of
+# BENCH_FUNCS functions each, in the directory bench.dir, link it with
+# bench.c and the libbacktrace built in the current directory, and run
+# it.  The defaults give 100000 functions.
+
+set -e
+
+srcdir=$1
+CC=$2
+CFLAGS=$3
+LIBS=$4
+threads=${5-4}
+files=${BENCH_FILES-200}
+funcs=${BENCH_FUNCS-500}
+
+rm -rf bench.dir
+mkdir bench.dir
+
+awk -v files="$files" -v funcs="$funcs" '
+BEGIN {
+  tab = "bench.dir/table.c"
+  for (f = 0; f < files; f++) {
+    out = sprintf ("bench.dir/f%d.c", f)
+    for (i = 0; i < funcs; i++) {
+      printf ("int __attribute__ ((noinline))\n") > out
+      printf ("bench_f%d_%d (int x)\n{\n", f, i) > out
+      printf ("  return x * %d + %d;\n}\n\n", i + 1, f) > out
+      printf ("extern int bench_f%d_%d (int);\n", f, i) > tab
+    }
+    close (out)
+  }
+  printf ("void *bench_table[] = {\n") > tab
+  for (f = 0; f < files; f++)
+    for (i = 0; i < funcs; i++)
+      printf ("  (void *) bench_f%d_%d,\n", f, i) > tab
+  printf ("};\nconst char *bench_names[] = {\n") > tab
+  for (f = 0; f < files; f++)
+    for (i = 0; i < funcs; i++)
+      printf ("  \"bench_f%d_%d\",\n", f, i) > tab
+  printf ("};\nint bench_count = %d;\n", files * funcs) > tab
+}'
+
+for f in bench.dir/*.c; do
+  $CC $CFLAGS -c -o ${f%.c}.o $f
+done
+$CC $CFLAGS -I$srcdir -I. -o bench.dir/bench $srcdir/bench.c \
+  bench.dir/*.o .libs/libbacktrace.a $LIBS
+
+./bench.dir/bench $threads
@@ -292,10 +292,11 @@ struct unit
   /* The abbreviations for this unit.  */
   struct abbrevs abbrevs;
 
-  /* The fields above this point are read in during initialization and
-     may be accessed freely.  The fields below this point are read in
-     as needed, and therefore require care, as different threads may
-     try to initialize them simultaneously.  */
+  /* The fields above this point are set before the unit is stored in
+     its struct unit_slot, and may be accessed freely.  The fields
+     below this point are read in as needed, and therefore require
+     care, as different threads may try to initialize them
+     simultaneously.  */
 
   /* PC to line number mapping.  This is NULL if the values have not
      been read.  This is (struct line *) -1 if there was an error
@@ -308,6 +309,29 @@ struct unit
   size_t function_addrs_count;
 };
 
+/* A compilation unit as listed in the address map.  The unit itself
+   is read in the first time it is needed, as for a large program most
+   units are never looked at.  */
+
+struct unit_slot
+{
+  /* The offset of the unit header in the .debug_info section.  */
+  uint64_t offset;
+  /* The unit.  This is NULL if it has not been read.  This is (struct
+     unit *) -1 if there was an error reading it.  */
+  struct unit *u;
+};
+
+/* A growable vector of compilation unit slots.  */
+
+struct unit_slot_vector
+{
+  /* Memory.  This is an array of struct unit_slot.  */
+  struct backtrace_vector vec;
+  /* Number of units present.  */
+  size_t count;
+};
+
 /* An address range for a compilation unit.  This maps a PC value to a
    specific compilation unit.  Note that we invert the representation
    in DWARF: instead of listing the units and attaching a list of
@@ -319,8 +343,8 @@ struct unit_addrs
   /* Range is LOW <= PC < HIGH.  */
   uint64_t low;
   uint64_t high;
-  /* Compilation unit for this address range.  */
-  struct unit *u;
+  /* Index of the compilation unit for this address range.  */
+  size_t unit;
 };
 
 /* A growable vector of compilation unit address ranges.  */
@@ -333,6 +357,18 @@ struct unit_addrs_vector
   size_t count;
 };
 
+/* Once the address ranges are sorted we only keep the ranges
+   themselves in one table, and the unit indexes in a parallel table,
+   so that the binary search for a PC touches as little memory as
+   possible.  */
+
+struct pc_range
+{
+  /* Range is LOW <= PC < HIGH.  */
+  uint64_t low;
+  uint64_t high;
+};
+
 /* The information we need to map a PC to a file and line.  */
 
 struct dwarf_data
@@ -342,15 +378,24 @@ struct dwarf_data
   /* The base address for this file.  */
   uintptr_t base_address;
   /* A sorted list of address ranges.  */
-  struct unit_addrs *addrs;
+  struct pc_range *addrs;
+  /* The index in UNITS of the unit for each entry in ADDRS.  */
+  uint32_t *addrs_unit;
   /* Number of address ranges in list.  */
   size_t addrs_count;
+  /* The compilation units, in .debug_info order.  */
+  struct unit_slot *units;
+  /* Number of compilation units.  */
+  size_t units_count;
   /* The unparsed .debug_info section.  */
   const unsigned char *dwarf_info;
   size_t dwarf_info_size;
   /* The unparsed .debug_line section.  */
   const unsigned char *dwarf_line;
   size_t dwarf_line_size;
+  /* The unparsed .debug_abbrev section.  */
+  const unsigned char *dwarf_abbrev;
+  size_t dwarf_abbrev_size;
   /* The unparsed .debug_ranges section.  */
   const unsigned char *dwarf_ranges;
   size_t dwarf_ranges_size;
@@ -862,7 +907,7 @@ add_unit_addr (struct backtrace_state *state, uintptr_t base_address,
     {
       p = (struct unit_addrs *) vec->vec.base + (vec->count - 1);
       if ((addrs.low == p->high || addrs.low == p->high + 1)
-	  && addrs.u == p->u)
+	  && addrs.unit == p->unit)
 	{
 	  if (addrs.high > p->high)
 	    p->high = addrs.high;
@@ -881,19 +926,29 @@ add_unit_addr (struct backtrace_state *state, uintptr_t base_address,
   return 1;
 }
 
-/* Free a unit address vector.  */
+/* Free the compilation units that have been read into a unit slot
+   vector.  */
 
 static void
-free_unit_addrs_vector (struct backtrace_state *state,
-			struct unit_addrs_vector *vec,
-			backtrace_error_callback error_callback, void *data)
+free_unit_slot_vector (struct backtrace_state *state,
+		       struct unit_slot_vector *vec,
+		       backtrace_error_callback error_callback, void *data)
 {
-  struct unit_addrs *addrs;
+  struct unit_slot *slots;
   size_t i;
 
-  addrs = (struct unit_addrs *) vec->vec.base;
+  slots = (struct unit_slot *) vec->vec.base;
   for (i = 0; i < vec->count; ++i)
-    free_abbrevs (state, &addrs[i].u->abbrevs, error_callback, data);
+    {
+      struct unit *u;
+
+      u = slots[i].u;
+      if (u != NULL && u != (struct unit *) (uintptr_t) -1)
+	{
+	  free_abbrevs (state, &u->abbrevs, error_callback, data);
+	  backtrace_free (state, u, sizeof *u, error_callback, data);
+	}
+    }
 }
 
 /* Compare unit_addrs for qsort.  When ranges are nested, make the
@@ -913,33 +968,13 @@ unit_addrs_compare (const void *v1, const void *v2)
     return 1;
   if (a1->high > a2->high)
     return -1;
-  if (a1->u->lineoff < a2->u->lineoff)
+  if (a1->unit < a2->unit)
     return -1;
-  if (a1->u->lineoff > a2->u->lineoff)
+  if (a1->unit > a2->unit)
     return 1;
   return 0;
 }
 
-/* Compare a PC against a unit_addrs for bsearch.  Note that if there
-   are multiple ranges containing PC, which one will be returned is
-   unpredictable.  We compensate for that in dwarf_fileline.  */
-
-static int
-unit_addrs_search (const void *vkey, const void *ventry)
-{
-  const uintptr_t *key = (const uintptr_t *) vkey;
-  const struct unit_addrs *entry = (const struct unit_addrs *) ventry;
-  uintptr_t pc;
-
-  pc = *key;
-  if (pc < entry->low)
-    return -1;
-  else if (pc >= entry->high)
-    return 1;
-  else
-    return 0;
-}
-
 /* Sort the line vector by PC.  We want a stable sort here.  We know
    that the pointers are into the same array, so it is safe to compare
    them directly.  */
@@ -1177,7 +1212,7 @@ lookup_abbrev (struct abbrevs *abbrevs, uint64_t code,
 
 static int
 add_unit_ranges (struct backtrace_state *state, uintptr_t base_address,
-		 struct unit *u, uint64_t ranges, uint64_t base,
+		 struct unit *u, size_t unit, uint64_t ranges, uint64_t base,
 		 int is_bigendian, const unsigned char *dwarf_ranges,
 		 size_t dwarf_ranges_size,
 		 backtrace_error_callback error_callback, void *data,
@@ -1222,7 +1257,7 @@ add_unit_ranges (struct backtrace_state *state, uintptr_t base_address,
 
 	  a.low = low + base;
 	  a.high = high + base;
-	  a.u = u;
+	  a.unit = unit;
 	  if (!add_unit_addr (state, base_address, a, error_callback, data,
 			      addrs))
 	    return 0;
@@ -1236,7 +1271,9 @@ add_unit_ranges (struct backtrace_state *state, uintptr_t base_address,
 }
 
 /* Find the address range covered by a compilation unit, reading from
-   UNIT_BUF and adding values to U.  Returns 1 if all data could be
+   UNIT_BUF and adding values to U, whose index is UNIT.  If ADDRS is
+   NULL the address ranges are already known, and we only read the
+   attributes of the top level DIE.  Returns 1 if all data could be
    read, 0 if there is some error.  */
 
 static int
@@ -1246,7 +1283,7 @@ find_address_ranges (struct backtrace_state *state, uintptr_t base_address,
 		     const unsigned char *dwarf_ranges,
 		     size_t dwarf_ranges_size,
 		     int is_bigendian, backtrace_error_callback error_callback,
-		     void *data, struct unit *u,
+		     void *data, struct unit *u, size_t unit,
 		     struct unit_addrs_vector *addrs)
 {
   while (unit_buf->left > 0)
@@ -1343,13 +1380,16 @@ find_address_ranges (struct backtrace_state *state, uintptr_t base_address,
 	    }
 	}
 
+      if (addrs == NULL)
+	return 1;
+
       if (abbrev->tag == DW_TAG_compile_unit
 	  || abbrev->tag == DW_TAG_subprogram)
 	{
 	  if (have_ranges)
 	    {
-	      if (!add_unit_ranges (state, base_address, u, ranges, lowpc,
-				    is_bigendian, dwarf_ranges,
+	      if (!add_unit_ranges (state, base_address, u, unit, ranges,
+				    lowpc, is_bigendian, dwarf_ranges,
 				    dwarf_ranges_size, error_callback,
 				    data, addrs))
 		return 0;
@@ -1362,7 +1402,7 @@ find_address_ranges (struct backtrace_state *state, uintptr_t base_address,
 		highpc += lowpc;
 	      a.low = lowpc;
 	      a.high = highpc;
-	      a.u = u;
+	      a.unit = unit;
 
 	      if (!add_unit_addr (state, base_address, a, error_callback, data,
 				  addrs))
@@ -1382,7 +1422,7 @@ find_address_ranges (struct backtrace_state *state, uintptr_t base_address,
 				    dwarf_str, dwarf_str_size,
 				    dwarf_ranges, dwarf_ranges_size,
 				    is_bigendian, error_callback, data,
-				    u, addrs))
+				    u, unit, addrs))
 	    return 0;
 	}
     }
@@ -1390,28 +1430,17 @@ find_address_ranges (struct backtrace_state *state, uintptr_t base_address,
   return 1;
 }
 
-/* Build a mapping from address ranges to the compilation units where
-   the line number information for that range can be found.  Returns 1
-   on success, 0 on failure.  */
+/* Add a slot for each compilation unit in the .debug_info section to
+   UNITS.  This only looks at the unit headers; the units themselves
+   are read later.  Returns 1 on success, 0 on failure.  */
 
 static int
-build_address_map (struct backtrace_state *state, uintptr_t base_address,
-		   const unsigned char *dwarf_info, size_t dwarf_info_size,
-		   const unsigned char *dwarf_abbrev, size_t dwarf_abbrev_size,
-		   const unsigned char *dwarf_ranges, size_t dwarf_ranges_size,
-		   const unsigned char *dwarf_str, size_t dwarf_str_size,
-		   int is_bigendian, backtrace_error_callback error_callback,
-		   void *data, struct unit_addrs_vector *addrs)
+find_units (struct backtrace_state *state,
+	    const unsigned char *dwarf_info, size_t dwarf_info_size,
+	    int is_bigendian, backtrace_error_callback error_callback,
+	    void *data, struct unit_slot_vector *units)
 {
   struct dwarf_buf info;
-  struct abbrevs abbrevs;
-
-  memset (&addrs->vec, 0, sizeof addrs->vec);
-  addrs->count = 0;
-
-  /* Read through the .debug_info section.  FIXME: Should we use the
-     .debug_aranges section?  gdb and addr2line don't use it, but I'm
-     not sure why.  */
 
   info.name = ".debug_info";
   info.start = dwarf_info;
@@ -1422,100 +1451,368 @@ build_address_map (struct backtrace_state *state, uintptr_t base_address,
   info.data = data;
   info.reported_underflow = 0;
 
-  memset (&abbrevs, 0, sizeof abbrevs);
   while (info.left > 0)
     {
-      const unsigned char *unit_data_start;
+      uint64_t offset;
       uint64_t len;
-      int is_dwarf64;
       struct dwarf_buf unit_buf;
       int version;
-      uint64_t abbrev_offset;
-      int addrsize;
-      struct unit *u;
+      struct unit_slot *slot;
 
       if (info.reported_underflow)
-	goto fail;
+	return 0;
 
-      unit_data_start = info.buf;
+      offset = info.buf - dwarf_info;
 
-      is_dwarf64 = 0;
       len = read_uint32 (&info);
       if (len == 0xffffffff)
-	{
-	  len = read_uint64 (&info);
-	  is_dwarf64 = 1;
-	}
+	len = read_uint64 (&info);
 
       unit_buf = info;
       unit_buf.left = len;
 
       if (!advance (&info, len))
-	goto fail;
+	return 0;
 
       version = read_uint16 (&unit_buf);
       if (version < 2 || version > 4)
 	{
 	  dwarf_buf_error (&unit_buf, "unrecognized DWARF version");
-	  goto fail;
+	  return 0;
 	}
 
-      abbrev_offset = read_offset (&unit_buf, is_dwarf64);
-      if (!read_abbrevs (state, abbrev_offset, dwarf_abbrev, dwarf_abbrev_size,
-			 is_bigendian, error_callback, data, &abbrevs))
-	goto fail;
+      slot = ((struct unit_slot *)
+	      backtrace_vector_grow (state, sizeof (struct unit_slot),
+				     error_callback, data, &units->vec));
+      if (slot == NULL)
+	return 0;
+      slot->offset = offset;
+      slot->u = NULL;
+      ++units->count;
+    }
 
-      addrsize = read_byte (&unit_buf);
+  return !info.reported_underflow;
+}
 
-      u = ((struct unit *)
-	   backtrace_alloc (state, sizeof *u, error_callback, data));
-      if (u == NULL)
-	goto fail;
-      u->unit_data = unit_buf.buf;
-      u->unit_data_len = unit_buf.left;
-      u->unit_data_offset = unit_buf.buf - unit_data_start;
-      u->version = version;
-      u->is_dwarf64 = is_dwarf64;
-      u->addrsize = addrsize;
-      u->filename = NULL;
-      u->comp_dir = NULL;
-      u->abs_filename = NULL;
-      u->lineoff = 0;
-      u->abbrevs = abbrevs;
-      memset (&abbrevs, 0, sizeof abbrevs);
-
-      /* The actual line number mappings will be read as needed.  */
-      u->lines = NULL;
-      u->lines_count = 0;
-      u->function_addrs = NULL;
-      u->function_addrs_count = 0;
-
-      if (!find_address_ranges (state, base_address, &unit_buf,
-				dwarf_str, dwarf_str_size,
-				dwarf_ranges, dwarf_ranges_size,
-				is_bigendian, error_callback, data,
-				u, addrs))
+/* Read the compilation unit whose header is at OFFSET in the
+   .debug_info section: the header, the abbreviations, and the
+   attributes of the top level DIE.  UNIT is the index of the unit.  If
+   ADDRS is not NULL, also add the address ranges of the unit to
+   ADDRS.  Returns the new unit, or NULL on failure.  */
+
+static struct unit *
+read_unit (struct backtrace_state *state, uintptr_t base_address,
+	   const unsigned char *dwarf_info, size_t dwarf_info_size,
+	   const unsigned char *dwarf_abbrev, size_t dwarf_abbrev_size,
+	   const unsigned char *dwarf_ranges, size_t dwarf_ranges_size,
+	   const unsigned char *dwarf_str, size_t dwarf_str_size,
+	   int is_bigendian, uint64_t offset, size_t unit,
+	   backtrace_error_callback error_callback, void *data,
+	   struct unit_addrs_vector *addrs)
+{
+  const unsigned char *unit_data_start;
+  struct dwarf_buf unit_buf;
+  uint64_t len;
+  int is_dwarf64;
+  int version;
+  uint64_t abbrev_offset;
+  struct abbrevs abbrevs;
+  int addrsize;
+  struct unit *u;
+
+  unit_data_start = dwarf_info + offset;
+
+  unit_buf.name = ".debug_info";
+  unit_buf.start = dwarf_info;
+  unit_buf.buf = unit_data_start;
+  unit_buf.left = dwarf_info_size - offset;
+  unit_buf.is_bigendian = is_bigendian;
+  unit_buf.error_callback = error_callback;
+  unit_buf.data = data;
+  unit_buf.reported_underflow = 0;
+
+  is_dwarf64 = 0;
+  len = read_uint32 (&unit_buf);
+  if (len == 0xffffffff)
+    {
+      len = read_uint64 (&unit_buf);
+      is_dwarf64 = 1;
+    }
+
+  if (!require (&unit_buf, len))
+    return NULL;
+  unit_buf.left = len;
+
+  version = read_uint16 (&unit_buf);
+  if (version < 2 || version > 4)
+    {
+      dwarf_buf_error (&unit_buf, "unrecognized DWARF version");
+      return NULL;
+    }
+
+  memset (&abbrevs, 0, sizeof abbrevs);
+  abbrev_offset = read_offset (&unit_buf, is_dwarf64);
+  if (!read_abbrevs (state, abbrev_offset, dwarf_abbrev, dwarf_abbrev_size,
+		     is_bigendian, error_callback, data, &abbrevs))
+    return NULL;
+
+  addrsize = read_byte (&unit_buf);
+
+  u = ((struct unit *)
+       backtrace_alloc (state, sizeof *u, error_callback, data));
+  if (u == NULL)
+    {
+      free_abbrevs (state, &abbrevs, error_callback, data);
+      return NULL;
+    }
+  u->unit_data = unit_buf.buf;
+  u->unit_data_len = unit_buf.left;
+  u->unit_data_offset = unit_buf.buf - unit_data_start;
+  u->version = version;
+  u->is_dwarf64 = is_dwarf64;
+  u->addrsize = addrsize;
+  u->filename = NULL;
+  u->comp_dir = NULL;
+  u->abs_filename = NULL;
+  u->lineoff = 0;
+  u->abbrevs = abbrevs;
+
+  /* The actual line number mappings will be read as needed.  */
+  u->lines = NULL;
+  u->lines_count = 0;
+  u->function_addrs = NULL;
+  u->function_addrs_count = 0;
+
+  if (!find_address_ranges (state, base_address, &unit_buf,
+			    dwarf_str, dwarf_str_size,
+			    dwarf_ranges, dwarf_ranges_size,
+			    is_bigendian, error_callback, data,
+			    u, unit, addrs)
+      || unit_buf.reported_underflow)
+    {
+      free_abbrevs (state, &u->abbrevs, error_callback, data);
+      backtrace_free (state, u, sizeof *u, error_callback, data);
+      return NULL;
+    }
+
+  return u;
+}
+
+/* The error callback used while reading the .debug_aranges section.
+   A section that we can not use is not an error; we just get the
+   address ranges from the .debug_info section instead.  */
+
+static void
+aranges_error (void *data ATTRIBUTE_UNUSED, const char *msg ATTRIBUTE_UNUSED,
+	       int errnum ATTRIBUTE_UNUSED)
+{
+}
+
+/* Compare a .debug_info offset against a unit_slot for bsearch.  */
+
+static int
+unit_slot_search (const void *vkey, const void *ventry)
+{
+  const uint64_t *key = (const uint64_t *) vkey;
+  const struct unit_slot *entry = (const struct unit_slot *) ventry;
+
+  if (*key < entry->offset)
+    return -1;
+  else if (*key > entry->offset)
+    return 1;
+  else
+    return 0;
+}
+
+/* Add the address ranges listed in the .debug_aranges section to
+   ADDRS, and set COVERED[I] for each unit I in UNITS that the section
+   describes.  Returns 1 on success, 0 if the section can not be
+   used.  */
+
+static int
+read_aranges (struct backtrace_state *state, uintptr_t base_address,
+	      const unsigned char *dwarf_aranges, size_t dwarf_aranges_size,
+	      int is_bigendian, const struct unit_slot_vector *units,
+	      unsigned char *covered,
+	      backtrace_error_callback error_callback, void *data,
+	      struct unit_addrs_vector *addrs)
+{
+  struct dwarf_buf aranges;
+  const struct unit_slot *slots;
+
+  aranges.name = ".debug_aranges";
+  aranges.start = dwarf_aranges;
+  aranges.buf = dwarf_aranges;
+  aranges.left = dwarf_aranges_size;
+  aranges.is_bigendian = is_bigendian;
+  aranges.error_callback = aranges_error;
+  aranges.data = NULL;
+  aranges.reported_underflow = 0;
+
+  slots = (const struct unit_slot *) units->vec.base;
+  while (aranges.left > 0)
+    {
+      const unsigned char *set_start;
+      uint64_t len;
+      int is_dwarf64;
+      struct dwarf_buf set_buf;
+      uint64_t info_offset;
+      int addrsize;
+      const struct unit_slot *slot;
+      size_t unit;
+
+      set_start = aranges.buf;
+
+      is_dwarf64 = 0;
+      len = read_uint32 (&aranges);
+      if (len == 0xffffffff)
 	{
-	  free_abbrevs (state, &u->abbrevs, error_callback, data);
-	  backtrace_free (state, u, sizeof *u, error_callback, data);
-	  goto fail;
+	  len = read_uint64 (&aranges);
+	  is_dwarf64 = 1;
 	}
 
-      if (unit_buf.reported_underflow)
+      set_buf = aranges;
+      set_buf.left = len;
+
+      if (!advance (&aranges, len))
+	return 0;
+
+      if (read_uint16 (&set_buf) != 2)
+	return 0;
+      info_offset = read_offset (&set_buf, is_dwarf64);
+      addrsize = read_byte (&set_buf);
+      if (read_byte (&set_buf) != 0)
+	return 0;
+      if (addrsize != 2 && addrsize != 4 && addrsize != 8)
+	return 0;
+
+      /* The address ranges are aligned to twice the address size,
+	 counting from the start of the set.  */
+      while ((size_t) (set_buf.buf - set_start) % (2 * addrsize) != 0)
+	if (!advance (&set_buf, 1))
+	  return 0;
+
+      slot = ((const struct unit_slot *)
+	      bsearch (&info_offset, slots, units->count,
+		       sizeof (struct unit_slot), unit_slot_search));
+      if (slot == NULL)
+	return 0;
+      unit = slot - slots;
+      covered[unit] = 1;
+
+      while (1)
 	{
-	  free_abbrevs (state, &u->abbrevs, error_callback, data);
-	  backtrace_free (state, u, sizeof *u, error_callback, data);
-	  goto fail;
+	  uint64_t start;
+	  uint64_t length;
+	  struct unit_addrs a;
+
+	  start = read_address (&set_buf, addrsize);
+	  length = read_address (&set_buf, addrsize);
+
+	  if (set_buf.reported_underflow)
+	    return 0;
+
+	  if (start == 0 && length == 0)
+	    break;
+
+	  if (length == 0)
+	    continue;
+
+	  a.low = start;
+	  a.high = start + length;
+	  a.unit = unit;
+	  if (!add_unit_addr (state, base_address, a, error_callback, data,
+			      addrs))
+	    return 0;
 	}
     }
-  if (info.reported_underflow)
-    goto fail;
+
+  return !aranges.reported_underflow;
+}
+
+/* Build a mapping from address ranges to the compilation units where
+   the line number information for that range can be found, and the
+   list of those units.  The address ranges of the units described by
+   the .debug_aranges section are taken from there, and those units
+   are only read when they are first needed; other units are read
+   now.  Returns 1 on success, 0 on failure.  */
+
+static int
+build_address_map (struct backtrace_state *state, uintptr_t base_address,
+		   const unsigned char *dwarf_info, size_t dwarf_info_size,
+		   const unsigned char *dwarf_abbrev, size_t dwarf_abbrev_size,
+		   const unsigned char *dwarf_ranges, size_t dwarf_ranges_size,
+		   const unsigned char *dwarf_str, size_t dwarf_str_size,
+		   const unsigned char *dwarf_aranges,
+		   size_t dwarf_aranges_size,
+		   int is_bigendian, backtrace_error_callback error_callback,
+		   void *data, struct unit_addrs_vector *addrs,
+		   struct unit_slot_vector *units)
+{
+  unsigned char *covered;
+  struct unit_slot *slots;
+  size_t i;
+
+  memset (&addrs->vec, 0, sizeof addrs->vec);
+  addrs->count = 0;
+  memset (&units->vec, 0, sizeof units->vec);
+  units->count = 0;
+
+  if (!find_units (state, dwarf_info, dwarf_info_size, is_bigendian,
+		   error_callback, data, units))
+    return 0;
+
+  covered = NULL;
+  if (dwarf_aranges_size > 0 && units->count > 0)
+    {
+      covered = ((unsigned char *)
+		 backtrace_alloc (state, units->count, error_callback, data));
+      if (covered == NULL)
+	return 0;
+      memset (covered, 0, units->count);
+
+      if (!read_aranges (state, base_address, dwarf_aranges,
+			 dwarf_aranges_size, is_bigendian, units, covered,
+			 error_callback, data, addrs))
+	{
+	  /* Forget anything we took from .debug_aranges, and read all
+	     the units now.  */
+	  backtrace_free (state, covered, units->count, error_callback,
+			  data);
+	  covered = NULL;
+	  addrs->vec.alc += addrs->vec.size;
+	  addrs->vec.size = 0;
+	  addrs->count = 0;
+	}
+    }
+
+  slots = (struct unit_slot *) units->vec.base;
+  for (i = 0; i < units->count; ++i)
+    {
+      struct unit *u;
+
+      if (covered != NULL && covered[i])
+	continue;
+
+      u = read_unit (state, base_address, dwarf_info, dwarf_info_size,
+		     dwarf_abbrev, dwarf_abbrev_size, dwarf_ranges,
+		     dwarf_ranges_size, dwarf_str, dwarf_str_size,
+		     is_bigendian, slots[i].offset, i, error_callback, data,
+		     addrs);
+      if (u == NULL)
+	goto fail;
+      slots[i].u = u;
+    }
+
+  if (covered != NULL)
+    backtrace_free (state, covered, units->count, error_callback, data);
 
   return 1;
 
  fail:
-  free_abbrevs (state, &abbrevs, error_callback, data);
-  free_unit_addrs_vector (state, addrs, error_callback, data);
+  if (covered != NULL)
+    backtrace_free (state, covered, units->count, error_callback, data);
+  free_unit_slot_vector (state, units, error_callback, data);
   return 0;
 }
 
@@ -2615,6 +2912,125 @@ report_inlined_functions (uintptr_t pc, struct function *function,
   return 0;
 }
 
+/* Return the compilation unit in SLOT, reading it in if that has not
+   been done yet.  Returns NULL if the unit can not be read.  */
+
+static struct unit *
+get_unit (struct backtrace_state *state, struct dwarf_data *ddata,
+	  struct unit_slot *slot, backtrace_error_callback error_callback,
+	  void *data)
+{
+  struct unit *u;
+
+  if (!state->threaded)
+    u = slot->u;
+  else
+    u = backtrace_atomic_load_pointer (&slot->u);
+
+  if (u == NULL)
+    {
+      u = read_unit (state, ddata->base_address, ddata->dwarf_info,
+		     ddata->dwarf_info_size, ddata->dwarf_abbrev,
+		     ddata->dwarf_abbrev_size, ddata->dwarf_ranges,
+		     ddata->dwarf_ranges_size, ddata->dwarf_str,
+		     ddata->dwarf_str_size, ddata->is_bigendian,
+		     slot->offset, slot - ddata->units, error_callback, data,
+		     NULL);
+      if (u == NULL)
+	u = (struct unit *) (uintptr_t) -1;
+
+      /* If another thread is reading the same unit, we don't care
+	 which copy we wind up with; we just leak the other one.  */
+      if (!state->threaded)
+	slot->u = u;
+      else
+	backtrace_atomic_store_pointer (&slot->u, u);
+    }
+
+  if (u == (struct unit *) (uintptr_t) -1)
+    return NULL;
+  return u;
+}
+
+/* Return the line number information for U, reading it in along with
+   the function information if that has not been done yet.  Returns
+   (struct line *) -1 if the information can not be read.  Sets
+   *NEW_DATA if this call read the information.  */
+
+static struct line *
+get_unit_lines (struct backtrace_state *state, struct dwarf_data *ddata,
+		struct unit *u, backtrace_error_callback error_callback,
+		void *data, int *new_data)
+{
+  struct line *lines;
+  struct function_addrs *function_addrs;
+  size_t function_addrs_count;
+  struct line_header lhdr;
+  size_t count;
+
+  /* We need the lines, lines_count, function_addrs,
+     function_addrs_count fields of u.  If they are not set, we need
+     to set them.  When running in threaded mode, we need to allow for
+     the possibility that some other thread is setting them
+     simultaneously.  */
+
+  if (!state->threaded)
+    lines = u->lines;
+  else
+    lines = backtrace_atomic_load_pointer (&u->lines);
+
+  *new_data = 0;
+  if (lines != NULL)
+    return lines;
+
+  /* We have never read the line information for this unit.  Read it
+     now.  */
+
+  function_addrs = NULL;
+  function_addrs_count = 0;
+  if (read_line_info (state, ddata, error_callback, data, u, &lhdr,
+		      &lines, &count))
+    {
+      struct function_vector *pfvec;
+
+      /* If not threaded, reuse DDATA->FVEC for better memory
+	 consumption.  */
+      if (state->threaded)
+	pfvec = NULL;
+      else
+	pfvec = &ddata->fvec;
+      read_function_info (state, ddata, &lhdr, error_callback, data,
+			  u, pfvec, &function_addrs, &function_addrs_count);
+      free_line_header (state, &lhdr, error_callback, data);
+      *new_data = 1;
+    }
+
+  /* Atomically store the information we just read into the unit.  If
+     another thread is simultaneously writing, it presumably read the
+     same information, and we don't care which one we wind up with; we
+     just leak the other one.  We do have to write the lines field
+     last, so that the acquire-loads above ensure that the other
+     fields are set.  */
+
+  if (!state->threaded)
+    {
+      u->lines_count = count;
+      u->function_addrs = function_addrs;
+      u->function_addrs_count = function_addrs_count;
+      u->lines = lines;
+    }
+  else
+    {
+      backtrace_atomic_store_size_t (&u->lines_count, count);
+      backtrace_atomic_store_pointer (&u->function_addrs, function_addrs);
+      backtrace_atomic_store_size_t (&u->function_addrs_count,
+				     function_addrs_count);
+      backtrace_atomic_store_pointer (&u->lines, lines);
+    }
+
+  return lines;
+}
+
 /* Look for a PC in the DWARF mapping for one module.  On success,
    call CALLBACK and return whatever it returns.  On error, call
    ERROR_CALLBACK and return 0.  Sets *FOUND to 1 if the PC is found,
@@ -2626,7 +3042,11 @@ dwarf_lookup_pc (struct backtrace_state *state, struct dwarf_data *ddata,
 		 backtrace_error_callback error_callback, void *data,
 		 int *found)
 {
-  struct unit_addrs *entry;
+  const struct pc_range *addrs;
+  size_t lo;
+  size_t hi;
+  size_t i;
+  struct unit_slot *slot;
   struct unit *u;
   int new_data;
   struct line *lines;
@@ -2640,116 +3060,92 @@ dwarf_lookup_pc (struct backtrace_state *state, struct dwarf_data *ddata,
   *found = 1;
 
   /* Find an address range that includes PC.  */
-  entry = bsearch (&pc, ddata->addrs, ddata->addrs_count,
-		   sizeof (struct unit_addrs), unit_addrs_search);
-
-  if (entry == NULL)
+  addrs = ddata->addrs;
+  lo = 0;
+  hi = ddata->addrs_count;
+  while (1)
     {
-      *found = 0;
-      return 0;
+      if (lo >= hi)
+	{
+	  *found = 0;
+	  return 0;
+	}
+      i = lo + (hi - lo) / 2;
+      if (pc < addrs[i].low)
+	hi = i;
+      else if (pc >= addrs[i].high)
+	lo = i + 1;
+      else
+	break;
     }
 
   /* If there are multiple ranges that contain PC, use the last one,
      in order to produce predictable results.  If we assume that all
      ranges are properly nested, then the last range will be the
      smallest one.  */
-  while ((size_t) (entry - ddata->addrs) + 1 < ddata->addrs_count
-	 && pc >= (entry + 1)->low
-	 && pc < (entry + 1)->high)
-    ++entry;
-
-  /* We need the lines, lines_count, function_addrs,
-     function_addrs_count fields of u.  If they are not set, we need
-     to set them.  When running in threaded mode, we need to allow for
-     the possibility that some other thread is setting them
-     simultaneously.  */
-
-  u = entry->u;
-  lines = u->lines;
+  while (i + 1 < ddata->addrs_count
+	 && pc >= addrs[i + 1].low
+	 && pc < addrs[i + 1].high)
+    ++i;
 
   /* Skip units with no useful line number information by walking
      backward.  Useless line number information is marked by setting
-     lines == -1.  */
-  while (entry > ddata->addrs
-	 && pc >= (entry - 1)->low
-	 && pc < (entry - 1)->high)
+     lines == -1; a unit that could not be read is marked by setting
+     its slot to -1.  Units that have not been read yet stop the
+     walk.  */
+  while (i > 0
+	 && pc >= addrs[i - 1].low
+	 && pc < addrs[i - 1].high)
     {
-      if (state->threaded)
-	lines = (struct line *) backtrace_atomic_load_pointer (&u->lines);
+      slot = &ddata->units[ddata->addrs_unit[i]];
+      if (!state->threaded)
+	u = slot->u;
+      else
+	u = backtrace_atomic_load_pointer (&slot->u);
 
-      if (lines != (struct line *) (uintptr_t) -1)
+      if (u == NULL)
 	break;
+      if (u != (struct unit *) (uintptr_t) -1)
+	{
+	  if (!state->threaded)
+	    lines = u->lines;
+	  else
+	    lines = backtrace_atomic_load_pointer (&u->lines);
+	  if (lines != (struct line *) (uintptr_t) -1)
+	    break;
+	}
 
-      --entry;
-
-      u = entry->u;
-      lines = u->lines;
+      --i;
     }
 
-  if (state->threaded)
-    lines = backtrace_atomic_load_pointer (&u->lines);
-
+  slot = &ddata->units[ddata->addrs_unit[i]];
   new_data = 0;
-  if (lines == NULL)
-    {
-      size_t function_addrs_count;
-      struct line_header lhdr;
-      size_t count;
-
-      /* We have never read the line information for this unit.  Read
-	 it now.  */
-
-      function_addrs = NULL;
-      function_addrs_count = 0;
-      if (read_line_info (state, ddata, error_callback, data, entry->u, &lhdr,
-			  &lines, &count))
-	{
-	  struct function_vector *pfvec;
-
-	  /* If not threaded, reuse DDATA->FVEC for better memory
-	     consumption.  */
-	  if (state->threaded)
-	    pfvec = NULL;
-	  else
-	    pfvec = &ddata->fvec;
-	  read_function_info (state, ddata, &lhdr, error_callback, data,
-			      entry->u, pfvec, &function_addrs,
-			      &function_addrs_count);
-	  free_line_header (state, &lhdr, error_callback, data);
-	  new_data = 1;
-	}
+  if (!state->threaded)
+    u = slot->u;
+  else
+    u = backtrace_atomic_load_pointer (&slot->u);
+  if (u == NULL)
+    new_data = 1;
+  u = get_unit (state, ddata, slot, error_callback, data);
 
-      /* Atomically store the information we just read into the unit.
-	 If another thread is simultaneously writing, it presumably
-	 read the same information, and we don't care which one we
-	 wind up with; we just leak the other one.  We do have to
-	 write the lines field last, so that the acquire-loads above
-	 ensure that the other fields are set.  */
+  if (u == NULL)
+    lines = (struct line *) (uintptr_t) -1;
+  else
+    {
+      int new_lines;
 
-      if (!state->threaded)
-	{
-	  u->lines_count = count;
-	  u->function_addrs = function_addrs;
-	  u->function_addrs_count = function_addrs_count;
-	  u->lines = lines;
-	}
-      else
-	{
-	  backtrace_atomic_store_size_t (&u->lines_count, count);
-	  backtrace_atomic_store_pointer (&u->function_addrs, function_addrs);
-	  backtrace_atomic_store_size_t (&u->function_addrs_count,
-					 function_addrs_count);
-	  backtrace_atomic_store_pointer (&u->lines, lines);
-	}
+      lines = get_unit_lines (state, ddata, u, error_callback, data,
+			      &new_lines);
+      new_data |= new_lines;
     }
 
   /* Now all fields of U have been initialized.  */
 
   if (lines == (struct line *) (uintptr_t) -1)
     {
-      /* If reading the line number information failed in some way,
-	 try again to see if there is a better compilation unit for
-	 this PC.  */
+      /* If reading the unit or its line number information failed in
+	 some way, try again to see if there is a better compilation
+	 unit for this PC.  */
       if (new_data)
 	return dwarf_lookup_pc (state, ddata, pc, callback, error_callback,
 				data, found);
@@ -2758,7 +3154,7 @@ dwarf_lookup_pc (struct backtrace_state *state, struct dwarf_data *ddata,
 
   /* Search for PC within this unit.  */
 
-  ln = (struct line *) bsearch (&pc, lines, entry->u->lines_count,
+  ln = (struct line *) bsearch (&pc, lines, u->lines_count,
 				sizeof (struct line), line_search);
   if (ln == NULL)
     {
@@ -2767,14 +3163,14 @@ dwarf_lookup_pc (struct backtrace_state *state, struct dwarf_data *ddata,
 	 This implies that the start of the compilation unit has no
 	 line number information.  */
 
-      if (entry->u->abs_filename == NULL)
+      if (u->abs_filename == NULL)
 	{
 	  const char *filename;
 
-	  filename = entry->u->filename;
+	  filename = u->filename;
 	  if (filename != NULL
 	      && !IS_ABSOLUTE_PATH (filename)
-	      && entry->u->comp_dir != NULL)
+	      && u->comp_dir != NULL)
 	    {
 	      size_t filename_len;
 	      const char *dir;
@@ -2782,7 +3178,7 @@ dwarf_lookup_pc (struct backtrace_state *state, struct dwarf_data *ddata,
 	      char *s;
 
 	      filename_len = strlen (filename);
-	      dir = entry->u->comp_dir;
+	      dir = u->comp_dir;
 	      dir_len = strlen (dir);
 	      s = (char *) backtrace_alloc (state, dir_len + filename_len + 2,
 					    error_callback, data);
@@ -2797,20 +3193,20 @@ dwarf_lookup_pc (struct backtrace_state *state, struct dwarf_data *ddata,
 	      memcpy (s + dir_len + 1, filename, filename_len + 1);
 	      filename = s;
 	    }
-	  entry->u->abs_filename = filename;
+	  u->abs_filename = filename;
 	}
 
-      return callback (data, pc, entry->u->abs_filename, 0, NULL);
+      return callback (data, pc, u->abs_filename, 0, NULL);
     }
 
   /* Search for function name within this unit.  */
 
-  if (entry->u->function_addrs_count == 0)
+  if (u->function_addrs_count == 0)
     return callback (data, pc, ln->filename, ln->lineno, NULL);
 
   function_addrs = ((struct function_addrs *)
-		    bsearch (&pc, entry->u->function_addrs,
-			     entry->u->function_addrs_count,
+		    bsearch (&pc, u->function_addrs,
+			     u->function_addrs_count,
 			     sizeof (struct function_addrs),
 			     function_addrs_search));
   if (function_addrs == NULL)
@@ -2819,8 +3215,8 @@ dwarf_lookup_pc (struct backtrace_state *state, struct dwarf_data *ddata,
   /* If there are multiple function ranges that contain PC, use the
      last one, in order to produce predictable results.  */
 
-  while (((size_t) (function_addrs - entry->u->function_addrs + 1)
-	  < entry->u->function_addrs_count)
+  while (((size_t) (function_addrs - u->function_addrs + 1)
+	  < u->function_addrs_count)
 	 && pc >= (function_addrs + 1)->low
 	 && pc < (function_addrs + 1)->high)
     ++function_addrs;
@@ -2904,28 +3300,68 @@ build_dwarf_data (struct backtrace_state *state,
 		  size_t dwarf_ranges_size,
 		  const unsigned char *dwarf_str,
 		  size_t dwarf_str_size,
+		  const unsigned char *dwarf_aranges,
+		  size_t dwarf_aranges_size,
 		  int is_bigendian,
 		  backtrace_error_callback error_callback,
 		  void *data)
 {
   struct unit_addrs_vector addrs_vec;
+  struct unit_slot_vector units_vec;
   struct unit_addrs *addrs;
   size_t addrs_count;
+  size_t table_size;
+  char *table;
+  struct pc_range *ranges;
+  uint32_t *ranges_unit;
+  size_t i;
   struct dwarf_data *fdata;
 
   if (!build_address_map (state, base_address, dwarf_info, dwarf_info_size,
 			  dwarf_abbrev, dwarf_abbrev_size, dwarf_ranges,
 			  dwarf_ranges_size, dwarf_str, dwarf_str_size,
-			  is_bigendian, error_callback, data, &addrs_vec))
+			  dwarf_aranges, dwarf_aranges_size, is_bigendian,
+			  error_callback, data, &addrs_vec, &units_vec))
     return NULL;
 
-  if (!backtrace_vector_release (state, &addrs_vec.vec, error_callback, data))
-    return NULL;
+  if (units_vec.count > (uint32_t) -1)
+    {
+      error_callback (data, "too many DWARF compilation units", 0);
+      goto fail;
+    }
+
+  if (!backtrace_vector_release (state, &units_vec.vec, error_callback, data))
+    goto fail;
+
   addrs = (struct unit_addrs *) addrs_vec.vec.base;
   addrs_count = addrs_vec.count;
   backtrace_qsort (addrs, addrs_count, sizeof (struct unit_addrs),
 		   unit_addrs_compare);
 
+  /* Copy the sorted ranges into a single block holding the PC range
+     table followed by the unit index table.  */
+  table_size = addrs_count * (sizeof (struct pc_range) + sizeof (uint32_t));
+  table = NULL;
+  if (table_size > 0)
+    {
+      table = (char *) backtrace_alloc (state, table_size, error_callback,
+					data);
+      if (table == NULL)
+	goto fail;
+    }
+  ranges = (struct pc_range *) table;
+  ranges_unit = (uint32_t *) (table + addrs_count * sizeof (struct pc_range));
+  for (i = 0; i < addrs_count; ++i)
+    {
+      ranges[i].low = addrs[i].low;
+      ranges[i].high = addrs[i].high;
+      ranges_unit[i] = addrs[i].unit;
+    }
+  if (addrs_vec.vec.base != NULL)
+    backtrace_free (state, addrs_vec.vec.base,
+		    addrs_vec.vec.size + addrs_vec.vec.alc,
+		    error_callback, data);
+
   fdata = ((struct dwarf_data *)
 	   backtrace_alloc (state, sizeof (struct dwarf_data),
 			    error_callback, data));
@@ -2934,12 +3370,17 @@ build_dwarf_data (struct backtrace_state *state,
 
   fdata->next = NULL;
   fdata->base_address = base_address;
-  fdata->addrs = addrs;
+  fdata->addrs = ranges;
+  fdata->addrs_unit = ranges_unit;
   fdata->addrs_count = addrs_count;
+  fdata->units = (struct unit_slot *) units_vec.vec.base;
+  fdata->units_count = units_vec.count;
   fdata->dwarf_info = dwarf_info;
   fdata->dwarf_info_size = dwarf_info_size;
   fdata->dwarf_line = dwarf_line;
   fdata->dwarf_line_size = dwarf_line_size;
+  fdata->dwarf_abbrev = dwarf_abbrev;
+  fdata->dwarf_abbrev_size = dwarf_abbrev_size;
   fdata->dwarf_ranges = dwarf_ranges;
   fdata->dwarf_ranges_size = dwarf_ranges_size;
   fdata->dwarf_str = dwarf_str;
@@ -2948,6 +3389,10 @@ build_dwarf_data (struct backtrace_state *state,
   memset (&fdata->fvec, 0, sizeof fdata->fvec);
 
   return fdata;
+
+ fail:
+  free_unit_slot_vector (state, &units_vec, error_callback, data);
+  return NULL;
 }
 
 /* Build our data structures from the DWARF sections for a module.
@@ -2967,6 +3412,8 @@ backtrace_dwarf_add (struct backtrace_state *state,
 		     size_t dwarf_ranges_size,
 		     const unsigned char *dwarf_str,
 		     size_t dwarf_str_size,
+		     const unsigned char *dwarf_aranges,
+		     size_t dwarf_aranges_size,
 		     int is_bigendian,
 		     backtrace_error_callback error_callback,
 		     void *data, fileline *fileline_fn)
@@ -2976,7 +3423,8 @@ backtrace_dwarf_add (struct backtrace_state *state,
   fdata = build_dwarf_data (state, base_address, dwarf_info, dwarf_info_size,
 			    dwarf_line, dwarf_line_size, dwarf_abbrev,
 			    dwarf_abbrev_size, dwarf_ranges, dwarf_ranges_size,
-			    dwarf_str, dwarf_str_size, is_bigendian,
+			    dwarf_str, dwarf_str_size, dwarf_aranges,
+			    dwarf_aranges_size, is_bigendian,
 			    error_callback, data);
   if (fdata == NULL)
     return 0;
@@ -3020,3 +3468,61 @@ backtrace_dwarf_add (struct backtrace_state *state,
 
   return 1;
 }
+
+/* Read the units and the file/line information for part PART of
+   PARTS of the DWARF modules of STATE.  Unit I belongs to part I %
+   PARTS, so that when the parts are read by different threads the
+   units are spread evenly over the threads.  */
+
+int
+backtrace_dwarf_prewarm (struct backtrace_state *state, int part, int parts,
+			 backtrace_error_callback error_callback, void *data)
+{
+  struct backtrace_state local;
+  struct dwarf_data *ddata;
+
+  if (parts <= 0 || part < 0 || part >= parts)
+    {
+      error_callback (data, "invalid prewarm part", 0);
+      return 0;
+    }
+
+  /* Allocate from a private copy of STATE, so that threads reading
+     other parts do not compete for the allocation lock.  LOCAL is
+     only used for allocation and to know whether we are threaded; the
+     data we read is published in DDATA as usual.  */
+  local = *state;
+  local.lock_alloc = 0;
+  local.freelist = NULL;
+
+  if (!state->threaded)
+    ddata = (struct dwarf_data *) state->fileline_data;
+  else
+    ddata = backtrace_atomic_load_pointer (&state->fileline_data);
+
+  while (ddata != NULL)
+    {
+      size_t i;
+
+      for (i = (size_t) part; i < ddata->units_count; i += (size_t) parts)
+	{
+	  struct unit *u;
+	  int new_data;
+
+	  u = get_unit (&local, ddata, &ddata->units[i], error_callback,
+			data);
+	  if (u != NULL)
+	    get_unit_lines (&local, ddata, u, error_callback, data,
+			    &new_data);
+	}
+
+      if (!state->threaded)
+	ddata = ddata->next;
+      else
+	ddata = backtrace_atomic_load_pointer (&ddata->next);
+    }
+
+  backtrace_merge_freelist (state, &local);
+
+  return 1;
+}
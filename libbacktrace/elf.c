@@ -233,6 +233,7 @@ enum debug_section
   DEBUG_ABBREV,
   DEBUG_RANGES,
   DEBUG_STR,
+  DEBUG_ARANGES,
   DEBUG_MAX
 };
 
@@ -244,7 +245,8 @@ static const char * const debug_section_names[DEBUG_MAX] =
   ".debug_line",
   ".debug_abbrev",
   ".debug_ranges",
-  ".debug_str"
+  ".debug_str",
+  ".debug_aranges"
 };
 
 /* Information we gather for the sections we care about.  */
@@ -826,6 +828,8 @@ elf_add (struct backtrace_state *state, int descriptor, uintptr_t base_address,
 			    sections[DEBUG_RANGES].size,
 			    sections[DEBUG_STR].data,
 			    sections[DEBUG_STR].size,
+			    sections[DEBUG_ARANGES].data,
+			    sections[DEBUG_ARANGES].size,
 			    ehdr.e_ident[EI_DATA] == ELFDATA2MSB,
 			    error_callback, data, fileline_fn))
     goto fail;
@@ -176,6 +176,21 @@ backtrace_pcinfo (struct backtrace_state *state, uintptr_t pc,
   return state->fileline_fn (state, pc, callback, error_callback, data);
 }
 
+/* Read the file/line information ahead of time.  */
+
+int
+backtrace_pcinfo_prewarm (struct backtrace_state *state, int part, int parts,
+			  backtrace_error_callback error_callback, void *data)
+{
+  if (!fileline_initialize (state, error_callback, data))
+    return 0;
+
+  if (state->fileline_initialization_failed)
+    return 0;
+
+  return backtrace_dwarf_prewarm (state, part, parts, error_callback, data);
+}
+
 /* Given a PC, find the symbol for it, and its value.  */
 
 int
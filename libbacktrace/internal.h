@@ -214,6 +214,13 @@ extern void backtrace_free (struct backtrace_state *state, void *mem,
 			    backtrace_error_callback error_callback,
 			    void *data);
 
+/* Give the memory on the freelist of FROM back to STATE.  FROM is a
+   copy of STATE that one thread has been allocating from, so that it
+   does not compete for the allocation lock with other threads.  */
+
+extern void backtrace_merge_freelist (struct backtrace_state *state,
+				      struct backtrace_state *from);
+
 /* A growable vector of some struct.  This is used for more efficient
    allocation when we don't know the final size of some group of data
    that we want to represent as an array.  */
@@ -285,8 +292,19 @@ extern int backtrace_dwarf_add (struct backtrace_state *state,
 				size_t dwarf_range_size,
 				const unsigned char *dwarf_str,
 				size_t dwarf_str_size,
+				const unsigned char *dwarf_aranges,
+				size_t dwarf_aranges_size,
 				int is_bigendian,
 				backtrace_error_callback error_callback,
 				void *data, fileline *fileline_fn);
 
+/* Read ahead of time the file/line information that the DWARF
+   modules of STATE need for part PART of PARTS.  Returns 1 on
+   success, 0 on failure.  */
+
+extern int backtrace_dwarf_prewarm (struct backtrace_state *state,
+				    int part, int parts,
+				    backtrace_error_callback error_callback,
+				    void *data);
+
 #endif
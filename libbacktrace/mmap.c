@@ -203,6 +203,40 @@ backtrace_free (struct backtrace_state *state, void *addr, size_t size,
     }
 }
 
+/* Give the freelist of FROM back to STATE.  */
+
+void
+backtrace_merge_freelist (struct backtrace_state *state,
+			  struct backtrace_state *from)
+{
+  struct backtrace_freelist_struct **pp;
+  int locked;
+
+  if (from->freelist == NULL)
+    return;
+
+  /* As in backtrace_free, if we can't acquire the lock we just leak
+     the memory.  */
+
+  if (!state->threaded)
+    locked = 1;
+  else
+    locked = __sync_lock_test_and_set (&state->lock_alloc, 1) == 0;
+
+  if (locked)
+    {
+      for (pp = &from->freelist; *pp != NULL; pp = &(*pp)->next)
+	;
+      *pp = state->freelist;
+      state->freelist = from->freelist;
+
+      if (state->threaded)
+	__sync_lock_release (&state->lock_alloc);
+    }
+
+  from->freelist = NULL;
+}
+
 /* Grow VEC by SIZE bytes.  */
 
 void *
@@ -1771,6 +1771,14 @@ _cpp_convert_input (cpp_reader *pfile, const char *input_charset,
   return buffer;
 }
 
+/* Return true if _cpp_convert_input uses input in INPUT_CHARSET as is,
+   without converting it into a new buffer.  */
+bool
+_cpp_input_conversion_noop_p (const char *input_charset)
+{
+  return !strcasecmp (SOURCE_CHARSET, input_charset);
+}
+
 /* Decide on the default encoding to assume for input files.  */
 const char *
 _cpp_default_encoding (void)
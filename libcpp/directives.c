@@ -2559,6 +2559,7 @@ _cpp_pop_buffer (cpp_reader *pfile)
   struct _cpp_file *inc = buffer->file;
   struct if_stack *ifs;
   const unsigned char *to_free;
+  size_t to_free_mapped;
 
   /* Walk back up the conditional stack till we reach its level at
      entry to this file, issuing error messages.  */
@@ -2573,6 +2574,7 @@ _cpp_pop_buffer (cpp_reader *pfile)
   pfile->buffer = buffer->prev;
 
   to_free = buffer->to_free;
+  to_free_mapped = buffer->to_free_mapped;
   free (buffer->notes);
 
   /* Free the buffer object now; we may want to push a new buffer
@@ -2581,7 +2583,7 @@ _cpp_pop_buffer (cpp_reader *pfile)
 
   if (inc)
     {
-      _cpp_pop_file_buffer (pfile, inc, to_free);
+      _cpp_pop_file_buffer (pfile, inc, to_free, to_free_mapped);
 
       _cpp_do_file_change (pfile, LC_LEAVE, 0, 0, 0);
     }
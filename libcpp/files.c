@@ -48,6 +48,17 @@ along with this program; see the file COPYING3.  If not see
 #  define set_stdin_to_binary_mode() /* Nothing */
 #endif
 
+#if defined (HAVE_SYS_MMAN_H) && defined (HAVE_MMAP)
+# include <sys/mman.h>
+# if defined (MAP_PRIVATE) && defined (_SC_PAGESIZE)
+#  define MMAP_FILE_IO 1
+# endif
+#endif
+
+/* Files smaller than this are read rather than mapped; for them the
+   cost of setting up and tearing down a mapping exceeds the copy.  */
+#define MMAP_THRESHOLD (16 * 1024)
+
 /* This structure represents a file searched for by CPP, whether it
    exists or not.  An instance may be pointed to by more than one
    file_hash_entry; at present no reference count is kept.  */
@@ -76,6 +87,10 @@ struct _cpp_file
      BUFFER; when freeing, this this pointer must be used instead.  */
   const uchar *buffer_start;
 
+  /* If nonzero, BUFFER_START is a private mapping of the file of this
+     many bytes rather than malloced memory.  */
+  size_t mapped_size;
+
   /* The macro, if any, preventing re-inclusion.  */
   const cpp_hashnode *cmacro;
 
@@ -640,6 +655,66 @@ _cpp_find_file (cpp_reader *pfile, const char *fname, cpp_dir *start_dir,
   return file;
 }
 
+/* Release the contents of a file starting at START, as set up by
+   read_file_guts.  MAPPED_SIZE is the size of the mapping if the file
+   was mapped rather than read into malloced memory, otherwise zero.  */
+static void
+free_file_buffer (const uchar *start, size_t mapped_size ATTRIBUTE_UNUSED)
+{
+#if MMAP_FILE_IO
+  if (mapped_size)
+    {
+      munmap ((void *) start, mapped_size);
+      return;
+    }
+#endif
+  free ((void *) start);
+}
+
+#if MMAP_FILE_IO
+/* Try to map the SIZE bytes of the regular file FILE instead of reading
+   them into a buffer, and set up FILE->buffer as read_file_guts would.
+   The mapping is private and writable since the lexer cleans lines in
+   place, but pages it does not write stay shared with the page cache,
+   and so with every other compiler reading the same header.
+
+   This requires the file to need no charset conversion, and the last
+   page of the mapping to have room for the newline and padding that
+   _cpp_convert_input appends past the end of the file; the kernel
+   zero-fills that part of the page.  Return true on success.  */
+static bool
+map_file (cpp_reader *pfile, _cpp_file *file, size_t size)
+{
+  static size_t pagesize;
+  void *map;
+
+  if (size < MMAP_THRESHOLD
+      || !STAT_SIZE_RELIABLE (file->st)
+      || !_cpp_input_conversion_noop_p (CPP_OPTION (pfile, input_charset)))
+    return false;
+
+  if (!pagesize)
+    pagesize = sysconf (_SC_PAGESIZE);
+  if (size % pagesize == 0 || pagesize - size % pagesize < 16)
+    return false;
+
+  map = mmap (NULL, size + 16, PROT_READ | PROT_WRITE, MAP_PRIVATE,
+	      file->fd, 0);
+  if (map == MAP_FAILED)
+    return false;
+
+  file->buffer = _cpp_convert_input (pfile,
+				     CPP_OPTION (pfile, input_charset),
+				     (uchar *) map, size + 16, size,
+				     &file->buffer_start,
+				     &file->st.st_size);
+  file->mapped_size = size + 16;
+  file->buffer_valid = true;
+
+  return true;
+}
+#endif
+
 /* Read a file into FILE->buffer, returning true on success.
 
    If FILE->fd is something weird, like a block device, we don't want
@@ -679,6 +754,11 @@ read_file_guts (cpp_reader *pfile, _cpp_file *file)
 	}
 
       size = file->st.st_size;
+
+#if MMAP_FILE_IO
+      if (map_file (pfile, file, size))
+	return true;
+#endif
     }
   else
     /* 8 kilobytes is a sensible starting size.  It ought to be bigger
@@ -721,6 +801,7 @@ read_file_guts (cpp_reader *pfile, _cpp_file *file)
 				     buf, size + 16, total,
 				     &file->buffer_start,
 				     &file->st.st_size);
+  file->mapped_size = 0;
   file->buffer_valid = true;
 
   return true;
@@ -895,6 +976,7 @@ _cpp_stack_file (cpp_reader *pfile, _cpp_file *file, bool import)
   buffer->file = file;
   buffer->sysp = sysp;
   buffer->to_free = file->buffer_start;
+  buffer->to_free_mapped = file->mapped_size;
 
   /* Initialize controlling macro state.  */
   pfile->mi_valid = true;
@@ -1080,7 +1162,7 @@ make_cpp_file (cpp_reader *pfile, cpp_dir *dir, const char *fname)
 static void
 destroy_cpp_file (_cpp_file *file)
 {
-  free ((void *) file->buffer_start);
+  free_file_buffer (file->buffer_start, file->mapped_size);
   free ((void *) file->name);
   free (file);
 }
@@ -1445,7 +1527,7 @@ cpp_push_default_include (cpp_reader *pfile, const char *fname)
    input stack.  */
 void
 _cpp_pop_file_buffer (cpp_reader *pfile, _cpp_file *file,
-		      const unsigned char *to_free)
+		      const unsigned char *to_free, size_t to_free_mapped)
 {
   /* Record the inclusion-preventing macro, which could be NULL
      meaning no controlling macro.  */
@@ -1460,10 +1542,11 @@ _cpp_pop_file_buffer (cpp_reader *pfile, _cpp_file *file,
       if (to_free == file->buffer_start)
 	{
 	  file->buffer_start = NULL;
+	  file->mapped_size = 0;
 	  file->buffer = NULL;
 	  file->buffer_valid = false;
 	}
-      free ((void *) to_free);
+      free_file_buffer (to_free, to_free_mapped);
     }
 }
 
@@ -202,6 +202,21 @@ extern void __gcov_time_profiler (gcov_type *);
 extern void __gcov_average_profiler (gcov_type *, gcov_type);
 extern void __gcov_ior_profiler (gcov_type *, gcov_type);
 
+/* The profiler functions for -fprofile-update=atomic.  */
+extern void __gcov_interval_profiler_atomic (gcov_type *, gcov_type, int,
+					     unsigned);
+extern void __gcov_pow2_profiler_atomic (gcov_type *, gcov_type);
+extern void __gcov_one_value_profiler_atomic (gcov_type *, gcov_type);
+extern void __gcov_indirect_call_profiler_atomic (gcov_type*, gcov_type,
+						  void*, void*);
+extern void __gcov_indirect_call_profiler_v2_atomic (gcov_type, void *);
+extern void __gcov_time_profiler_atomic (gcov_type *);
+extern void __gcov_average_profiler_atomic (gcov_type *, gcov_type);
+extern void __gcov_ior_profiler_atomic (gcov_type *, gcov_type);
+
+/* The number of functions visited so far, for the time profilers.  */
+extern gcov_type __gcov_time_profiler_counter ATTRIBUTE_HIDDEN;
+
 #ifndef inhibit_libc
 /* The wrappers around some library functions..  */
 extern pid_t __gcov_fork (void) ATTRIBUTE_HIDDEN;
@@ -78,6 +78,7 @@
 #if defined(USE_PT_GNU_EH_FRAME)
 
 #include <link.h>
+#include <dlfcn.h>
 
 #ifndef __RELOC_POINTER
 # define __RELOC_POINTER(ptr, base) ((ptr) + (base))
@@ -150,6 +151,9 @@ base_from_cb_data (unsigned char encoding, struct unw_eh_callback_data *data)
     }
 }
 
+static int find_fde_tail (const struct unw_eh_frame_hdr *,
+			  struct unw_eh_callback_data *);
+
 static int
 _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
 {
@@ -161,10 +165,7 @@ _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
 #else
   _Unwind_Ptr load_base;
 #endif
-  const unsigned char *p;
   const struct unw_eh_frame_hdr *hdr;
-  _Unwind_Ptr eh_frame;
-  struct object ob;
   _Unwind_Ptr pc_low = 0, pc_high = 0;
 
   struct ext_dl_phdr_info
@@ -311,11 +312,8 @@ _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
   if (!p_eh_frame_hdr)
     return 0;
 
-  /* Read .eh_frame_hdr header.  */
   hdr = (const struct unw_eh_frame_hdr *)
     __RELOC_POINTER (p_eh_frame_hdr->p_vaddr, load_base);
-  if (hdr->version != 1)
-    return 1;
 
 #ifdef CRT_GET_RFIB_DATA
 # ifdef __i386__
@@ -350,6 +348,26 @@ _Unwind_IteratePhdrCallback (struct dl_phdr_info *info, size_t size, void *ptr)
 # endif
 #endif
 
+  return find_fde_tail (hdr, data);
+}
+
+/* Look up DATA->pc in the object whose .eh_frame_hdr is HDR, storing
+   the FDE found, if any, in DATA->ret and the start of the function it
+   describes in DATA->func.  DATA->tbase and DATA->dbase must have been
+   set up already.  */
+
+static int
+find_fde_tail (const struct unw_eh_frame_hdr *hdr,
+	       struct unw_eh_callback_data *data)
+{
+  const unsigned char *p;
+  _Unwind_Ptr eh_frame;
+  struct object ob;
+
+  /* Read .eh_frame_hdr header.  */
+  if (hdr->version != 1)
+    return 1;
+
   p = read_encoded_value_with_base (hdr->eh_frame_ptr_enc,
 				    base_from_cb_data (hdr->eh_frame_ptr_enc,
 						       data),
@@ -458,6 +476,30 @@ _Unwind_Find_FDE (void *pc, struct dwarf_eh_bases *bases)
   data.ret = NULL;
   data.check_cache = 1;
 
+#ifdef DLFO_STRUCT_HAS_EH_DBASE
+  /* _dl_find_object does not take the loader lock, nor does it need
+     our cache of recently used objects, so throwing exceptions from
+     many threads at once doesn't serialize on either.  */
+  {
+    struct dl_find_object dlfo;
+
+    if (_dl_find_object (pc, &dlfo) != 0 || dlfo.dlfo_eh_frame == NULL)
+      return NULL;
+# if DLFO_STRUCT_HAS_EH_DBASE
+    data.dbase = dlfo.dlfo_eh_dbase;
+# endif
+    find_fde_tail ((const struct unw_eh_frame_hdr *) dlfo.dlfo_eh_frame,
+		   &data);
+    if (data.ret)
+      {
+	bases->tbase = data.tbase;
+	bases->dbase = data.dbase;
+	bases->func = data.func;
+      }
+    return data.ret;
+  }
+#endif
+
   if (dl_iterate_phdr (_Unwind_IteratePhdrCallback, &data) < 0)
     return NULL;
 
@@ -0,0 +1,623 @@
+/* Copyright (C) 2014 Free Software Foundation, Inc.
+
+This file is part of the GNU Fortran runtime library (libgfortran).
+
+Libgfortran is free software; you can redistribute it and/or modify
+it under the terms of the GNU General Public License as published by
+the Free Software Foundation; either version 3, or (at your option)
+any later version.
+
+Libgfortran is distributed in the hope that it will be useful,
+but WITHOUT ANY WARRANTY; without even the implied warranty of
+MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+GNU General Public License for more details.
+
+Under Section 7 of GPL version 3, you are granted additional
+permissions described in the GCC Runtime Library Exception, version
+3.1, as published by the Free Software Foundation.
+
+You should have received a copy of the GNU General Public License and
+a copy of the GCC Runtime Library Exception along with this program;
+see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+<http://www.gnu.org/licenses/>.  */
+
+/* Asynchronous data transfers.
+
+   An unformatted data transfer statement with ASYNCHRONOUS='yes' on an
+   external unit opened with ASYNCHRONOUS='yes' is not executed by the
+   thread running it.  The statement and its data items are recorded
+   instead and queued on the unit's async_unit, whose thread replays
+   the queued statements in order through st_read and st_write.
+
+   The data items are transferred in place when the compiler has set
+   IOPARM_DT_ASYNC_VARS, which it does when all of them are variables;
+   the program must not touch these until the transfer is complete, as
+   the standard requires.  Other items of a WRITE statement are copied
+   when the statement is queued, and a READ statement with such items
+   is executed synchronously, as is any other data transfer statement.
+
+   Every queued statement gets an ID, counting from 1 on each unit.
+   The first error of the queued statements is reported by the next
+   WAIT statement for it, or by the next statement on the unit, which
+   waits for all pending statements of the unit before it starts.  */
+
+#include "io.h"
+#include <string.h>
+#include <stdlib.h>
+#include <errno.h>
+
+#if defined(__GTHREADS_CXX0X) && defined(__GTHREAD_HAS_COND) \
+    && defined(__GTHREAD_MUTEX_INIT) && defined(__GTHREAD_COND_INIT)
+# define ASYNC_IO 1
+#endif
+
+/* Flags of a data transfer statement that can be queued.  */
+#define ASYNC_DT_FLAGS \
+  (IOPARM_COMMON_MASK | IOPARM_DT_HAS_REC | IOPARM_DT_HAS_POS \
+   | IOPARM_DT_HAS_ID | IOPARM_DT_HAS_ASYNCHRONOUS | IOPARM_DT_ASYNC_VARS)
+
+/* Length of the saved message of a failed statement.  */
+#define ASYNC_MSG_LEN 256
+
+#ifdef ASYNC_IO
+
+/* A data item of a queued statement, with the arguments of the
+   transfer function.  */
+
+struct async_item
+{
+  bt type;
+  int kind;
+  size_t size;
+  size_t nelems;
+  void *data;
+  /* Nonzero if DATA is a copy owned by the statement.  */
+  int copied;
+};
+
+/* A queued data transfer statement.  */
+
+struct async_stmt
+{
+  struct async_stmt *next;
+  struct async_unit *au;
+  GFC_INTEGER_4 id;
+  int read_flag;
+  /* Whether the data of a WRITE is copied.  */
+  int copy;
+
+  /* Parameters of the statement.  */
+  GFC_INTEGER_4 flags;
+  GFC_INTEGER_4 unit;
+  const char *filename;
+  GFC_INTEGER_4 line;
+  GFC_IO_INT rec;
+  GFC_IO_INT pos;
+
+  struct async_item *items;
+  size_t nitems;
+  size_t items_size;
+};
+
+/* The queue of a unit and the thread running it.  The fields below
+   THREAD are guarded by LOCK.  */
+
+struct async_unit
+{
+  struct async_unit *next;
+  int unit_number;
+  __gthread_t thread;
+
+  __gthread_mutex_t lock;
+  /* Signaled when a statement is queued or the thread must exit.  */
+  __gthread_cond_t work;
+  /* Broadcast when a statement is complete.  */
+  __gthread_cond_t done;
+  struct async_stmt *head, *tail;
+  /* IDs of the last statement queued and the last one completed.  */
+  GFC_INTEGER_4 last_id, done_id;
+  int shutdown;
+
+  /* First error of the queued statements not reported yet: the ID of
+     the statement, its IOPARM_LIBRETURN_* code, its IOSTAT value and
+     its message.  */
+  GFC_INTEGER_4 err_id;
+  int err_return;
+  GFC_INTEGER_4 err_iostat;
+  char err_msg[ASYNC_MSG_LEN + 1];
+};
+
+/* List of the units with a queue, for async_drain_all, and its
+   length.  */
+static struct async_unit *async_units;
+static int async_count;
+static __gthread_mutex_t async_lock = __GTHREAD_MUTEX_INIT;
+
+
+/* Replay statement S on the unit's thread, and record its error, if
+   any, in AU.  */
+
+static void
+async_run (struct async_unit *au, struct async_stmt *s)
+{
+  st_parameter_dt dt;
+  GFC_INTEGER_4 iostat = 0;
+  char msg[ASYNC_MSG_LEN];
+  size_t i;
+
+  memset (&dt, 0, sizeof (dt));
+  dt.common.flags = s->flags | IOPARM_HAS_IOSTAT | IOPARM_HAS_IOMSG;
+  dt.common.unit = s->unit;
+  dt.common.filename = s->filename;
+  dt.common.line = s->line;
+  dt.common.iostat = &iostat;
+  dt.common.iomsg = msg;
+  dt.common.iomsg_len = sizeof (msg);
+  dt.rec = s->rec;
+  dt.pos = s->pos;
+
+  if (s->read_flag)
+    st_read (&dt);
+  else
+    st_write (&dt);
+
+  for (i = 0; i < s->nitems; i++)
+    {
+      struct async_item *it = &s->items[i];
+
+      if ((dt.common.flags & IOPARM_LIBRETURN_MASK) != IOPARM_LIBRETURN_OK)
+	break;
+      dt.u.p.transfer (&dt, it->type, it->data, it->kind, it->size,
+		       it->nelems);
+    }
+
+  if (s->read_flag)
+    st_read_done (&dt);
+  else
+    st_write_done (&dt);
+
+  if ((dt.common.flags & IOPARM_LIBRETURN_MASK) != IOPARM_LIBRETURN_OK)
+    {
+      __gthread_mutex_lock (&au->lock);
+      if (au->err_id == 0)
+	{
+	  gfc_charlen_type len = fstrlen (msg, sizeof (msg));
+
+	  au->err_id = s->id;
+	  au->err_return = dt.common.flags & IOPARM_LIBRETURN_MASK;
+	  au->err_iostat = iostat;
+	  memcpy (au->err_msg, msg, len);
+	  au->err_msg[len] = '\0';
+	}
+      __gthread_mutex_unlock (&au->lock);
+    }
+}
+
+
+static void
+free_stmt (struct async_stmt *s)
+{
+  size_t i;
+
+  for (i = 0; i < s->nitems; i++)
+    if (s->items[i].copied)
+      free (s->items[i].data);
+  free (s->items);
+  free (s);
+}
+
+
+/* Thread running the queue of AU.  Statements queued after one that
+   failed are dropped until the error has been reported.  */
+
+static void *
+async_thread (void *arg)
+{
+  struct async_unit *au = arg;
+  struct async_stmt *s;
+  int failed;
+
+  __gthread_mutex_lock (&au->lock);
+  for (;;)
+    {
+      while (au->head == NULL && !au->shutdown)
+	__gthread_cond_wait (&au->work, &au->lock);
+      s = au->head;
+      if (s == NULL)
+	break;
+      failed = au->err_id != 0;
+      __gthread_mutex_unlock (&au->lock);
+
+      if (!failed)
+	async_run (au, s);
+
+      __gthread_mutex_lock (&au->lock);
+      au->head = s->next;
+      if (au->head == NULL)
+	au->tail = NULL;
+      au->done_id = s->id;
+      __gthread_cond_broadcast (&au->done);
+      free_stmt (s);
+    }
+  __gthread_mutex_unlock (&au->lock);
+
+  return NULL;
+}
+
+
+/* Start the queue of unit N.  Called with UNIT_LOCK held by
+   find_async_unit.  Returns NULL if the thread cannot be created, in
+   which case the unit's statements are executed synchronously.  */
+
+struct async_unit *
+async_start (int n)
+{
+  struct async_unit *au;
+
+  if (!__gthread_active_p ())
+    return NULL;
+
+  au = xcalloc (1, sizeof (struct async_unit));
+  au->unit_number = n;
+  {
+    __gthread_mutex_t tmp = __GTHREAD_MUTEX_INIT;
+    au->lock = tmp;
+  }
+  {
+    __gthread_cond_t tmp = __GTHREAD_COND_INIT;
+    au->work = tmp;
+    au->done = tmp;
+  }
+
+  if (__gthread_create (&au->thread, async_thread, au) != 0)
+    {
+      free (au);
+      return NULL;
+    }
+
+  __gthread_mutex_lock (&async_lock);
+  au->next = async_units;
+  async_units = au;
+  __atomic_add_fetch (&async_count, 1, __ATOMIC_RELEASE);
+  __gthread_mutex_unlock (&async_lock);
+
+  return au;
+}
+
+
+/* Wait until the statements of AU up to ID, or all of them if ID is
+   GFC_INTEGER_4_HUGE, are complete, and report the first error among
+   them to CMP unless it is NULL.  */
+
+static void
+async_wait (st_parameter_common *cmp, struct async_unit *au,
+	    GFC_INTEGER_4 id)
+{
+  int ret;
+  GFC_INTEGER_4 iostat = 0;
+  char msg[ASYNC_MSG_LEN + 1];
+
+  /* Statements the unit's thread replays must not wait for themselves.  */
+  if (__gthread_equal (__gthread_self (), au->thread))
+    return;
+
+  __gthread_mutex_lock (&au->lock);
+  if (id > au->last_id)
+    id = au->last_id;
+  while (au->done_id < id)
+    __gthread_cond_wait (&au->done, &au->lock);
+
+  ret = IOPARM_LIBRETURN_OK;
+  if (au->err_id != 0 && au->err_id <= id)
+    {
+      ret = au->err_return;
+      iostat = au->err_iostat;
+      strcpy (msg, au->err_msg);
+      au->err_id = 0;
+    }
+  __gthread_mutex_unlock (&au->lock);
+
+  if (cmp == NULL)
+    return;
+
+  switch (ret)
+    {
+    case IOPARM_LIBRETURN_OK:
+      break;
+
+    case IOPARM_LIBRETURN_END:
+      generate_error (cmp, LIBERROR_END, msg);
+      break;
+
+    case IOPARM_LIBRETURN_EOR:
+      generate_error (cmp, LIBERROR_EOR, msg);
+      break;
+
+    default:
+      /* generate_error stores errno as the IOSTAT of LIBERROR_OS.  */
+      if (iostat > 0 && iostat < LIBERROR_OS)
+	{
+	  errno = iostat;
+	  generate_error (cmp, LIBERROR_OS, msg);
+	}
+      else
+	generate_error (cmp, iostat, msg);
+      break;
+    }
+}
+
+
+/* Stop the thread of AU and free it, once its statements are complete.
+   Called by close_unit_1, with the unit's lock held.  */
+
+void
+async_close (struct async_unit *au)
+{
+  struct async_unit **p;
+
+  async_wait (NULL, au, GFC_INTEGER_4_HUGE);
+
+  __gthread_mutex_lock (&au->lock);
+  au->shutdown = 1;
+  __gthread_cond_signal (&au->work);
+  __gthread_mutex_unlock (&au->lock);
+  __gthread_join (au->thread, NULL);
+
+  __gthread_mutex_lock (&async_lock);
+  for (p = &async_units; *p != au; p = &(*p)->next)
+    ;
+  *p = au->next;
+  __atomic_sub_fetch (&async_count, 1, __ATOMIC_RELEASE);
+  __gthread_mutex_unlock (&async_lock);
+
+  __gthread_mutex_destroy (&au->lock);
+  __gthread_cond_destroy (&au->work);
+  __gthread_cond_destroy (&au->done);
+  free (au);
+}
+
+
+/* Wait for all pending statements of unit N and report their first
+   error to CMP.  Called before any statement on N, other than a queued
+   data transfer, takes the unit's lock.  */
+
+void
+async_wait_unit (st_parameter_common *cmp, int n)
+{
+  struct async_unit *au;
+
+  if (__atomic_load_n (&async_count, __ATOMIC_ACQUIRE) == 0)
+    return;
+
+  au = find_async_unit (n, 0);
+  if (au != NULL)
+    async_wait (cmp, au, GFC_INTEGER_4_HUGE);
+}
+
+
+/* Wait for the pending statements of all units, before they are closed
+   when the program ends.  Errors are not reported any more.  */
+
+void
+async_drain_all (void)
+{
+  struct async_unit *au;
+
+  if (__atomic_load_n (&async_count, __ATOMIC_ACQUIRE) == 0)
+    return;
+
+  __gthread_mutex_lock (&async_lock);
+  for (au = async_units; au != NULL; au = au->next)
+    async_wait (NULL, au, GFC_INTEGER_4_HUGE);
+  __gthread_mutex_unlock (&async_lock);
+}
+
+
+/* Transfer function recording a data item of a queued statement.  */
+
+static void
+async_transfer (st_parameter_dt *dtp, bt type, void *data, int kind,
+		size_t size, size_t nelems)
+{
+  struct async_stmt *s = dtp->u.p.async_stmt;
+  struct async_item *it;
+  size_t bytes;
+
+  if (s->nitems == s->items_size)
+    {
+      s->items_size = s->items_size ? 2 * s->items_size : 8;
+      s->items = realloc (s->items, s->items_size * sizeof (*s->items));
+      if (s->items == NULL)
+	os_error ("Memory allocation failed");
+    }
+
+  it = &s->items[s->nitems++];
+  it->type = type;
+  it->kind = kind;
+  it->size = size;
+  it->nelems = nelems;
+  it->data = data;
+  it->copied = 0;
+
+  bytes = (type == BT_CHARACTER ? size * GFC_SIZE_OF_CHAR_KIND (kind) : size)
+	  * nelems;
+  if (s->copy && bytes > 0)
+    {
+      it->data = xmalloc (bytes);
+      memcpy (it->data, data, bytes);
+      it->copied = 1;
+    }
+}
+
+
+/* Set up DTP, an ASYNCHRONOUS='yes' data transfer statement, to be
+   queued.  Called by data_transfer_init before the unit is locked;
+   returns zero if the statement must be executed synchronously.  */
+
+int
+async_transfer_init (st_parameter_dt *dtp, int read_flag)
+{
+  GFC_INTEGER_4 cf = dtp->common.flags;
+  struct async_unit *au;
+  struct async_stmt *s;
+
+  if ((cf & ~ASYNC_DT_FLAGS) != 0
+      || (read_flag && (cf & IOPARM_DT_ASYNC_VARS) == 0))
+    return 0;
+
+  au = find_async_unit (dtp->common.unit, 1);
+  if (au == NULL)
+    return 0;
+
+  s = xcalloc (1, sizeof (struct async_stmt));
+  s->au = au;
+  s->read_flag = read_flag;
+  s->copy = (cf & IOPARM_DT_ASYNC_VARS) == 0;
+  s->flags = cf & (IOPARM_DT_HAS_REC | IOPARM_DT_HAS_POS);
+  s->unit = dtp->common.unit;
+  s->filename = dtp->common.filename;
+  s->line = dtp->common.line;
+  s->rec = dtp->rec;
+  s->pos = dtp->pos;
+
+  dtp->u.p.async_stmt = s;
+  dtp->u.p.transfer = async_transfer;
+  return 1;
+}
+
+
+/* Queue the statement set up by async_transfer_init, and return its
+   ID in the ID= variable.  Called by st_read_done and st_write_done.  */
+
+void
+async_transfer_done (st_parameter_dt *dtp)
+{
+  struct async_stmt *s = dtp->u.p.async_stmt;
+  struct async_unit *au = s->au;
+  GFC_INTEGER_4 id;
+
+  __gthread_mutex_lock (&au->lock);
+  id = s->id = ++au->last_id;
+  if (au->tail == NULL)
+    au->head = s;
+  else
+    au->tail->next = s;
+  au->tail = s;
+  __gthread_cond_signal (&au->work);
+  __gthread_mutex_unlock (&au->lock);
+
+  if ((dtp->common.flags & IOPARM_DT_HAS_ID) != 0)
+    *dtp->id = id;
+  dtp->u.p.async_stmt = NULL;
+}
+
+
+/* Handle the PENDING= specifier of an INQUIRE statement on a unit.  If
+   the statement only asks for PENDING= and the data transfers it asks
+   about are not complete, answer it and return nonzero.  Otherwise wait
+   for them, so that the unit can be inquired about and PENDING= is
+   false, and return zero.  */
+
+int
+async_inquire (st_parameter_inquire *iqp)
+{
+  GFC_INTEGER_4 cf2, id;
+  struct async_unit *au;
+  int pending;
+
+  if (__atomic_load_n (&async_count, __ATOMIC_ACQUIRE) == 0)
+    return 0;
+
+  au = find_async_unit (iqp->common.unit, 0);
+  if (au == NULL)
+    return 0;
+
+  cf2 = (iqp->common.flags & IOPARM_INQUIRE_HAS_FLAGS2) ? iqp->flags2 : 0;
+  if ((iqp->common.flags & ~IOPARM_COMMON_MASK) == IOPARM_INQUIRE_HAS_FLAGS2
+      && (cf2 & ~(IOPARM_INQUIRE_HAS_PENDING | IOPARM_INQUIRE_HAS_ID)) == 0
+      && (cf2 & IOPARM_INQUIRE_HAS_PENDING) != 0)
+    {
+      __gthread_mutex_lock (&au->lock);
+      id = (cf2 & IOPARM_INQUIRE_HAS_ID) ? *iqp->id : au->last_id;
+      pending = au->done_id < id && id <= au->last_id;
+      __gthread_mutex_unlock (&au->lock);
+
+      if (pending)
+	{
+	  *iqp->pending = 1;
+	  return 1;
+	}
+    }
+
+  async_wait (&iqp->common, au, GFC_INTEGER_4_HUGE);
+  return 0;
+}
+
+#else /* !ASYNC_IO */
+
+struct async_unit *
+async_start (int n __attribute__ ((unused)))
+{
+  return NULL;
+}
+
+void
+async_close (struct async_unit *au __attribute__ ((unused)))
+{
+}
+
+void
+async_wait_unit (st_parameter_common *cmp __attribute__ ((unused)),
+		 int n __attribute__ ((unused)))
+{
+}
+
+void
+async_drain_all (void)
+{
+}
+
+int
+async_transfer_init (st_parameter_dt *dtp __attribute__ ((unused)),
+		     int read_flag __attribute__ ((unused)))
+{
+  return 0;
+}
+
+void
+async_transfer_done (st_parameter_dt *dtp __attribute__ ((unused)))
+{
+}
+
+int
+async_inquire (st_parameter_inquire *iqp __attribute__ ((unused)))
+{
+  return 0;
+}
+
+#endif /* ASYNC_IO */
+
+
+/* The WAIT statement.  With ID=, wait for the data transfer statement
+   with that ID on the unit and the ones queued before it, otherwise
+   for all pending data transfer statements of the unit.  */
+
+void
+st_wait (st_parameter_wait *wtp)
+{
+  library_start (&wtp->common);
+
+#ifdef ASYNC_IO
+  if (__atomic_load_n (&async_count, __ATOMIC_ACQUIRE) != 0)
+    {
+      struct async_unit *au = find_async_unit (wtp->common.unit, 0);
+
+      if (au != NULL)
+	async_wait (&wtp->common, au,
+		    (wtp->common.flags & IOPARM_WAIT_HAS_ID)
+		    ? wtp->id : GFC_INTEGER_4_HUGE);
+    }
+#endif
+
+  library_end ();
+}
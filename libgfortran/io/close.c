@@ -63,6 +63,7 @@ st_close (st_parameter_close *clp)
     return;
   }
 
+  async_wait_unit (&clp->common, clp->common.unit);
   u = find_unit (clp->common.unit);
   if (u != NULL)
     {
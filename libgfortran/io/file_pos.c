@@ -190,6 +190,7 @@ st_backspace (st_parameter_filepos *fpp)
 
   library_start (&fpp->common);
 
+  async_wait_unit (&fpp->common, fpp->common.unit);
   u = find_unit (fpp->common.unit);
   if (u == NULL)
     {
@@ -283,6 +284,7 @@ st_endfile (st_parameter_filepos *fpp)
 
   library_start (&fpp->common);
 
+  async_wait_unit (&fpp->common, fpp->common.unit);
   u = find_unit (fpp->common.unit);
   if (u != NULL)
     {
@@ -389,6 +391,7 @@ st_rewind (st_parameter_filepos *fpp)
 
   library_start (&fpp->common);
 
+  async_wait_unit (&fpp->common, fpp->common.unit);
   u = find_unit (fpp->common.unit);
   if (u != NULL)
     {
@@ -448,6 +451,7 @@ st_flush (st_parameter_filepos *fpp)
 
   library_start (&fpp->common);
 
+  async_wait_unit (&fpp->common, fpp->common.unit);
   u = find_unit (fpp->common.unit);
   if (u != NULL)
     {
@@ -282,11 +282,10 @@ inquire_via_unit (st_parameter_inquire *iqp, gfc_unit * u)
     {
       GFC_INTEGER_4 cf2 = iqp->flags2;
 
+      /* Asynchronous data transfers on the unit are complete, see
+	 async_inquire.  */
       if ((cf2 & IOPARM_INQUIRE_HAS_PENDING) != 0)
 	*iqp->pending = 0;
-  
-      if ((cf2 & IOPARM_INQUIRE_HAS_ID) != 0)
-        *iqp->id = 0;
 
       if ((cf2 & IOPARM_INQUIRE_HAS_ENCODING) != 0)
 	{
@@ -720,6 +719,11 @@ st_inquire (st_parameter_inquire *iqp)
 
   if ((iqp->common.flags & IOPARM_INQUIRE_HAS_FILE) == 0)
     {
+      if (async_inquire (iqp))
+	{
+	  library_end ();
+	  return;
+	}
       u = find_unit (iqp->common.unit);
       inquire_via_unit (iqp, u);
     }
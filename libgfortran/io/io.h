@@ -355,6 +355,7 @@ st_parameter_inquire;
 #define IOPARM_DT_HAS_ROUND			(1 << 23)
 #define IOPARM_DT_HAS_SIGN			(1 << 24)
 #define IOPARM_DT_HAS_F2003                     (1 << 25)
+#define IOPARM_DT_ASYNC_VARS			(1 << 26)
 /* Internal use bit.  */
 #define IOPARM_DT_IONML_SET			(1 << 31)
 
@@ -457,6 +458,8 @@ typedef struct st_parameter_dt
 	     largest kind.  */
 	  char value[32];
 	  GFC_IO_INT size_used;
+	  /* Statement queued by an asynchronous data transfer.  */
+	  struct async_stmt *async_stmt;
 	} p;
       /* This pad size must be equal to the pad_size declared in
 	 trans-io.c (gfc_build_io_library_fndecls).  The above structure
@@ -485,7 +488,7 @@ extern char check_st_parameter_dt[sizeof (((st_parameter_dt *) 0)->u.pad)
 typedef struct
 {
   st_parameter_common common;
-  CHARACTER1 (id);
+  GFC_INTEGER_4 id;
 }
 st_parameter_wait;
 
@@ -575,6 +578,11 @@ typedef struct gfc_unit
   
   /* Formatting buffer.  */
   struct fbuf *fbuf;
+
+  /* Queue of asynchronous data transfers, if any have been started.
+     Guarded by UNIT_LOCK rather than by the unit's lock, which the
+     queue's thread holds while it runs a data transfer.  */
+  struct async_unit *au;
 }
 gfc_unit;
 
@@ -610,6 +618,9 @@ internal_proto(find_or_create_unit);
 extern gfc_unit *get_unit (st_parameter_dt *, int);
 internal_proto(get_unit);
 
+extern struct async_unit *find_async_unit (int, int);
+internal_proto(find_async_unit);
+
 extern void unlock_unit (gfc_unit *);
 internal_proto(unlock_unit);
 
@@ -655,12 +666,47 @@ internal_proto(init_loop_spec);
 extern void next_record (st_parameter_dt *, int);
 internal_proto(next_record);
 
-extern void st_wait (st_parameter_wait *);
-export_proto(st_wait);
+extern void st_read (st_parameter_dt *);
+export_proto(st_read);
+
+extern void st_read_done (st_parameter_dt *);
+export_proto(st_read_done);
+
+extern void st_write (st_parameter_dt *);
+export_proto(st_write);
+
+extern void st_write_done (st_parameter_dt *);
+export_proto(st_write_done);
 
 extern void hit_eof (st_parameter_dt *);
 internal_proto(hit_eof);
 
+/* async.c */
+
+extern struct async_unit *async_start (int);
+internal_proto(async_start);
+
+extern void async_close (struct async_unit *);
+internal_proto(async_close);
+
+extern void async_wait_unit (st_parameter_common *, int);
+internal_proto(async_wait_unit);
+
+extern void async_drain_all (void);
+internal_proto(async_drain_all);
+
+extern int async_transfer_init (st_parameter_dt *, int);
+internal_proto(async_transfer_init);
+
+extern void async_transfer_done (st_parameter_dt *);
+internal_proto(async_transfer_done);
+
+extern int async_inquire (st_parameter_inquire *);
+internal_proto(async_inquire);
+
+extern void st_wait (st_parameter_wait *);
+export_proto(st_wait);
+
 /* read.c */
 
 extern void set_integer (void *, GFC_INTEGER_LARGEST, int);
@@ -752,6 +798,10 @@ internal_proto(write_real);
 extern void write_real_g0 (st_parameter_dt *, const char *, int, int);
 internal_proto(write_real_g0);
 
+extern bool write_run (st_parameter_dt *, const fnode *, bt, const char *,
+		       int, size_t, size_t);
+internal_proto(write_run);
+
 extern void write_x (st_parameter_dt *, int, int);
 internal_proto(write_x);
 
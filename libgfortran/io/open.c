@@ -845,6 +845,10 @@ st_open (st_parameter_open *opp)
 
   if ((opp->common.flags & IOPARM_LIBRETURN_MASK) == IOPARM_LIBRETURN_OK)
     {
+      /* Reopening a unit waits for its asynchronous data transfers.  */
+      if ((opp->common.flags & IOPARM_OPEN_HAS_NEWUNIT) == 0)
+	async_wait_unit (&opp->common, opp->common.unit);
+
       if ((opp->common.flags & IOPARM_OPEN_HAS_NEWUNIT))
 	opp->common.unit = get_unique_unit_number(opp);
       else if (opp->common.unit < 0)
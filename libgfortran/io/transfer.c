@@ -177,6 +177,12 @@ static const st_option pad_opt[] = {
   {NULL, 0}
 };
 
+static const st_option async_opt[] = {
+  {"yes", ASYNC_YES},
+  {"no", ASYNC_NO},
+  {NULL, 0}
+};
+
 typedef enum
 { FORMATTED_SEQUENTIAL, UNFORMATTED_SEQUENTIAL,
   FORMATTED_DIRECT, UNFORMATTED_DIRECT, FORMATTED_STREAM, UNFORMATTED_STREAM
@@ -1967,6 +1973,54 @@ formatted_transfer_scalar_write (st_parameter_dt *dtp, bt type, void *p, int kin
   unget_format (dtp, f);
 }
 
+/* Write as many of the NELEMS items at P as possible with the
+   repetitions of a data edit descriptor that remain, without going
+   through formatted_transfer_scalar_write for each of them, and return
+   how many were written.  After formatted_transfer_scalar_write has
+   written an item, it has also fetched and pushed back the format node
+   for the next one.  If that node is a data edit descriptor whose
+   repeat count is not yet used up, the next F->REPEAT - F->COUNT
+   fetches would return it again without any other node in between, so
+   those items can be converted in one go by write_run.  The last
+   repetition is left to formatted_transfer_scalar_write, which goes on
+   to process the rest of the format.  */
+
+static size_t
+formatted_transfer_run_write (st_parameter_dt *dtp, bt type, char *p,
+			      int kind, size_t stride, size_t nelems)
+{
+  const fnode *f;
+  size_t n;
+  int pos;
+
+  if (type != BT_INTEGER && type != BT_REAL)
+    return 0;
+
+  f = dtp->u.p.fmt->saved_format;
+  if (f == NULL || f->count >= f->repeat
+      || dtp->u.p.eor_condition || dtp->u.p.reversion_flag
+      || dtp->u.p.skips != 0
+      || (dtp->common.flags & IOPARM_LIBRETURN_MASK) != IOPARM_LIBRETURN_OK)
+    return 0;
+
+  n = f->repeat - f->count;
+  if (n > nelems)
+    n = nelems;
+
+  if (!write_run (dtp, f, type, p, kind, stride, n))
+    return 0;
+
+  /* Account for the repetitions used up, as next_format would have
+     done.  The node stays pushed back for the next item.  */
+  ((fnode *) f)->count += n;
+  dtp->u.p.item_count += n;
+
+  pos = (int)(dtp->u.p.current_unit->recl - dtp->u.p.current_unit->bytes_left);
+  dtp->u.p.max_pos = (dtp->u.p.max_pos > pos) ? dtp->u.p.max_pos : pos;
+  return n;
+}
+
+
   /* This function is first called from data_init_transfer to initiate the loop
      over each item in the format, transferring data as required.  Subsequent
      calls to this function occur for each data item foound in the READ/WRITE
@@ -1998,6 +2052,11 @@ formatted_transfer (st_parameter_dt *dtp, bt type, void *p, int kind,
       /* Big loop over all the elements.  */
       for (elem = 0; elem < nelems; elem++)
 	{
+	  if (nelems - elem > 1)
+	    elem += formatted_transfer_run_write (dtp, type, tmp + stride*elem,
+						  kind, stride, nelems - elem);
+	  if (elem == nelems)
+	    break;
 	  dtp->u.p.item_count++;
 	  formatted_transfer_scalar_write (dtp, type, tmp + stride*elem, kind, size);
 	}
@@ -2382,6 +2441,24 @@ data_transfer_init (st_parameter_dt *dtp, int read_flag)
   if ((cf & IOPARM_DT_HAS_SIZE) != 0)
     dtp->u.p.size_used = 0;  /* Initialize the count.  */
 
+  /* Queue an asynchronous data transfer if the unit allows it.  Any
+     other statement waits for the pending ones on its unit.  */
+  if ((cf & IOPARM_DT_HAS_ASYNCHRONOUS) != 0
+      && find_option (&dtp->common, dtp->asynchronous, dtp->asynchronous_len,
+		      async_opt, "Bad ASYNCHRONOUS in data transfer statement")
+	 == ASYNC_YES)
+    {
+      if (async_transfer_init (dtp, read_flag))
+	return;
+      if ((cf & IOPARM_DT_HAS_ID) != 0)
+	*dtp->id = 0;
+    }
+
+  if ((cf & IOPARM_DT_HAS_INTERNAL_UNIT) == 0)
+    async_wait_unit (&dtp->common, dtp->common.unit);
+  if ((dtp->common.flags & IOPARM_LIBRETURN_MASK) != IOPARM_LIBRETURN_OK)
+    return;
+
   dtp->u.p.current_unit = get_unit (dtp, 1);
   if (dtp->u.p.current_unit->s == NULL)
     {  /* Open the unit with some default flags.  */
@@ -3679,6 +3756,12 @@ export_proto(st_read_done);
 void
 st_read_done (st_parameter_dt *dtp)
 {
+  if (dtp->u.p.async_stmt != NULL)
+    {
+      async_transfer_done (dtp);
+      return;
+    }
+
   finalize_transfer (dtp);
   if (is_internal_unit (dtp) || dtp->u.p.format_not_saved)
     free_format_data (dtp->u.p.fmt);
@@ -3707,6 +3790,12 @@ export_proto(st_write_done);
 void
 st_write_done (st_parameter_dt *dtp)
 {
+  if (dtp->u.p.async_stmt != NULL)
+    {
+      async_transfer_done (dtp);
+      return;
+    }
+
   finalize_transfer (dtp);
 
   /* Deal with endfile conditions associated with sequential files.  */
@@ -3744,13 +3833,6 @@ st_write_done (st_parameter_dt *dtp)
 }
 
 
-/* F2003: This is a stub for the runtime portion of the WAIT statement.  */
-void
-st_wait (st_parameter_wait *wtp __attribute__((unused)))
-{
-}
-
-
 /* Receives the scalar information for namelist objects and stores it
    in a linked list of namelist_info types.  */
 
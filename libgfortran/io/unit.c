@@ -375,6 +375,46 @@ find_or_create_unit (int n)
 }
 
 
+/* find_async_unit()-- Return the queue of asynchronous data transfers
+   of unit N, or NULL if it has none.  If DO_CREATE is nonzero and N is
+   an open unformatted unit with ASYNCHRONOUS='yes', the queue is
+   started if need be.  The unit's lock is not taken, since the queue's
+   thread holds it while it runs a data transfer.  */
+
+struct async_unit *
+find_async_unit (int n, int do_create)
+{
+  gfc_unit *p;
+  struct async_unit *au = NULL;
+  int c;
+
+  __gthread_mutex_lock (&unit_lock);
+  p = unit_root;
+  while (p != NULL)
+    {
+      c = compare (n, p->unit_number);
+      if (c < 0)
+	p = p->left;
+      if (c > 0)
+	p = p->right;
+      if (c == 0)
+	break;
+    }
+
+  if (p != NULL)
+    {
+      if (do_create && p->au == NULL && p->s != NULL && !p->closed
+	  && p->flags.async == ASYNC_YES && p->flags.form == FORM_UNFORMATTED)
+	p->au = async_start (n);
+      if (!do_create || p->flags.async == ASYNC_YES)
+	au = p->au;
+    }
+  __gthread_mutex_unlock (&unit_lock);
+
+  return au;
+}
+
+
 /* Helper function to check rank, stride, format string, and namelist.
    This is used for optimization. You can't trim out blanks or shorten
    the string if trailing spaces are significant.  */
@@ -677,6 +717,13 @@ close_unit_1 (gfc_unit *u, int locked)
   if (u->previous_nonadvancing_write)
     finish_last_advance_record (u);
 
+  /* The queue of the unit is empty here, see async_wait_unit.  */
+  if (u->au != NULL)
+    {
+      async_close (u->au);
+      u->au = NULL;
+    }
+
   rc = (u->s == NULL) ? 0 : sclose (u->s) == -1;
 
   u->closed = 1;
@@ -738,6 +785,8 @@ close_unit (gfc_unit *u)
 void
 close_units (void)
 {
+  async_drain_all ();
+
   __gthread_mutex_lock (&unit_lock);
   while (unit_root != NULL)
     close_unit_1 (unit_root, 1);
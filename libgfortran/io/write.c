@@ -1177,6 +1177,229 @@ write_es (st_parameter_dt *dtp, const fnode *f, const char *p, int len)
 }
 
 
+/* Write N with the edit descriptor Iw.m into the field of width W > 0
+   at OUT, exactly as write_decimal does for a unit that is not a
+   character(kind=4) internal unit.  M is -1 for Iw.  */
+
+static void
+write_decimal_fast (st_parameter_dt *dtp, char *out, int w, int m,
+		    GFC_INTEGER_LARGEST n)
+{
+  GFC_UINTEGER_LARGEST u;
+  char buf[GFC_BTOA_BUF_SIZE];
+  char *q;
+  int digits, nsign, nzero, nblank;
+  sign_t sign;
+
+  if (m == 0 && n == 0)
+    {
+      memset (out, ' ', w);
+      return;
+    }
+
+  sign = calculate_sign (dtp, n < 0);
+  nsign = sign == S_NONE ? 0 : 1;
+  u = n < 0 ? -(GFC_UINTEGER_LARGEST) n : (GFC_UINTEGER_LARGEST) n;
+
+  q = &buf[sizeof (buf)];
+  do
+    {
+      *--q = '0' + (int) (u % 10);
+      u /= 10;
+    }
+  while (u != 0);
+  digits = &buf[sizeof (buf)] - q;
+
+  nzero = digits < m ? m - digits : 0;
+  nblank = w - (nsign + nzero + digits);
+  if (nblank < 0)
+    {
+      star_fill (out, w);
+      return;
+    }
+
+  memset (out, ' ', nblank);
+  out += nblank;
+  if (sign == S_PLUS)
+    *out++ = '+';
+  else if (sign == S_MINUS)
+    *out++ = '-';
+  memset (out, '0', nzero);
+  memcpy (out + nzero, q, digits);
+}
+
+
+/* Powers of ten that are exact both in a double and in a uint64_t.  */
+
+static const double exact_powers_of_ten[] =
+{
+  1e0, 1e1, 1e2, 1e3, 1e4, 1e5, 1e6, 1e7, 1e8, 1e9, 1e10, 1e11,
+  1e12, 1e13, 1e14, 1e15, 1e16, 1e17, 1e18, 1e19
+};
+
+/* Write X with the edit descriptor F, which is Fw.d with w > 0, when
+   the scale factor is zero and rounding is processor dependent, which
+   for snprintf is round to nearest with ties to even.  X * 10**d is
+   the sum of the rounded product and its error, obtained exactly with
+   a fused multiply-add, so the rounding is decided on the exact value.
+   Returns false without writing anything if X is out of the range
+   where this works; the caller then uses write_float.  */
+
+static bool
+write_float_f_fast (st_parameter_dt *dtp, const fnode *f, double x)
+{
+  double scale, y, err, frac;
+  uint64_t n, ipart, fpart;
+  char buf[24];
+  char *out, *q;
+  int w, d, sign_bit, nbefore, nblanks, i;
+  sign_t sign;
+
+  w = f->u.real.w;
+  d = f->u.real.d;
+  if (FLT_EVAL_METHOD != 0 || d < 0
+      || d >= (int) (sizeof (exact_powers_of_ten)
+		     / sizeof (exact_powers_of_ten[0])))
+    return false;
+
+  sign_bit = signbit (x) != 0;
+  if (sign_bit)
+    x = -x;
+  scale = exact_powers_of_ten[d];
+  y = x * scale;
+  /* Keep the integer part exact and stay well away from underflow of
+     the error term.  The test is false for NaN as well.  */
+  if (!(y < 0x1p52) || (x != 0.0 && x < 0x1p-900))
+    return false;
+
+  err = __builtin_fma (x, scale, -y);
+  n = (uint64_t) y;
+  frac = y - (double) n;
+  if (frac > 0.5
+      || (frac == 0.5 && (err > 0.0 || (err == 0.0 && (n & 1) != 0))))
+    n++;
+
+  /* A value that rounds to zero keeps its sign only with
+     -fsign-zero, as in output_float.  */
+  if (n == 0)
+    sign = calculate_sign (dtp, compile_options.sign_zero == 1 && sign_bit);
+  else
+    sign = calculate_sign (dtp, sign_bit);
+
+  ipart = n / (uint64_t) scale;
+  fpart = n - ipart * (uint64_t) scale;
+
+  q = &buf[sizeof (buf)];
+  for (nbefore = 0; ipart != 0; nbefore++)
+    {
+      *--q = '0' + (int) (ipart % 10);
+      ipart /= 10;
+    }
+
+  out = write_block (dtp, w);
+  if (out == NULL)
+    return true;
+
+  nblanks = w - (nbefore + d + 1) - (sign != S_NONE);
+  if (nblanks < 0 || w == 1 || (w == 2 && sign != S_NONE))
+    {
+      star_fill (out, w);
+      return true;
+    }
+
+  /* Output a zero before the decimal point if there is room for it.  */
+  if (nbefore == 0 && nblanks > 0)
+    {
+      *--q = '0';
+      nbefore++;
+      nblanks--;
+    }
+
+  memset (out, ' ', nblanks);
+  out += nblanks;
+  if (sign == S_PLUS)
+    *out++ = '+';
+  else if (sign == S_MINUS)
+    *out++ = '-';
+  memcpy (out, q, nbefore);
+  out += nbefore;
+  *out++ = dtp->u.p.current_unit->decimal_status == DECIMAL_POINT ? '.' : ',';
+  for (i = d - 1; i >= 0; i--)
+    {
+      out[i] = '0' + (int) (fpart % 10);
+      fpart /= 10;
+    }
+  return true;
+}
+
+
+/* Write COUNT items of type TYPE and kind KIND, STRIDE bytes apart
+   starting at SOURCE, all with the edit descriptor F.  This is the
+   fast path for a repeated data edit descriptor applied to an array:
+   the items are converted directly into the unit's buffer without
+   going back through the format interpreter.  It handles Iw and Iw.m
+   for integers and Fw.d for real(4) and real(8), with no scale factor
+   and processor dependent rounding, on all but character(kind=4)
+   internal units.  Returns false without writing anything if F or the
+   modes of the transfer are not handled, and the items must then be
+   written one at a time.  */
+
+bool
+write_run (st_parameter_dt *dtp, const fnode *f, bt type,
+	   const char *source, int kind, size_t stride, size_t count)
+{
+  size_t i;
+  char *out;
+  int w;
+
+  if (is_char4_unit (dtp) || dtp->u.p.no_leading_blank)
+    return false;
+
+  switch (f->format)
+    {
+    case FMT_I:
+      w = f->u.integer.w;
+      if (type != BT_INTEGER || w <= 0)
+	return false;
+      for (i = 0; i < count; i++, source += stride)
+	{
+	  out = write_block (dtp, w);
+	  if (out == NULL)
+	    break;
+	  write_decimal_fast (dtp, out, w, f->u.integer.m,
+			      extract_int (source, kind));
+	}
+      return true;
+
+    case FMT_F:
+      w = f->u.real.w;
+      if (type != BT_REAL || (kind != 4 && kind != 8) || w <= 0
+	  || dtp->u.p.scale_factor != 0
+	  || (dtp->u.p.current_unit->round_status != ROUND_UNSPECIFIED
+	      && dtp->u.p.current_unit->round_status != ROUND_PROCDEFINED))
+	return false;
+      for (i = 0; i < count; i++, source += stride)
+	{
+	  double x;
+
+	  if (kind == 4)
+	    x = *(const GFC_REAL_4 *) source;
+	  else
+	    x = *(const GFC_REAL_8 *) source;
+	  if (!write_float_f_fast (dtp, f, x))
+	    write_f (dtp, f, source, kind);
+	  if ((dtp->common.flags & IOPARM_LIBRETURN_MASK)
+	      != IOPARM_LIBRETURN_OK)
+	    break;
+	}
+      return true;
+
+    default:
+      return false;
+    }
+}
+
+
 /* Take care of the X/TR descriptor.  */
 
 void
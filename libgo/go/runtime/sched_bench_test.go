@@ -0,0 +1,104 @@
+// Copyright 2014 The Go Authors. All rights reserved.
+// Use of this source code is governed by a BSD-style
+// license that can be found in the LICENSE file.
+
+package runtime_test
+
+import (
+	"bufio"
+	"net"
+	"runtime"
+	"sync"
+	"testing"
+)
+
+// BenchmarkPingPong measures goroutine handoff through unbuffered
+// channels, with many pairs running at once so that the per-P run
+// queues and work stealing are exercised.
+func BenchmarkPingPong(b *testing.B) {
+	pairs := 4 * runtime.GOMAXPROCS(0)
+	per := b.N/pairs + 1
+	var wg sync.WaitGroup
+	wg.Add(pairs)
+	for i := 0; i < pairs; i++ {
+		ping := make(chan int)
+		pong := make(chan int)
+		go func() {
+			for v := range ping {
+				pong <- v
+			}
+			close(pong)
+		}()
+		go func() {
+			for j := 0; j < per; j++ {
+				ping <- j
+				<-pong
+			}
+			close(ping)
+			wg.Done()
+		}()
+	}
+	wg.Wait()
+}
+
+// BenchmarkRPCStyle measures an HTTP-style server on the loopback
+// interface: one goroutine per connection reading a request line and
+// writing a response, with clients keeping connections alive.  Ready
+// goroutines come from the network poller.
+func BenchmarkRPCStyle(b *testing.B) {
+	ln, err := net.Listen("tcp", "127.0.0.1:0")
+	if err != nil {
+		b.Skip("cannot listen on loopback: ", err)
+	}
+	defer ln.Close()
+	go func() {
+		for {
+			c, err := ln.Accept()
+			if err != nil {
+				return
+			}
+			go func(c net.Conn) {
+				defer c.Close()
+				r := bufio.NewReader(c)
+				for {
+					if _, err := r.ReadSlice('\n'); err != nil {
+						return
+					}
+					if _, err := c.Write([]byte("HTTP/1.1 200 OK\r\n")); err != nil {
+						return
+					}
+				}
+			}(c)
+		}
+	}()
+
+	clients := 4 * runtime.GOMAXPROCS(0)
+	per := b.N/clients + 1
+	var wg sync.WaitGroup
+	wg.Add(clients)
+	b.ResetTimer()
+	for i := 0; i < clients; i++ {
+		go func() {
+			defer wg.Done()
+			c, err := net.Dial("tcp", ln.Addr().String())
+			if err != nil {
+				b.Error(err)
+				return
+			}
+			defer c.Close()
+			r := bufio.NewReader(c)
+			req := []byte("GET / HTTP/1.1\r\n")
+			for j := 0; j < per; j++ {
+				if _, err := c.Write(req); err != nil {
+					b.Error(err)
+					return
+				}
+				if _, err := r.ReadSlice('\n'); err != nil {
+					b.Error(err)
+					return
+				}
+			}
+		}()
+	}
+	wg.Wait()
+}
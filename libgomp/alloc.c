@@ -56,3 +56,28 @@ gomp_realloc (void *old, size_t size)
     gomp_fatal ("Out of memory allocating %lu bytes", (unsigned long) size);
   return ret;
 }
+
+/* Allocate SIZE bytes aligned to AL, a power of two.  The block must be
+   released with gomp_aligned_free.  malloc only guarantees the alignment
+   of the largest scalar type, so over-allocate and keep the pointer
+   malloc returned just below the aligned block.  */
+
+void *
+gomp_aligned_alloc (size_t al, size_t size)
+{
+  void *p, *ret;
+
+  if (al < sizeof (void *))
+    al = sizeof (void *);
+  p = gomp_malloc (size + al);
+  ret = (void *) (((uintptr_t) p + al) & ~(uintptr_t) (al - 1));
+  ((void **) ret)[-1] = p;
+  return ret;
+}
+
+void
+gomp_aligned_free (void *ptr)
+{
+  if (ptr)
+    free (((void **) ptr)[-1]);
+}
@@ -30,6 +30,73 @@
 #include "wait.h"
 
 
+/* Count arrivals at BAR, which is a barrier for a team of more than
+   RADIX threads, with a combining tree rather than the single awaited
+   counter.  Threads are grouped into leaves by team_id.  When threads
+   are bound close or spread, consecutive team members are bound to
+   neighbouring places, so a leaf is shared by threads close together
+   in the machine, and only the last of them to arrive moves up.  */
+
+void
+gomp_barrier_init_tree (gomp_barrier_t *bar, unsigned radix)
+{
+  unsigned count = bar->total, nnodes = 0, width, level_width, i;
+  struct gomp_barrier_node *nodes, *level, *next;
+
+  if (radix < 2 || count <= radix)
+    return;
+
+  for (width = count; width > 1; width = (width + radix - 1) / radix)
+    nnodes += (width + radix - 1) / radix;
+
+  bar->nodes_alloc = gomp_malloc (nnodes * sizeof (*nodes) + 63);
+  nodes = (struct gomp_barrier_node *)
+	  (((uintptr_t) bar->nodes_alloc + 63) & ~(uintptr_t) 63);
+
+  /* Lay the tree out a level at a time, starting from the leaves.  */
+  level = nodes;
+  for (width = count; width > 1; width = level_width)
+    {
+      level_width = (width + radix - 1) / radix;
+      next = level + level_width;
+      for (i = 0; i < level_width; i++)
+	{
+	  level[i].total = (i + 1) * radix <= width ? radix : width - i * radix;
+	  level[i].awaited = level[i].total;
+	  level[i].parent = level_width > 1 ? &next[i / radix] : NULL;
+	}
+      level = next;
+    }
+
+  bar->nodes = nodes;
+  bar->radix = radix;
+}
+
+/* Record the arrival of the current thread at BAR, and return true if
+   it was the last of the team.  The last thread to arrive at each node
+   resets it for the next barrier and moves up to the parent; the others
+   return at once to wait for the release of the whole team.  */
+
+bool
+gomp_barrier_tree_arrive (gomp_barrier_t *bar)
+{
+  struct gomp_barrier_node *node
+    = &bar->nodes[gomp_thread ()->ts.team_id / bar->radix];
+
+  while (1)
+    {
+      if (__atomic_add_fetch (&node->awaited, -1, MEMMODEL_ACQ_REL) != 0)
+	return false;
+      /* No thread can arrive here again before the team is released,
+	 which cannot happen before the decrement of the parent below.  */
+      node->awaited = node->total;
+      if (node->parent == NULL)
+	return true;
+      node = node->parent;
+    }
+}
+
+
 void
 gomp_barrier_wait_end (gomp_barrier_t *bar, gomp_barrier_state_t state)
 {
@@ -89,7 +156,10 @@ gomp_team_barrier_wait_end (gomp_barrier_t *bar, gomp_barrier_state_t state)
 
       bar->awaited = bar->total;
       team->work_share_cancelled = 0;
-      if (__builtin_expect (team->task_count, 0))
+      /* Tasks in the per-thread deques are only reliably accounted for
+	 with task_lock held, leave that to gomp_barrier_handle_tasks.  */
+      if (__builtin_expect (team->task_count, 0)
+	  || __builtin_expect (team->task_deques != NULL, 0))
 	{
 	  gomp_barrier_handle_tasks (state);
 	  state &= ~BAR_WAS_LAST;
@@ -153,7 +223,8 @@ gomp_team_barrier_wait_cancel_end (gomp_barrier_t *bar,
 
       bar->awaited = bar->total;
       team->work_share_cancelled = 0;
-      if (__builtin_expect (team->task_count, 0))
+      if (__builtin_expect (team->task_count, 0)
+	  || __builtin_expect (team->task_deques != NULL, 0))
 	{
 	  gomp_barrier_handle_tasks (state);
 	  state &= ~BAR_WAS_LAST;
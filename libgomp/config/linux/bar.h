@@ -31,12 +31,27 @@
 
 #include "mutex.h"
 
+/* A node of the combining tree that team barriers use to count arrivals
+   with GOMP_BARRIER=tree.  Each node counts the arrivals of up to RADIX
+   threads or child nodes in its own cacheline.  */
+struct gomp_barrier_node
+{
+  unsigned awaited __attribute__((aligned (64)));
+  unsigned total;
+  struct gomp_barrier_node *parent;
+};
+
 typedef struct
 {
   /* Make sure total/generation is in a mostly read cacheline, while
      awaited in a separate cacheline.  */
   unsigned total __attribute__((aligned (64)));
   unsigned generation;
+  /* If non-NULL, the leaves of the combining tree, which are counted
+     instead of awaited.  Thread N arrives at nodes[N / radix].  */
+  struct gomp_barrier_node *nodes;
+  unsigned radix;
+  void *nodes_alloc;
   unsigned awaited __attribute__((aligned (64)));
   unsigned awaited_final;
 } gomp_barrier_t;
@@ -58,6 +73,8 @@ static inline void gomp_barrier_init (gomp_barrier_t *bar, unsigned count)
   bar->awaited = count;
   bar->awaited_final = count;
   bar->generation = 0;
+  bar->nodes = NULL;
+  bar->nodes_alloc = NULL;
 }
 
 static inline void gomp_barrier_reinit (gomp_barrier_t *bar, unsigned count)
@@ -68,8 +85,12 @@ static inline void gomp_barrier_reinit (gomp_barrier_t *bar, unsigned count)
 
 static inline void gomp_barrier_destroy (gomp_barrier_t *bar)
 {
+  free (bar->nodes_alloc);
 }
 
+extern void gomp_barrier_init_tree (gomp_barrier_t *, unsigned);
+extern bool gomp_barrier_tree_arrive (gomp_barrier_t *);
+
 extern void gomp_barrier_wait (gomp_barrier_t *);
 extern void gomp_barrier_wait_last (gomp_barrier_t *);
 extern void gomp_barrier_wait_end (gomp_barrier_t *, gomp_barrier_state_t);
@@ -94,7 +115,12 @@ gomp_barrier_wait_start (gomp_barrier_t *bar)
      2.8.6 flush Construct, which says there is an implicit flush during
      a barrier region.  This is a convenient place to add the barrier,
      so we use MEMMODEL_ACQ_REL here rather than MEMMODEL_ACQUIRE.  */
-  if (__atomic_add_fetch (&bar->awaited, -1, MEMMODEL_ACQ_REL) == 0)
+  if (__builtin_expect (bar->nodes != NULL, 0))
+    {
+      if (gomp_barrier_tree_arrive (bar))
+	ret |= BAR_WAS_LAST;
+    }
+  else if (__atomic_add_fetch (&bar->awaited, -1, MEMMODEL_ACQ_REL) == 0)
     ret |= BAR_WAS_LAST;
   return ret;
 }
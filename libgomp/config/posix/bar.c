@@ -122,7 +122,7 @@ gomp_team_barrier_wait_end (gomp_barrier_t *bar, gomp_barrier_state_t state)
       struct gomp_team *team = thr->ts.team;
 
       team->work_share_cancelled = 0;
-      if (team->task_count)
+      if (team->task_count || team->task_deques != NULL)
 	{
 	  gomp_barrier_handle_tasks (state);
 	  if (n > 0)
@@ -184,7 +184,7 @@ gomp_team_barrier_wait_cancel_end (gomp_barrier_t *bar,
       struct gomp_team *team = thr->ts.team;
 
       team->work_share_cancelled = 0;
-      if (team->task_count)
+      if (team->task_count || team->task_deques != NULL)
 	{
 	  gomp_barrier_handle_tasks (state);
 	  if (n > 0)
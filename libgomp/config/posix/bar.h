@@ -61,6 +61,12 @@ extern void gomp_barrier_init (gomp_barrier_t *, unsigned);
 extern void gomp_barrier_reinit (gomp_barrier_t *, unsigned);
 extern void gomp_barrier_destroy (gomp_barrier_t *);
 
+/* Combining-tree barriers are only implemented for Linux.  */
+static inline void
+gomp_barrier_init_tree (gomp_barrier_t *bar, unsigned radix)
+{
+}
+
 extern void gomp_barrier_wait (gomp_barrier_t *);
 extern void gomp_barrier_wait_end (gomp_barrier_t *, gomp_barrier_state_t);
 extern void gomp_team_barrier_wait (gomp_barrier_t *);
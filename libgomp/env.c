@@ -66,6 +66,9 @@ struct gomp_task_icv gomp_global_icv = {
 
 unsigned long gomp_max_active_levels_var = INT_MAX;
 bool gomp_cancel_var = false;
+bool gomp_task_steal_var = false;
+bool gomp_barrier_tree_var = false;
+unsigned long gomp_barrier_radix_var = 0;
 #ifndef HAVE_SYNC_BUILTINS
 gomp_mutex_t gomp_managed_threads_lock;
 #endif
@@ -111,6 +114,11 @@ parse_schedule (void)
       gomp_global_icv.run_sched_var = GFS_AUTO;
       env += 4;
     }
+  else if (strncasecmp (env, "adaptive", 8) == 0)
+    {
+      gomp_global_icv.run_sched_var = GFS_ADAPTIVE;
+      env += 8;
+    }
   else
     goto unknown;
 
@@ -876,6 +884,70 @@ parse_boolean (const char *name, bool *value)
     gomp_error ("Invalid value for environment variable %s", name);
 }
 
+/* Parse the GOMP_TASK_SCHEDULER environment variable and store the
+   result in gomp_task_steal_var.  */
+
+static void
+parse_task_scheduler (void)
+{
+  const char *env;
+
+  env = getenv ("GOMP_TASK_SCHEDULER");
+  if (env == NULL)
+    return;
+
+  while (isspace ((unsigned char) *env))
+    ++env;
+  if (strncasecmp (env, "central", 7) == 0)
+    {
+      gomp_task_steal_var = false;
+      env += 7;
+    }
+  else if (strncasecmp (env, "stealing", 8) == 0)
+    {
+      gomp_task_steal_var = true;
+      env += 8;
+    }
+  else
+    env = "X";
+  while (isspace ((unsigned char) *env))
+    ++env;
+  if (*env != '\0')
+    gomp_error ("Invalid value for environment variable GOMP_TASK_SCHEDULER");
+}
+
+/* Parse the GOMP_BARRIER environment variable and store the result
+   in gomp_barrier_tree_var.  */
+
+static void
+parse_barrier (void)
+{
+  const char *env;
+
+  env = getenv ("GOMP_BARRIER");
+  if (env == NULL)
+    return;
+
+  while (isspace ((unsigned char) *env))
+    ++env;
+  if (strncasecmp (env, "central", 7) == 0)
+    {
+      gomp_barrier_tree_var = false;
+      env += 7;
+    }
+  else if (strncasecmp (env, "tree", 4) == 0)
+    {
+      gomp_barrier_tree_var = true;
+      env += 4;
+    }
+  else
+    env = "X";
+  while (isspace ((unsigned char) *env))
+    ++env;
+  if (*env != '\0')
+    gomp_error ("Invalid value for environment variable GOMP_BARRIER");
+}
+
 /* Parse the OMP_WAIT_POLICY environment variable and store the
    result in gomp_active_wait_policy.  */
 
@@ -1083,6 +1155,9 @@ handle_omp_display_env (unsigned long stacksize, int wait_policy)
     case GFS_AUTO:
       fputs ("AUTO", stderr);
       break;
+    case GFS_ADAPTIVE:
+      fputs ("ADAPTIVE", stderr);
+      break;
     }
   fputs ("'\n", stderr);
 
@@ -1154,6 +1229,12 @@ handle_omp_display_env (unsigned long stacksize, int wait_policy)
       fprintf (stderr, "  GOMP_SPINCOUNT = '%lu'\n",
 	       (unsigned long) gomp_spin_count_var);
 #endif
+      fprintf (stderr, "  GOMP_TASK_SCHEDULER = '%s'\n",
+	       gomp_task_steal_var ? "STEALING" : "CENTRAL");
+      fprintf (stderr, "  GOMP_BARRIER = '%s'\n",
+	       gomp_barrier_tree_var ? "TREE" : "CENTRAL");
+      fprintf (stderr, "  GOMP_BARRIER_RADIX = '%lu'\n",
+	       gomp_barrier_radix_var);
     }
 
   fputs ("OPENMP DISPLAY ENVIRONMENT END\n", stderr);
@@ -1173,6 +1254,15 @@ initialize_env (void)
   parse_boolean ("OMP_DYNAMIC", &gomp_global_icv.dyn_var);
   parse_boolean ("OMP_NESTED", &gomp_global_icv.nest_var);
   parse_boolean ("OMP_CANCELLATION", &gomp_cancel_var);
+  parse_task_scheduler ();
+  parse_barrier ();
+  if (parse_unsigned_long ("GOMP_BARRIER_RADIX", &gomp_barrier_radix_var,
+			   false)
+      && gomp_barrier_radix_var < 2)
+    {
+      gomp_error ("Invalid value for environment variable GOMP_BARRIER_RADIX");
+      gomp_barrier_radix_var = 0;
+    }
   parse_int ("OMP_DEFAULT_DEVICE", &gomp_global_icv.default_device_var, true);
   parse_unsigned_long ("OMP_MAX_ACTIVE_LEVELS", &gomp_max_active_levels_var,
 		       true);
@@ -1340,7 +1430,10 @@ void
 omp_get_schedule (omp_sched_t *kind, int *modifier)
 {
   struct gomp_task_icv *icv = gomp_icv (false);
-  *kind = icv->run_sched_var;
+  /* The adaptive schedule has no omp_sched_t kind; it is a form of
+     dynamic scheduling.  */
+  *kind = icv->run_sched_var == GFS_ADAPTIVE
+	  ? omp_sched_dynamic : (omp_sched_t) icv->run_sched_var;
   *modifier = icv->run_sched_modifier;
 }
 
@@ -335,3 +335,131 @@ gomp_iter_guided_next (long *pstart, long *pend)
   return true;
 }
 #endif /* HAVE_SYNC_BUILTINS */
+
+
+/* Return the number of iterations of the loop of WS.  */
+
+static inline unsigned long
+gomp_iter_adaptive_count (struct gomp_work_share *ws)
+{
+  if (ws->incr > 0)
+    return (ws->end - ws->next + ws->incr - 1) / ws->incr;
+  else
+    return (ws->end - ws->next + ws->incr + 1) / ws->incr;
+}
+
+/* Set up the ADAPTIVE scheduling method for WS, which is shared by a team
+   of NTHREADS threads.  The iteration space is split as evenly as
+   possible into one range per thread, in team_id order, so that as long
+   as no thread runs out of work the iterations are distributed as with
+   schedule(static).  */
+
+void
+gomp_iter_adaptive_init (struct gomp_work_share *ws, unsigned nthreads)
+{
+  unsigned long n = gomp_iter_adaptive_count (ws), q, r, lo;
+  unsigned i;
+
+  ws->ranges_alloc = gomp_malloc (nthreads * sizeof (*ws->ranges) + 63);
+  ws->ranges = (struct gomp_iter_range *)
+	       (((uintptr_t) ws->ranges_alloc + 63) & ~(uintptr_t) 63);
+
+  q = n / nthreads;
+  r = n % nthreads;
+  lo = 0;
+  for (i = 0; i < nthreads; i++)
+    {
+      gomp_mutex_init (&ws->ranges[i].lock);
+      ws->ranges[i].lo = lo;
+      lo += q + (i < r);
+      ws->ranges[i].hi = lo;
+    }
+}
+
+/* Move the upper half of the iterations left in the range of another
+   thread into the range of thread ID, which is empty.  Victims are
+   tried in order of their distance in team_id from ID, since with
+   OMP_PROC_BIND close or spread neighbouring team members run on
+   neighbouring places.  Return false if no thread has any iterations
+   left.  */
+
+static bool
+gomp_iter_adaptive_steal (struct gomp_work_share *ws, unsigned id,
+			  unsigned nthreads)
+{
+  struct gomp_iter_range *own = &ws->ranges[id];
+  unsigned d;
+
+  for (d = 1; d < nthreads; d++)
+    {
+      unsigned v = (d & 1) ? (id + (d + 1) / 2) % nthreads
+			   : (id + nthreads - d / 2) % nthreads;
+      struct gomp_iter_range *victim = &ws->ranges[v];
+      long lo, hi;
+
+      gomp_mutex_lock (&victim->lock);
+      if (victim->lo == victim->hi)
+	{
+	  gomp_mutex_unlock (&victim->lock);
+	  continue;
+	}
+      hi = victim->hi;
+      lo = hi - (hi - victim->lo + 1) / 2;
+      victim->hi = lo;
+      gomp_mutex_unlock (&victim->lock);
+
+      gomp_mutex_lock (&own->lock);
+      own->lo = lo;
+      own->hi = hi;
+      gomp_mutex_unlock (&own->lock);
+      return true;
+    }
+
+  return false;
+}
+
+/* This function implements the ADAPTIVE scheduling method.  Arguments
+   are as for gomp_iter_static_next.  Each thread takes chunks from its
+   own range, without touching any cacheline written by other threads
+   unless they have stolen from it.  The chunks shrink as the range
+   drains, from an eighth of what is left down to the chunk size, so
+   that most of the range stays available to thieves.  */
+
+bool
+gomp_iter_adaptive_next (long *pstart, long *pend)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  struct gomp_work_share *ws = thr->ts.work_share;
+  struct gomp_team *team = thr->ts.team;
+  unsigned nthreads = team ? team->nthreads : 1;
+  unsigned id = thr->ts.team_id;
+  struct gomp_iter_range *own = &ws->ranges[id];
+  long lo, n, chunk;
+
+  gomp_mutex_lock (&own->lock);
+  while (own->lo == own->hi)
+    {
+      gomp_mutex_unlock (&own->lock);
+      if (!gomp_iter_adaptive_steal (ws, id, nthreads))
+	return false;
+      gomp_mutex_lock (&own->lock);
+    }
+
+  lo = own->lo;
+  n = own->hi - lo;
+  chunk = n / 8;
+  if (chunk < ws->chunk_size)
+    chunk = ws->chunk_size;
+  if (chunk > n)
+    chunk = n;
+  own->lo = lo + chunk;
+  gomp_mutex_unlock (&own->lock);
+
+  *pstart = ws->next + lo * ws->incr;
+  /* Avoid overflow past the end of the last, partial step.  */
+  if ((unsigned long) (lo + chunk) == gomp_iter_adaptive_count (ws))
+    *pend = ws->end;
+  else
+    *pend = ws->next + (lo + chunk) * ws->incr;
+  return true;
+}
@@ -71,7 +71,21 @@ enum gomp_schedule_type
   GFS_STATIC,
   GFS_DYNAMIC,
   GFS_GUIDED,
-  GFS_AUTO
+  GFS_AUTO,
+  /* A GNU extension, only selectable through OMP_SCHEDULE.  */
+  GFS_ADAPTIVE
+};
+
+/* For GFS_ADAPTIVE loops, the iterations not yet handed out from the
+   range of one thread, as indices into the iteration space.  The owner
+   takes chunks from the bottom of the range; other threads steal the
+   upper half when their own range is empty.  */
+
+struct gomp_iter_range
+{
+  gomp_mutex_t lock __attribute__((aligned (64)));
+  long lo;
+  long hi;
 };
 
 struct gomp_work_share
@@ -131,6 +145,11 @@ struct gomp_work_share
      in the first gomp_work_share struct in the block.  */
   struct gomp_work_share *next_alloc;
 
+  /* For GFS_ADAPTIVE loops, the iteration range of each team member, and
+     the block of memory that they live in.  */
+  struct gomp_iter_range *ranges;
+  void *ranges_alloc;
+
   /* The above fields are written once during workshare initialization,
      or related to ordered worksharing.  Make sure the following fields
      are in a different cache line.  */
@@ -246,6 +265,9 @@ extern gomp_mutex_t gomp_managed_threads_lock;
 #endif
 extern unsigned long gomp_max_active_levels_var;
 extern bool gomp_cancel_var;
+extern bool gomp_task_steal_var;
+extern bool gomp_barrier_tree_var;
+extern unsigned long gomp_barrier_radix_var;
 extern unsigned long long gomp_spin_count_var, gomp_throttled_spin_count_var;
 extern unsigned long gomp_available_cpus, gomp_managed_threads;
 extern unsigned long *gomp_nthreads_var_list, gomp_nthreads_var_list_len;
@@ -321,6 +343,20 @@ struct gomp_task
   bool final_task;
   bool copy_ctors_done;
   bool parent_depends_on;
+  /* True if ws_base below has been recorded.  */
+  bool ws_base_set;
+  /* Reference count used by the work-stealing scheduler.  Bit 0 is set
+     while this task waits for its stealable children, bit 1 while the
+     task has not finished yet and each outstanding child queued in
+     a per-thread deque adds 4.  */
+  unsigned long ws_refcount;
+  /* Position in the deque of the thread running this task at which
+     its first stealable child has been queued.  Everything queued
+     above it is a descendant of this task.  */
+  unsigned int ws_base;
+  /* Semaphore to post when the last stealable child finishes while
+     bit 0 of ws_refcount is set.  */
+  gomp_sem_t *ws_wait_sem;
   struct gomp_task_depend_entry depend[];
 };
 
@@ -334,6 +370,22 @@ struct gomp_taskgroup
   size_t num_children;
 };
 
+/* Number of entries in each per-thread task deque, must be a power
+   of two.  */
+#define GOMP_TASK_DEQUE_SIZE 256
+
+/* Per-thread double-ended queue of tasks used by the work-stealing
+   task scheduler.  The owning thread pushes and pops at the tail,
+   other threads of the team steal from the head.  */
+
+struct gomp_task_deque
+{
+  gomp_mutex_t lock;
+  unsigned int head;
+  unsigned int tail;
+  struct gomp_task *tasks[GOMP_TASK_DEQUE_SIZE];
+} __attribute__((aligned (64)));
+
 /* This structure describes a "team" of threads.  These are the threads
    that are spawned by a PARALLEL constructs, as well as the work sharing
    constructs that the team encounters.  */
@@ -409,6 +461,12 @@ struct gomp_team
      and if current task isn't in_tied_task, then it will be
      even < team->nthreads.  */
   unsigned int task_running_count;
+  /* Number of tasks queued in or running from the per-thread deques
+     below.  Updated atomically, without holding task_lock.  */
+  unsigned int task_ws_count;
+  /* Array of nthreads per-thread task deques if the work-stealing
+     task scheduler is in use for this team, otherwise NULL.  */
+  struct gomp_task_deque *task_deques;
   int work_share_cancelled;
   int team_cancelled;
 
@@ -525,6 +583,8 @@ extern void gomp_affinity_print_place (void *);
 extern void *gomp_malloc (size_t) __attribute__((malloc));
 extern void *gomp_malloc_cleared (size_t) __attribute__((malloc));
 extern void *gomp_realloc (void *, size_t);
+extern void *gomp_aligned_alloc (size_t, size_t) __attribute__((malloc));
+extern void gomp_aligned_free (void *);
 
 /* Avoid conflicting prototypes of alloca() in system headers by using
    GCC's builtin alloca().  */
@@ -542,6 +602,8 @@ extern void gomp_fatal (const char *, ...)
 extern int gomp_iter_static_next (long *, long *);
 extern bool gomp_iter_dynamic_next_locked (long *, long *);
 extern bool gomp_iter_guided_next_locked (long *, long *);
+extern void gomp_iter_adaptive_init (struct gomp_work_share *, unsigned);
+extern bool gomp_iter_adaptive_next (long *, long *);
 
 #ifdef HAVE_SYNC_BUILTINS
 extern bool gomp_iter_dynamic_next (long *, long *);
@@ -160,6 +160,26 @@ gomp_loop_guided_start (long start, long end, long incr, long chunk_size,
   return ret;
 }
 
+static bool
+gomp_loop_adaptive_start (long start, long end, long incr, long chunk_size,
+			  long *istart, long *iend)
+{
+  struct gomp_thread *thr = gomp_thread ();
+
+  if (gomp_work_share_start (false))
+    {
+      struct gomp_team *team = thr->ts.team;
+
+      gomp_loop_init (thr->ts.work_share, start, end, incr,
+		      GFS_ADAPTIVE, chunk_size);
+      gomp_iter_adaptive_init (thr->ts.work_share,
+			       team ? team->nthreads : 1);
+      gomp_work_share_init_done ();
+    }
+
+  return gomp_iter_adaptive_next (istart, iend);
+}
+
 bool
 GOMP_loop_runtime_start (long start, long end, long incr,
 			 long *istart, long *iend)
@@ -180,6 +200,9 @@ GOMP_loop_runtime_start (long start, long end, long incr,
       /* For now map to schedule(static), later on we could play with feedback
 	 driven choice.  */
       return gomp_loop_static_start (start, end, incr, 0, istart, iend);
+    case GFS_ADAPTIVE:
+      return gomp_loop_adaptive_start (start, end, incr,
+				       icv->run_sched_modifier, istart, iend);
     default:
       abort ();
     }
@@ -280,6 +303,12 @@ GOMP_loop_ordered_runtime_start (long start, long end, long incr,
 	 driven choice.  */
       return gomp_loop_ordered_static_start (start, end, incr,
 					     0, istart, iend);
+    case GFS_ADAPTIVE:
+      /* Ordered loops need iterations handed out in order, which is
+	 what schedule(dynamic) does.  */
+      return gomp_loop_ordered_dynamic_start (start, end, incr,
+					      icv->run_sched_modifier,
+					      istart, iend);
     default:
       abort ();
     }
@@ -349,6 +378,8 @@ GOMP_loop_runtime_next (long *istart, long *iend)
       return gomp_loop_dynamic_next (istart, iend);
     case GFS_GUIDED:
       return gomp_loop_guided_next (istart, iend);
+    case GFS_ADAPTIVE:
+      return gomp_iter_adaptive_next (istart, iend);
     default:
       abort ();
     }
@@ -446,6 +477,8 @@ gomp_parallel_loop_start (void (*fn) (void *), void *data,
   num_threads = gomp_resolve_num_threads (num_threads, 0);
   team = gomp_new_team (num_threads);
   gomp_loop_init (&team->work_shares[0], start, end, incr, sched, chunk_size);
+  if (sched == GFS_ADAPTIVE)
+    gomp_iter_adaptive_init (&team->work_shares[0], num_threads);
   gomp_team_start (fn, data, num_threads, flags, team);
 }
 
@@ -177,6 +177,8 @@ GOMP_loop_ull_runtime_start (bool up, gomp_ull start, gomp_ull end,
 					 icv->run_sched_modifier,
 					 istart, iend);
     case GFS_DYNAMIC:
+    case GFS_ADAPTIVE:
+      /* schedule(adaptive) is only implemented for long iterators.  */
       return gomp_loop_ull_dynamic_start (up, start, end, incr,
 					  icv->run_sched_modifier,
 					  istart, iend);
@@ -281,6 +283,7 @@ GOMP_loop_ull_ordered_runtime_start (bool up, gomp_ull start, gomp_ull end,
 						 icv->run_sched_modifier,
 						 istart, iend);
     case GFS_DYNAMIC:
+    case GFS_ADAPTIVE:
       return gomp_loop_ull_ordered_dynamic_start (up, start, end, incr,
 						  icv->run_sched_modifier,
 						  istart, iend);
@@ -57,6 +57,11 @@ htab_eq (hash_entry_type x, hash_entry_type y)
   return x->addr == y->addr;
 }
 
+/* Bits of gomp_task's ws_refcount field.  */
+#define GOMP_TASK_WS_WAITING	1
+#define GOMP_TASK_WS_ALIVE	2
+#define GOMP_TASK_WS_CHILD	4
+
 /* Create a new task data structure.  */
 
 void
@@ -76,6 +81,9 @@ gomp_init_task (struct gomp_task *task, struct gomp_task *parent_task,
   task->dependers = NULL;
   task->depend_hash = NULL;
   task->depend_count = 0;
+  task->ws_base_set = false;
+  task->ws_refcount = GOMP_TASK_WS_ALIVE;
+  task->ws_wait_sem = NULL;
 }
 
 /* Clean up a task, after completing it.  */
@@ -104,6 +112,226 @@ gomp_clear_parent (struct gomp_task *children)
     while (task != children);
 }
 
+/* Free the memory of TASK, which has finished running.  Children
+   queued in the per-thread deques hold a reference on their parent,
+   if there are any left, the last one of them frees it instead.  */
+
+static inline void
+gomp_task_free (struct gomp_task *task)
+{
+  if (__atomic_load_n (&task->ws_refcount, MEMMODEL_ACQUIRE)
+      != GOMP_TASK_WS_ALIVE
+      && __atomic_sub_fetch (&task->ws_refcount, GOMP_TASK_WS_ALIVE,
+			     MEMMODEL_ACQ_REL) != 0)
+    return;
+  gomp_finish_task (task);
+  free (task);
+}
+
+/* Queue TASK, a child of PARENT without depend clauses and outside
+   of any taskgroup, at the tail of the current thread's deque.
+   Return false if the deque is full and the task has to be queued
+   in the team's task_queue instead.  */
+
+static bool
+gomp_task_ws_push (struct gomp_thread *thr, struct gomp_team *team,
+		   struct gomp_task *parent, struct gomp_task *task)
+{
+  struct gomp_task_deque *deque = &team->task_deques[thr->ts.team_id];
+
+  if (deque->tail - __atomic_load_n (&deque->head, MEMMODEL_RELAXED)
+      >= GOMP_TASK_DEQUE_SIZE)
+    return false;
+
+  /* The child can be stolen and finish as soon as it is in the deque,
+     so account for it first.  */
+  __atomic_add_fetch (&parent->ws_refcount, GOMP_TASK_WS_CHILD,
+		      MEMMODEL_RELAXED);
+  __atomic_add_fetch (&team->task_ws_count, 1, MEMMODEL_RELAXED);
+
+  gomp_mutex_lock (&deque->lock);
+  if (deque->tail - deque->head >= GOMP_TASK_DEQUE_SIZE)
+    {
+      gomp_mutex_unlock (&deque->lock);
+      __atomic_sub_fetch (&team->task_ws_count, 1, MEMMODEL_RELAXED);
+      __atomic_sub_fetch (&parent->ws_refcount, GOMP_TASK_WS_CHILD,
+			  MEMMODEL_RELAXED);
+      return false;
+    }
+  if (!parent->ws_base_set)
+    {
+      parent->ws_base = deque->tail;
+      parent->ws_base_set = true;
+    }
+  deque->tasks[deque->tail & (GOMP_TASK_DEQUE_SIZE - 1)] = task;
+  __atomic_store_n (&deque->tail, deque->tail + 1, MEMMODEL_RELEASE);
+  gomp_mutex_unlock (&deque->lock);
+
+  /* Only wake up threads idling in the barrier if nobody has been told
+     about pending tasks yet.  The fence pairs with the one in
+     gomp_task_ws_handle, so that either we see the flag cleared
+     or the clearing thread sees the task we have just queued.  */
+  __atomic_thread_fence (MEMMODEL_SEQ_CST);
+  if ((__atomic_load_n (&team->barrier.generation, MEMMODEL_RELAXED)
+       & BAR_TASK_PENDING) == 0)
+    {
+      gomp_mutex_lock (&team->task_lock);
+      gomp_team_barrier_set_task_pending (&team->barrier);
+      gomp_mutex_unlock (&team->task_lock);
+      gomp_team_barrier_wake (&team->barrier, 1);
+    }
+  return true;
+}
+
+/* Pop the most recently queued task from the tail of DEQUE.  If LIMIT
+   is non-NULL, only return tasks that are descendants of LIMIT, i.e.
+   those queued after its first stealable child.  */
+
+static struct gomp_task *
+gomp_task_ws_pop (struct gomp_task_deque *deque, struct gomp_task *limit)
+{
+  struct gomp_task *task = NULL;
+
+  if (__atomic_load_n (&deque->head, MEMMODEL_RELAXED) == deque->tail)
+    return NULL;
+  gomp_mutex_lock (&deque->lock);
+  if (deque->head != deque->tail
+      && (limit == NULL
+	  || (limit->ws_base_set
+	      && (int) (deque->tail - 1 - limit->ws_base) >= 0)))
+    {
+      task = deque->tasks[(deque->tail - 1) & (GOMP_TASK_DEQUE_SIZE - 1)];
+      __atomic_store_n (&deque->tail, deque->tail - 1, MEMMODEL_RELAXED);
+    }
+  gomp_mutex_unlock (&deque->lock);
+  return task;
+}
+
+/* Steal the oldest task from the head of another thread's DEQUE.
+   *MORE is set to true if DEQUE is non-empty afterwards.  */
+
+static struct gomp_task *
+gomp_task_ws_steal (struct gomp_task_deque *deque, bool *more)
+{
+  struct gomp_task *task = NULL;
+
+  if (__atomic_load_n (&deque->tail, MEMMODEL_ACQUIRE)
+      == __atomic_load_n (&deque->head, MEMMODEL_RELAXED))
+    return NULL;
+  gomp_mutex_lock (&deque->lock);
+  if (deque->head != deque->tail)
+    {
+      task = deque->tasks[deque->head & (GOMP_TASK_DEQUE_SIZE - 1)];
+      __atomic_store_n (&deque->head, deque->head + 1, MEMMODEL_RELAXED);
+      *more = deque->head != deque->tail;
+    }
+  gomp_mutex_unlock (&deque->lock);
+  return task;
+}
+
+/* Return true if any of the team's deques has queued tasks.  */
+
+static bool
+gomp_task_ws_any_queued (struct gomp_team *team)
+{
+  unsigned i;
+
+  for (i = 0; i < team->nthreads; i++)
+    if (__atomic_load_n (&team->task_deques[i].tail, MEMMODEL_RELAXED)
+	!= __atomic_load_n (&team->task_deques[i].head, MEMMODEL_RELAXED))
+      return true;
+  return false;
+}
+
+/* Run CHILD_TASK taken from one of the deques in the current thread
+   and release it afterwards.  Return true if it was the last task
+   of the team scheduled through the deques.  */
+
+static bool
+gomp_task_ws_run (struct gomp_thread *thr, struct gomp_team *team,
+		  struct gomp_task *child_task)
+{
+  struct gomp_task *task = thr->task;
+  struct gomp_task *parent = child_task->parent;
+  unsigned long refcount;
+
+  child_task->kind = GOMP_TASK_TIED;
+  if (!gomp_team_barrier_cancelled (&team->barrier)
+      || child_task->copy_ctors_done)
+    {
+      thr->task = child_task;
+      child_task->fn (child_task->fn_data);
+      thr->task = task;
+    }
+
+  /* Children queued in the team's task_queue only point back to us
+     through their parent field.  */
+  if (child_task->children != NULL)
+    {
+      gomp_mutex_lock (&team->task_lock);
+      gomp_clear_parent (child_task->children);
+      gomp_mutex_unlock (&team->task_lock);
+    }
+
+  /* Drop the reference on the parent, waking it up if it waits in
+     gomp_task_ws_wait for its last child, or freeing it if it has
+     finished already.  */
+  refcount = __atomic_sub_fetch (&parent->ws_refcount, GOMP_TASK_WS_CHILD,
+				 MEMMODEL_ACQ_REL);
+  if (refcount == (GOMP_TASK_WS_ALIVE | GOMP_TASK_WS_WAITING))
+    {
+      gomp_sem_t *sem = parent->ws_wait_sem;
+      __atomic_store_n (&parent->ws_refcount, GOMP_TASK_WS_ALIVE,
+			MEMMODEL_RELEASE);
+      gomp_sem_post (sem);
+    }
+  else if (refcount == 0)
+    {
+      gomp_finish_task (parent);
+      free (parent);
+    }
+
+  gomp_task_free (child_task);
+  return __atomic_sub_fetch (&team->task_ws_count, 1, MEMMODEL_ACQ_REL) == 0;
+}
+
+/* Wait until all children of TASK queued in the per-thread deques have
+   finished, running those that have not been stolen by other threads
+   yet.  */
+
+static void
+gomp_task_ws_wait (struct gomp_thread *thr, struct gomp_team *team,
+		   struct gomp_task *task)
+{
+  struct gomp_task_deque *deque = &team->task_deques[thr->ts.team_id];
+  struct gomp_task *child_task;
+  gomp_sem_t sem;
+
+  while (__atomic_load_n (&task->ws_refcount, MEMMODEL_ACQUIRE)
+	 >= GOMP_TASK_WS_CHILD)
+    {
+      child_task = gomp_task_ws_pop (deque, task);
+      if (child_task != NULL)
+	{
+	  gomp_task_ws_run (thr, team, child_task);
+	  continue;
+	}
+
+      /* The remaining children are running in other threads.  */
+      gomp_sem_init (&sem, 0);
+      task->ws_wait_sem = &sem;
+      if (__atomic_add_fetch (&task->ws_refcount, GOMP_TASK_WS_WAITING,
+			      MEMMODEL_ACQ_REL)
+	  == (GOMP_TASK_WS_ALIVE | GOMP_TASK_WS_WAITING))
+	__atomic_and_fetch (&task->ws_refcount, ~GOMP_TASK_WS_WAITING,
+			    MEMMODEL_ACQ_REL);
+      else
+	gomp_sem_wait (&sem);
+      task->ws_wait_sem = NULL;
+      gomp_sem_destroy (&sem);
+    }
+}
+
 static void gomp_task_maybe_wait_for_dependencies (void **depend);
 
 /* Called when encountering an explicit task directive.  If IF_CLAUSE is
@@ -137,7 +365,7 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 
   if (!if_clause || team == NULL
       || (thr->task && thr->task->final_task)
-      || team->task_count > 64 * team->nthreads)
+      || team->task_count + team->task_ws_count > 64 * team->nthreads)
     {
       struct gomp_task task;
 
@@ -184,6 +412,10 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 	  gomp_clear_parent (task.children);
 	  gomp_mutex_unlock (&team->task_lock);
 	}
+      /* Children queued in the per-thread deques keep a reference to
+	 this task, which lives on our stack, so wait for them.  */
+      if (task.ws_refcount >= GOMP_TASK_WS_CHILD)
+	gomp_task_ws_wait (thr, team, &task);
       gomp_end_task ();
     }
   else
@@ -219,6 +451,21 @@ GOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
       task->fn = fn;
       task->fn_data = arg;
       task->final_task = (flags & 2) >> 1;
+      /* Tasks without dependencies outside of taskgroups are queued in
+	 the current thread's deque if the work-stealing scheduler is in
+	 use, without taking the team's task_lock.  */
+      if (team->task_deques != NULL && depend_size == 0 && taskgroup == NULL)
+	{
+	  if (__builtin_expect (gomp_team_barrier_cancelled (&team->barrier)
+				&& !task->copy_ctors_done, 0))
+	    {
+	      gomp_finish_task (task);
+	      free (task);
+	      return;
+	    }
+	  if (gomp_task_ws_push (thr, team, parent, task))
+	    return;
+	}
       gomp_mutex_lock (&team->task_lock);
       /* If parallel or taskgroup has been cancelled, don't start new
 	 tasks.  */
@@ -670,6 +917,70 @@ gomp_task_run_post_remove_taskgroup (struct gomp_task *child_task)
     }
 }
 
+/* Called from gomp_barrier_handle_tasks once the team's task_queue is
+   empty.  Run tasks from the current thread's deque and steal tasks
+   from other threads' deques for as long as there are any.  Return
+   false if there were none.  */
+
+static bool
+gomp_task_ws_handle (struct gomp_thread *thr, struct gomp_team *team,
+		     gomp_barrier_state_t state)
+{
+  unsigned int id = thr->ts.team_id, i;
+  struct gomp_task *child_task;
+  bool ran = false;
+
+  while (1)
+    {
+      bool more = false;
+
+      child_task = gomp_task_ws_pop (&team->task_deques[id], NULL);
+      for (i = 1; child_task == NULL && i < team->nthreads; i++)
+	child_task
+	  = gomp_task_ws_steal (&team->task_deques[(id + i)
+						   % team->nthreads], &more);
+      if (child_task == NULL)
+	break;
+
+      /* If the victim has more tasks queued, get another idle thread
+	 stealing too.  */
+      if (more)
+	gomp_team_barrier_wake (&team->barrier, 1);
+
+      ran = true;
+      if (gomp_task_ws_run (thr, team, child_task))
+	{
+	  gomp_mutex_lock (&team->task_lock);
+	  if (team->task_count == 0
+	      && gomp_team_barrier_waiting_for_tasks (&team->barrier))
+	    {
+	      gomp_team_barrier_done (&team->barrier, state);
+	      gomp_mutex_unlock (&team->task_lock);
+	      gomp_team_barrier_wake (&team->barrier, 0);
+	    }
+	  else
+	    gomp_mutex_unlock (&team->task_lock);
+	}
+    }
+
+  if (!ran)
+    {
+      /* Stop the threads waiting in the barrier from looking for tasks
+	 until gomp_task_ws_push sets the flag again.  The fence pairs
+	 with the one there.  */
+      gomp_mutex_lock (&team->task_lock);
+      if (team->task_queued_count == 0)
+	{
+	  gomp_team_barrier_clear_task_pending (&team->barrier);
+	  __atomic_thread_fence (MEMMODEL_SEQ_CST);
+	  if (gomp_task_ws_any_queued (team))
+	    gomp_team_barrier_set_task_pending (&team->barrier);
+	}
+      gomp_mutex_unlock (&team->task_lock);
+    }
+  return ran;
+}
+
 void
 gomp_barrier_handle_tasks (gomp_barrier_state_t state)
 {
@@ -683,7 +994,8 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
   gomp_mutex_lock (&team->task_lock);
   if (gomp_barrier_last_thread (state))
     {
-      if (team->task_count == 0)
+      if (team->task_count == 0
+	  && __atomic_load_n (&team->task_ws_count, MEMMODEL_ACQUIRE) == 0)
 	{
 	  gomp_team_barrier_done (&team->barrier, state);
 	  gomp_mutex_unlock (&team->task_lock);
@@ -705,8 +1017,7 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
 	    {
 	      if (to_free)
 		{
-		  gomp_finish_task (to_free);
-		  free (to_free);
+		  gomp_task_free (to_free);
 		  to_free = NULL;
 		}
 	      goto finish_cancelled;
@@ -722,8 +1033,7 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
 	}
       if (to_free)
 	{
-	  gomp_finish_task (to_free);
-	  free (to_free);
+	  gomp_task_free (to_free);
 	  to_free = NULL;
 	}
       if (child_task)
@@ -732,7 +1042,8 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
 	  child_task->fn (child_task->fn_data);
 	  thr->task = task;
 	}
-      else
+      else if (team->task_deques == NULL
+	       || !gomp_task_ws_handle (thr, team, state))
 	return;
       gomp_mutex_lock (&team->task_lock);
       if (child_task)
@@ -754,6 +1065,7 @@ gomp_barrier_handle_tasks (gomp_barrier_state_t state)
 		do_wake = new_tasks;
 	    }
 	  if (--team->task_count == 0
+	      && __atomic_load_n (&team->task_ws_count, MEMMODEL_ACQUIRE) == 0
 	      && gomp_team_barrier_waiting_for_tasks (&team->barrier))
 	    {
 	      gomp_team_barrier_done (&team->barrier, state);
@@ -784,8 +1096,11 @@ GOMP_taskwait (void)
      this point, but we must ensure that all writes to memory by a
      child thread task work function are seen before we exit from
      GOMP_taskwait.  */
-  if (task == NULL
-      || __atomic_load_n (&task->children, MEMMODEL_ACQUIRE) == NULL)
+  if (task == NULL)
+    return;
+  if (team != NULL && team->task_deques != NULL)
+    gomp_task_ws_wait (thr, team, task);
+  if (__atomic_load_n (&task->children, MEMMODEL_ACQUIRE) == NULL)
     return;
 
   memset (&taskwait, 0, sizeof (taskwait));
@@ -800,8 +1115,7 @@ GOMP_taskwait (void)
 	  gomp_mutex_unlock (&team->task_lock);
 	  if (to_free)
 	    {
-	      gomp_finish_task (to_free);
-	      free (to_free);
+	      gomp_task_free (to_free);
 	    }
 	  if (destroy_taskwait)
 	    gomp_sem_destroy (&taskwait.taskwait_sem);
@@ -817,8 +1131,7 @@ GOMP_taskwait (void)
 	    {
 	      if (to_free)
 		{
-		  gomp_finish_task (to_free);
-		  free (to_free);
+		  gomp_task_free (to_free);
 		  to_free = NULL;
 		}
 	      goto finish_cancelled;
@@ -844,8 +1157,7 @@ GOMP_taskwait (void)
 	}
       if (to_free)
 	{
-	  gomp_finish_task (to_free);
-	  free (to_free);
+	  gomp_task_free (to_free);
 	  to_free = NULL;
 	}
       if (child_task)
@@ -972,8 +1284,7 @@ gomp_task_maybe_wait_for_dependencies (void **depend)
 	  gomp_mutex_unlock (&team->task_lock);
 	  if (to_free)
 	    {
-	      gomp_finish_task (to_free);
-	      free (to_free);
+	      gomp_task_free (to_free);
 	    }
 	  gomp_sem_destroy (&taskwait.taskwait_sem);
 	  return;
@@ -988,8 +1299,7 @@ gomp_task_maybe_wait_for_dependencies (void **depend)
 	    {
 	      if (to_free)
 		{
-		  gomp_finish_task (to_free);
-		  free (to_free);
+		  gomp_task_free (to_free);
 		  to_free = NULL;
 		}
 	      goto finish_cancelled;
@@ -1007,8 +1317,7 @@ gomp_task_maybe_wait_for_dependencies (void **depend)
 	}
       if (to_free)
 	{
-	  gomp_finish_task (to_free);
-	  free (to_free);
+	  gomp_task_free (to_free);
 	  to_free = NULL;
 	}
       if (child_task)
@@ -1125,8 +1434,7 @@ GOMP_taskgroup_end (void)
 	      gomp_mutex_unlock (&team->task_lock);
 	      if (to_free)
 		{
-		  gomp_finish_task (to_free);
-		  free (to_free);
+		  gomp_task_free (to_free);
 		}
 	      goto finish;
 	    }
@@ -1142,8 +1450,7 @@ GOMP_taskgroup_end (void)
 	    {
 	      if (to_free)
 		{
-		  gomp_finish_task (to_free);
-		  free (to_free);
+		  gomp_task_free (to_free);
 		  to_free = NULL;
 		}
 	      goto finish_cancelled;
@@ -1165,8 +1472,7 @@ GOMP_taskgroup_end (void)
 	}
       if (to_free)
 	{
-	  gomp_finish_task (to_free);
-	  free (to_free);
+	  gomp_task_free (to_free);
 	  to_free = NULL;
 	}
       if (child_task)
@@ -134,6 +134,28 @@ gomp_thread_start (void *xdata)
 }
 
 
+/* Return the number of threads of a new team of NTHREADS threads that
+   share a leaf of its barrier's combining tree.  Unless overridden by
+   GOMP_BARRIER_RADIX, if the threads are bound and there are more of
+   them than places, that is the number of threads bound to each place,
+   so that each leaf groups the threads of one place.  */
+
+static unsigned
+gomp_barrier_radix (unsigned nthreads)
+{
+  struct gomp_thread *thr = gomp_thread ();
+  unsigned nplaces = thr->ts.place_partition_len;
+
+  if (gomp_barrier_radix_var)
+    return gomp_barrier_radix_var;
+  if (gomp_places_list != NULL
+      && gomp_icv (false)->bind_var != omp_proc_bind_false
+      && nplaces > 0
+      && nthreads >= 2 * nplaces)
+    return (nthreads + nplaces - 1) / nplaces;
+  return 8;
+}
+
 /* Create a new team data structure.  */
 
 struct gomp_team *
@@ -164,6 +186,8 @@ gomp_new_team (unsigned nthreads)
 
   team->nthreads = nthreads;
   gomp_barrier_init (&team->barrier, nthreads);
+  if (gomp_barrier_tree_var)
+    gomp_barrier_init_tree (&team->barrier, gomp_barrier_radix (nthreads));
 
   gomp_sem_init (&team->master_release, 0);
   team->ordered_release = (void *) &team->implicit_task[nthreads];
@@ -174,6 +198,20 @@ gomp_new_team (unsigned nthreads)
   team->task_count = 0;
   team->task_queued_count = 0;
   team->task_running_count = 0;
+  team->task_ws_count = 0;
+  team->task_deques = NULL;
+  if (gomp_task_steal_var && nthreads > 1)
+    {
+      team->task_deques
+	= gomp_aligned_alloc (__alignof__ (struct gomp_task_deque),
+			      nthreads * sizeof (struct gomp_task_deque));
+      for (i = 0; i < nthreads; i++)
+	{
+	  gomp_mutex_init (&team->task_deques[i].lock);
+	  team->task_deques[i].head = 0;
+	  team->task_deques[i].tail = 0;
+	}
+    }
   team->work_share_cancelled = 0;
   team->team_cancelled = 0;
 
@@ -188,6 +226,13 @@ free_team (struct gomp_team *team)
 {
   gomp_barrier_destroy (&team->barrier);
   gomp_mutex_destroy (&team->task_lock);
+  if (team->task_deques)
+    {
+      unsigned i;
+      for (i = 0; i < team->nthreads; i++)
+	gomp_mutex_destroy (&team->task_deques[i].lock);
+      gomp_aligned_free (team->task_deques);
+    }
   free (team);
 }
 
@@ -866,9 +911,8 @@ gomp_team_end (void)
     gomp_fini_work_share (thr->ts.work_share);
 
   gomp_end_task ();
-  thr->ts = team->prev_ts;
 
-  if (__builtin_expect (thr->ts.team != NULL, 0))
+  if (__builtin_expect (team->prev_ts.team != NULL, 0))
     {
 #ifdef HAVE_SYNC_BUILTINS
       __sync_fetch_and_add (&gomp_managed_threads, 1L - team->nthreads);
@@ -878,9 +922,13 @@ gomp_team_end (void)
       gomp_mutex_unlock (&gomp_managed_threads_lock);
 #endif
       /* This barrier has gomp_barrier_wait_last counterparts
-	 and ensures the team can be safely destroyed.  */
+	 and ensures the team can be safely destroyed.  It must be
+	 entered with thr->ts still describing this team, as tree
+	 barriers find the thread's place in the tree from its
+	 team_id.  */
       gomp_barrier_wait (&team->barrier);
     }
+  thr->ts = team->prev_ts;
 
   if (__builtin_expect (team->work_shares[0].next_alloc != NULL, 0))
     {
@@ -0,0 +1,116 @@
+/* { dg-do run } */
+/* { dg-options "-O2 -fopenmp" } */
+
+/* Synchronization overhead microbenchmark in the style of the EPCC
+   OpenMP microbenchmarks: the time of a loop of constructs each
+   containing a short delay, less that of the same delays run without
+   the constructs, divided by the number of constructs.  Pass -v to
+   print the overheads.  Also checks that the barriers synchronize.  */
+
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define REPS 2000
+#define DELAY 100
+
+volatile int sink;
+int counts[REPS];
+
+static void
+delay (int n)
+{
+  int i;
+  for (i = 0; i < n; i++)
+    sink = i;
+}
+
+static double
+reference (void)
+{
+  double t = omp_get_wtime ();
+  #pragma omp parallel
+  {
+    int r;
+    for (r = 0; r < REPS; r++)
+      delay (DELAY);
+  }
+  return omp_get_wtime () - t;
+}
+
+static double
+barrier (void)
+{
+  double t = omp_get_wtime ();
+  #pragma omp parallel
+  {
+    int r, n = omp_get_num_threads ();
+    for (r = 0; r < REPS; r++)
+      {
+	delay (DELAY);
+	#pragma omp atomic
+	counts[r]++;
+	#pragma omp barrier
+	if (counts[r] != n)
+	  abort ();
+      }
+  }
+  return omp_get_wtime () - t;
+}
+
+static double
+for_loop (void)
+{
+  double t = omp_get_wtime ();
+  #pragma omp parallel
+  {
+    int r, i, n = omp_get_num_threads ();
+    for (r = 0; r < REPS; r++)
+      {
+	#pragma omp for
+	for (i = 0; i < n; i++)
+	  delay (DELAY);
+      }
+  }
+  return omp_get_wtime () - t;
+}
+
+static double
+reduction (void)
+{
+  int r, n = omp_get_max_threads ();
+  double t = omp_get_wtime ();
+  for (r = 0; r < REPS; r++)
+    {
+      int sum = 0;
+      #pragma omp parallel reduction (+:sum)
+      {
+	delay (DELAY);
+	sum += 1;
+      }
+      if (sum != n)
+	abort ();
+    }
+  return omp_get_wtime () - t;
+}
+
+int
+main (int argc, char **argv)
+{
+  int verbose = argc > 1 && strcmp (argv[1], "-v") == 0;
+  double tref = reference ();
+  double tbar = barrier ();
+  double tfor = for_loop ();
+  double tred = reduction ();
+
+  if (verbose)
+    {
+      printf ("%d threads, reference %.3f us\n", omp_get_max_threads (),
+	      tref * 1e6 / REPS);
+      printf ("barrier overhead:   %.3f us\n", (tbar - tref) * 1e6 / REPS);
+      printf ("for overhead:       %.3f us\n", (tfor - tref) * 1e6 / REPS);
+      printf ("reduction overhead: %.3f us\n", (tred - tref) * 1e6 / REPS);
+    }
+  return 0;
+}
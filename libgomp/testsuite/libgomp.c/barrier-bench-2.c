@@ -0,0 +1,7 @@
+/* { dg-do run } */
+/* { dg-options "-O2 -fopenmp" } */
+/* { dg-set-target-env-var OMP_NUM_THREADS "7" } */
+/* { dg-set-target-env-var GOMP_BARRIER "tree" } */
+/* { dg-set-target-env-var GOMP_BARRIER_RADIX "2" } */
+
+#include "barrier-bench-1.c"
@@ -0,0 +1,4 @@
+/* { dg-options "-std=gnu99 -fopenmp" } */
+/* { dg-set-target-env-var OMP_SCHEDULE "adaptive,3" } */
+
+#include "for-1.c"
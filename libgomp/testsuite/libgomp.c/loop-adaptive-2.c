@@ -0,0 +1,100 @@
+/* { dg-do run } */
+/* { dg-options "-O2 -fopenmp" } */
+/* { dg-set-target-env-var OMP_SCHEDULE "adaptive" } */
+
+/* Check that schedule(runtime) with OMP_SCHEDULE=adaptive runs every
+   iteration exactly once when the work is unbalanced, so that threads
+   steal from each other, including for nowait, combined and orphaned
+   loops and loops with negative or non-unit steps.  */
+
+#include <omp.h>
+#include <stdlib.h>
+
+#define N 10000
+
+int counts[N];
+volatile int sink;
+
+static void
+work (int i)
+{
+  int j;
+  /* Make the last iterations much more expensive than the first.  */
+  for (j = 0; j < i / 16; j++)
+    sink = j;
+  __atomic_add_fetch (&counts[i], 1, __ATOMIC_RELAXED);
+}
+
+static void
+check (int start, int end, int step, int expected)
+{
+  int i;
+  for (i = 0; i < N; i++)
+    {
+      int in = step > 0 ? (i >= start && i < end && (i - start) % step == 0)
+			: (i <= start && i > end && (start - i) % -step == 0);
+      if (counts[i] != (in ? expected : 0))
+	abort ();
+      counts[i] = 0;
+    }
+}
+
+static void
+orphaned (void)
+{
+  int i;
+  #pragma omp for schedule(runtime)
+  for (i = 0; i < N; i++)
+    work (i);
+}
+
+int
+main ()
+{
+  omp_sched_t kind;
+  int modifier, i;
+
+  omp_get_schedule (&kind, &modifier);
+  if (kind != omp_sched_dynamic || modifier != 1)
+    abort ();
+
+  #pragma omp parallel for schedule(runtime)
+  for (i = 0; i < N; i++)
+    work (i);
+  check (0, N, 1, 1);
+
+  #pragma omp parallel
+  {
+    #pragma omp for schedule(runtime) nowait
+    for (i = 0; i < N; i += 7)
+      work (i);
+    #pragma omp for schedule(runtime)
+    for (i = N - 1; i > 0; i -= 3)
+      work (i);
+  }
+  for (i = 0; i < N; i++)
+    {
+      int expected = (i % 7 == 0) + (i > 0 && (N - 1 - i) % 3 == 0);
+      if (counts[i] != expected)
+	abort ();
+      counts[i] = 0;
+    }
+
+  #pragma omp parallel num_threads (3)
+  orphaned ();
+  check (0, N, 1, 1);
+
+  /* And outside of any parallel region.  */
+  orphaned ();
+  check (0, N, 1, 1);
+
+  /* Empty and single iteration loops.  */
+  #pragma omp parallel for schedule(runtime)
+  for (i = 5; i < 5; i++)
+    work (i);
+  #pragma omp parallel for schedule(runtime)
+  for (i = 5; i > 4; i--)
+    work (i);
+  check (5, 4, -1, 1);
+  return 0;
+}
@@ -0,0 +1,67 @@
+/* { dg-do run } */
+/* { dg-options "-O2 -fopenmp" } */
+
+/* Task spawn microbenchmark.  Pass -v to print the spawn rates.  */
+
+#include <omp.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+#define N 100000
+
+int work[N];
+
+long
+fib (int n)
+{
+  long a, b;
+  if (n < 2)
+    return n;
+  #pragma omp task shared (a)
+  a = fib (n - 1);
+  #pragma omp task shared (b)
+  b = fib (n - 2);
+  #pragma omp taskwait
+  return a + b;
+}
+
+int
+main (int argc, char **argv)
+{
+  int verbose = argc > 1 && strcmp (argv[1], "-v") == 0;
+  int i, rep;
+  long r = 0;
+  double t;
+
+  /* Flat spawn of many tiny tasks from a single thread.  */
+  for (rep = 0; rep < 3; rep++)
+    {
+      t = omp_get_wtime ();
+      #pragma omp parallel
+      #pragma omp single
+      for (i = 0; i < N; i++)
+	#pragma omp task firstprivate (i)
+	work[i] += i;
+      t = omp_get_wtime () - t;
+      if (verbose)
+	printf ("flat: %d tasks on %d threads: %.3f us/task\n", N,
+		omp_get_max_threads (), t * 1e6 / N);
+    }
+  for (i = 0; i < N; i++)
+    if (work[i] != 3 * i)
+      abort ();
+
+  /* Recursive spawn, where every thread spawns tasks.  */
+  t = omp_get_wtime ();
+  #pragma omp parallel
+  #pragma omp single
+  r = fib (27);
+  t = omp_get_wtime () - t;
+  if (r != 196418)
+    abort ();
+  if (verbose)
+    printf ("recursive: fib (27) on %d threads: %.3f ms\n",
+	    omp_get_max_threads (), t * 1e3);
+  return 0;
+}
@@ -0,0 +1,5 @@
+/* { dg-do run } */
+/* { dg-options "-O2 -fopenmp" } */
+/* { dg-set-target-env-var GOMP_TASK_SCHEDULER "stealing" } */
+
+#include "task-spawn-1.c"
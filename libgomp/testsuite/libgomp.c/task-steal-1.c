@@ -0,0 +1,102 @@
+/* { dg-do run } */
+/* { dg-set-target-env-var GOMP_TASK_SCHEDULER "stealing" } */
+
+#include <omp.h>
+#include <stdlib.h>
+
+int cnt, xcnt;
+
+long
+fib (int n)
+{
+  long a, b;
+  if (n < 2)
+    return n;
+  #pragma omp task shared (a)
+  a = fib (n - 1);
+  #pragma omp task shared (b)
+  b = fib (n - 2);
+  #pragma omp taskwait
+  return a + b;
+}
+
+/* Children outliving their parents.  */
+
+void
+spawn (int n)
+{
+  if (n == 0)
+    {
+      #pragma omp atomic
+      cnt++;
+      return;
+    }
+  #pragma omp task
+  spawn (n - 1);
+  #pragma omp task
+  spawn (n - 1);
+}
+
+/* Stealable children of if(0) tasks, mixed with tasks with
+   dependencies.  */
+
+void
+mixed (int n)
+{
+  int y = 0, i;
+  #pragma omp task if (0)
+  {
+    for (i = 0; i < 16; i++)
+      #pragma omp task
+      {
+	#pragma omp atomic
+	xcnt++;
+      }
+  }
+  #pragma omp task depend (out: y) shared (y)
+  {
+    #pragma omp task shared (y)
+    {
+      #pragma omp atomic
+      y++;
+    }
+    #pragma omp taskwait
+    y++;
+  }
+  #pragma omp task depend (in: y) shared (y)
+  if (y != 2)
+    abort ();
+  #pragma omp taskwait
+  if (y != 2)
+    abort ();
+  if (n)
+    mixed (n - 1);
+}
+
+int
+main ()
+{
+  long r = 0;
+  #pragma omp parallel num_threads (4)
+  #pragma omp single
+  r = fib (25);
+  if (r != 75025)
+    abort ();
+
+  #pragma omp parallel num_threads (4)
+  {
+    #pragma omp single nowait
+    spawn (12);
+    #pragma omp for schedule (static)
+    for (r = 0; r < 4; r++)
+      spawn (8);
+  }
+  if (cnt != 4096 + 4 * 256)
+    abort ();
+
+  #pragma omp parallel num_threads (4)
+  mixed (8);
+  if (xcnt != 4 * 9 * 16)
+    abort ();
+  return 0;
+}
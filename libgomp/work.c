@@ -115,6 +115,7 @@ gomp_init_work_share (struct gomp_work_share *ws, bool ordered,
     ws->ordered_team_ids = NULL;
   gomp_ptrlock_init (&ws->next_ws, NULL);
   ws->threads_completed = 0;
+  ws->ranges_alloc = NULL;
 }
 
 /* Do any needed destruction of gomp_work_share fields before it
@@ -126,6 +127,7 @@ gomp_fini_work_share (struct gomp_work_share *ws)
   gomp_mutex_destroy (&ws->lock);
   if (ws->ordered_team_ids != ws->inline_ordered_team_ids)
     free (ws->ordered_team_ids);
+  free (ws->ranges_alloc);
   gomp_ptrlock_destroy (&ws->next_ws);
 }
 
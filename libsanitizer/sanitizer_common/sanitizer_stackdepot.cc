@@ -103,9 +103,10 @@ static StackDesc *allocDesc(uptr size) {
   }
 }
 
-static u32 find(StackDesc *s, const uptr *stack, uptr size, u32 hash) {
-  // Searches linked list s for the stack, returns its id.
-  for (; s; s = s->link) {
+static u32 find(StackDesc *s, StackDesc *end, const uptr *stack, uptr size,
+                u32 hash) {
+  // Searches linked list s up to end for the stack, returns its id.
+  for (; s != end; s = s->link) {
     if (s->hash == hash && s->size == size) {
       uptr i = 0;
       for (; i < size; i++) {
@@ -119,46 +120,20 @@ static u32 find(StackDesc *s, const uptr *stack, uptr size, u32 hash) {
   return 0;
 }
 
-static StackDesc *lock(atomic_uintptr_t *p) {
-  // Uses the pointer lsb as mutex.
-  for (int i = 0;; i++) {
-    uptr cmp = atomic_load(p, memory_order_relaxed);
-    if ((cmp & 1) == 0
-        && atomic_compare_exchange_weak(p, &cmp, cmp | 1,
-                                        memory_order_acquire))
-      return (StackDesc*)cmp;
-    if (i < 10)
-      proc_yield(10);
-    else
-      internal_sched_yield();
-  }
-}
-
-static void unlock(atomic_uintptr_t *p, StackDesc *s) {
-  DCHECK_EQ((uptr)s & 1, 0);
-  atomic_store(p, (uptr)s, memory_order_release);
-}
-
 u32 StackDepotPut(const uptr *stack, uptr size) {
   if (stack == 0 || size == 0)
     return 0;
   uptr h = hash(stack, size);
   atomic_uintptr_t *p = &depot.tab[h % kTabSize];
   uptr v = atomic_load(p, memory_order_consume);
-  StackDesc *s = (StackDesc*)(v & ~1);
+  StackDesc *s = (StackDesc*)v;
   // First, try to find the existing stack.
-  u32 id = find(s, stack, size, h);
+  u32 id = find(s, 0, stack, size, h);
   if (id)
     return id;
-  // If failed, lock, retry and insert new.
-  StackDesc *s2 = lock(p);
-  if (s2 != s) {
-    id = find(s2, stack, size, h);
-    if (id) {
-      unlock(p, s2);
-      return id;
-    }
-  }
+  // If failed, insert new at the head of the list with a CAS.  Lists
+  // only grow at the head, so when the CAS fails we only need to search
+  // the entries that were inserted in the meantime.
   uptr part = (h % kTabSize) / kPartSize;
   id = atomic_fetch_add(&depot.seq[part], 1, memory_order_relaxed) + 1;
   stats.n_uniq_ids++;
@@ -166,14 +141,24 @@ u32 StackDepotPut(const uptr *stack, uptr size) {
   id |= part << kPartShift;
   CHECK_NE(id, 0);
   CHECK_EQ(id & (1u << 31), 0);
-  s = allocDesc(size);
-  s->id = id;
-  s->hash = h;
-  s->size = size;
-  internal_memcpy(s->stack, stack, size * sizeof(uptr));
-  s->link = s2;
-  unlock(p, s);
-  return id;
+  StackDesc *s2 = allocDesc(size);
+  s2->id = id;
+  s2->hash = h;
+  s2->size = size;
+  internal_memcpy(s2->stack, stack, size * sizeof(uptr));
+  for (;;) {
+    s2->link = s;
+    uptr cmp = (uptr)s;
+    if (atomic_compare_exchange_strong(p, &cmp, (uptr)s2,
+                                       memory_order_release))
+      return id;
+    // If another thread stored the same stack first, use its id.  S2 is
+    // then never published and its memory and id are lost.
+    u32 id2 = find((StackDesc*)cmp, s, stack, size, h);
+    if (id2)
+      return id2;
+    s = (StackDesc*)cmp;
+  }
 }
 
 const uptr *StackDepotGet(u32 id, uptr *size) {
@@ -187,7 +172,7 @@ const uptr *StackDepotGet(u32 id, uptr *size) {
     CHECK_LT(idx, kTabSize);
     atomic_uintptr_t *p = &depot.tab[idx];
     uptr v = atomic_load(p, memory_order_consume);
-    StackDesc *s = (StackDesc*)(v & ~1);
+    StackDesc *s = (StackDesc*)v;
     for (; s; s = s->link) {
       if (s->id == id) {
         *size = s->size;
@@ -210,7 +195,7 @@ StackDepotReverseMap::StackDepotReverseMap()
   for (int idx = 0; idx < kTabSize; idx++) {
     atomic_uintptr_t *p = &depot.tab[idx];
     uptr v = atomic_load(p, memory_order_consume);
-    StackDesc *s = (StackDesc*)(v & ~1);
+    StackDesc *s = (StackDesc*)v;
     for (; s; s = s->link) {
       IdDescPair pair = {s->id, s};
       map_.push_back(pair);
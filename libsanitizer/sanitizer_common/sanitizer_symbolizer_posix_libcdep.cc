@@ -13,6 +13,7 @@
 #include "sanitizer_platform.h"
 #if SANITIZER_POSIX
 #include "sanitizer_allocator_internal.h"
+#include "sanitizer_atomic.h"
 #include "sanitizer_common.h"
 #include "sanitizer_internal_defs.h"
 #include "sanitizer_linux.h"
@@ -390,9 +391,16 @@ class POSIXSymbolizer : public Symbolizer {
       : Symbolizer(),
         external_symbolizer_(external_symbolizer),
         internal_symbolizer_(internal_symbolizer),
-        libbacktrace_symbolizer_(libbacktrace_symbolizer) {}
+        libbacktrace_symbolizer_(libbacktrace_symbolizer) {
+    atomic_store(&modules_generation_, 0, memory_order_relaxed);
+    internal_memset(code_cache_, 0, sizeof(code_cache_));
+    code_cache_entries_ = 0;
+  }
 
   uptr SymbolizeCode(uptr addr, AddressInfo *frames, uptr max_frames) {
+    uptr cached = LookupCodeCache(addr, frames, max_frames);
+    if (cached > 0)
+      return cached;
     BlockingMutexLock l(&mu_);
     if (max_frames == 0)
       return 0;
@@ -406,8 +414,10 @@ class POSIXSymbolizer : public Symbolizer {
       mu_.CheckLocked();
       uptr res = libbacktrace_symbolizer_->SymbolizeCode(
           addr, frames, max_frames, module_name, module_offset);
-      if (res > 0)
+      if (res > 0) {
+        AddToCodeCache(addr, frames, res, res < max_frames);
         return res;
+      }
     }
     const char *str = SendCommand(false, module_name, module_offset);
     if (str == 0) {
@@ -458,6 +468,7 @@ class POSIXSymbolizer : public Symbolizer {
       info->FillAddressAndModuleInfo(addr, module_name, module_offset);
       frame_id = 1;
     }
+    AddToCodeCache(addr, frames, frame_id, frame_id < max_frames);
     return frame_id;
   }
 
@@ -530,6 +541,87 @@ class POSIXSymbolizer : public Symbolizer {
   }
 
  private:
+  // Symbolization results are cached by address, so that reports with
+  // many frames in common, such as TSan reports of many races in the
+  // same code, do not go through the symbolizer again and again.  The
+  // cache is a hash table of pointers to entries which are immutable
+  // once published and never freed, so looking up needs no lock.  An
+  // entry is valid only for the list of modules it was created with:
+  // reloading the list of modules (e.g. after dlopen) bumps
+  // modules_generation_ and so invalidates the whole cache.
+  struct CodeCacheEntry {
+    uptr address;
+    uptr modules_generation;
+    // Whether frames holds all frames for address, rather than only the
+    // first ones.
+    bool complete;
+    uptr n_frames;
+    AddressInfo frames[1];  // Actually n_frames elements.
+  };
+
+  static uptr CodeCacheSlot(uptr addr) {
+    return (addr * 0x9E3779B97F4A7C15ULL >> 20) % kCodeCacheSize;
+  }
+
+  uptr LookupCodeCache(uptr addr, AddressInfo *frames, uptr max_frames) {
+    const CodeCacheEntry *e = reinterpret_cast<const CodeCacheEntry *>(
+        atomic_load(&code_cache_[CodeCacheSlot(addr)], memory_order_acquire));
+    if (e == 0 || e->address != addr ||
+        e->modules_generation !=
+            atomic_load(&modules_generation_, memory_order_acquire) ||
+        (!e->complete && e->n_frames < max_frames))
+      return 0;
+    uptr n = Min(e->n_frames, max_frames);
+    for (uptr i = 0; i < n; i++) {
+      const AddressInfo &from = e->frames[i];
+      AddressInfo *to = &frames[i];
+      to->Clear();
+      to->FillAddressAndModuleInfo(addr, from.module, from.module_offset);
+      if (from.function)
+        to->function = internal_strdup(from.function);
+      if (from.file)
+        to->file = internal_strdup(from.file);
+      to->line = from.line;
+      to->column = from.column;
+    }
+    return n;
+  }
+
+  char *CacheString(const char *str) {
+    if (str == 0)
+      return 0;
+    uptr size = internal_strlen(str) + 1;
+    char *res = (char *)symbolizer_allocator_.Allocate(size);
+    internal_memcpy(res, str, size);
+    return res;
+  }
+
+  void AddToCodeCache(uptr addr, const AddressInfo *frames, uptr n_frames,
+                      bool complete) {
+    mu_.CheckLocked();
+    // Entries replaced in the table are leaked, so stop caching at some
+    // point rather than let colliding addresses use up memory.
+    if (code_cache_entries_ >= kMaxCodeCacheEntries)
+      return;
+    code_cache_entries_++;
+    CodeCacheEntry *e = (CodeCacheEntry *)symbolizer_allocator_.Allocate(
+        sizeof(CodeCacheEntry) + (n_frames - 1) * sizeof(AddressInfo));
+    e->address = addr;
+    e->modules_generation =
+        atomic_load(&modules_generation_, memory_order_relaxed);
+    e->complete = complete;
+    e->n_frames = n_frames;
+    for (uptr i = 0; i < n_frames; i++) {
+      AddressInfo *to = &e->frames[i];
+      *to = frames[i];
+      to->module = CacheString(frames[i].module);
+      to->function = CacheString(frames[i].function);
+      to->file = CacheString(frames[i].file);
+    }
+    atomic_store(&code_cache_[CodeCacheSlot(addr)], (uptr)e,
+                 memory_order_release);
+  }
+
   char *SendCommand(bool is_data, const char *module_name, uptr module_offset) {
     mu_.CheckLocked();
     // First, try to use internal symbolizer.
@@ -560,6 +652,9 @@ class POSIXSymbolizer : public Symbolizer {
       CHECK_LT(n_modules_, kMaxNumberOfModuleContexts);
       modules_fresh_ = true;
       modules_were_reloaded = true;
+      atomic_store(&modules_generation_,
+                   atomic_load(&modules_generation_, memory_order_relaxed) + 1,
+                   memory_order_release);
     }
     for (uptr i = 0; i < n_modules_; i++) {
       if (modules_[i].containsAddress(address)) {
@@ -583,8 +678,16 @@ class POSIXSymbolizer : public Symbolizer {
   uptr n_modules_;
   // If stale, need to reload the modules before looking up addresses.
   bool modules_fresh_;
+  // Incremented whenever the modules are reloaded.
+  atomic_uintptr_t modules_generation_;
   BlockingMutex mu_;
 
+  static const uptr kCodeCacheSize = 1 << 12;
+  static const uptr kMaxCodeCacheEntries = 4 * kCodeCacheSize;
+  atomic_uintptr_t code_cache_[kCodeCacheSize];
+  // Number of entries ever added to code_cache_.
+  uptr code_cache_entries_;
+
   ExternalSymbolizer *external_symbolizer_;        // Leaked.
   InternalSymbolizer *const internal_symbolizer_;  // Leaked.
   LibbacktraceSymbolizer *libbacktrace_symbolizer_;  // Leaked.
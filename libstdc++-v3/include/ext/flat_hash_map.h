@@ -0,0 +1,1065 @@
+// Open-addressing hash map -*- C++ -*-
+
+// Copyright (C) 2014 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file ext/flat_hash_map.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ */
+
+#ifndef _FLAT_HASH_MAP_H
+#define _FLAT_HASH_MAP_H 1
+
+#pragma GCC system_header
+
+#if __cplusplus < 201103L
+# include <bits/c++0x_warning.h>
+#else
+
+#include <bits/functional_hash.h>
+#include <bits/stl_function.h>
+#include <bits/stl_pair.h>
+#include <bits/functexcept.h>
+#include <bits/allocator.h>
+#include <bits/alloc_traits.h>
+#include <initializer_list>
+#include <type_traits>
+#include <tuple>
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+
+namespace __gnu_cxx _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  template<typename _Key, typename _Tp, typename _Hash, typename _Pred,
+	   typename _Alloc>
+    class flat_hash_map;
+
+namespace __detail
+{
+  // Each slot of a flat_hash_map has a control byte describing it:
+  // one of the negative values below if the slot holds no element, or
+  // seven bits of the hash of its key if it does.  Control bytes are
+  // examined a group at a time, so that a lookup usually inspects a
+  // single group of control bytes and compares a single key.
+  enum : signed char
+  {
+    _S_ctrl_empty = -128,
+    _S_ctrl_deleted = -2,
+    _S_ctrl_sentinel = -1
+  };
+
+  // A group of control bytes, and the masks of those in the group that
+  // match some condition; bit I of a mask describes byte I.
+  struct _Ctrl_group
+  {
+    static const std::size_t _S_width = 16;
+
+#ifdef __SSE2__
+    explicit
+    _Ctrl_group(const signed char* __p) noexcept
+    : _M_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(__p)))
+    { }
+
+    unsigned
+    _M_match(signed char __h) const noexcept
+    { return _mm_movemask_epi8(_mm_cmpeq_epi8(_mm_set1_epi8(__h), _M_ctrl)); }
+
+    unsigned
+    _M_match_empty() const noexcept
+    { return _M_match(_S_ctrl_empty); }
+
+    unsigned
+    _M_match_empty_or_deleted() const noexcept
+    {
+      return _mm_movemask_epi8(_mm_cmpgt_epi8(_mm_set1_epi8(_S_ctrl_sentinel),
+					      _M_ctrl));
+    }
+
+    __m128i _M_ctrl;
+#else
+    explicit
+    _Ctrl_group(const signed char* __p) noexcept
+    : _M_ctrl(__p)
+    { }
+
+    unsigned
+    _M_match(signed char __h) const noexcept
+    {
+      unsigned __m = 0;
+      for (std::size_t __i = 0; __i < _S_width; ++__i)
+	__m |= unsigned(_M_ctrl[__i] == __h) << __i;
+      return __m;
+    }
+
+    unsigned
+    _M_match_empty() const noexcept
+    { return _M_match(_S_ctrl_empty); }
+
+    unsigned
+    _M_match_empty_or_deleted() const noexcept
+    {
+      unsigned __m = 0;
+      for (std::size_t __i = 0; __i < _S_width; ++__i)
+	__m |= unsigned(_M_ctrl[__i] < _S_ctrl_sentinel) << __i;
+      return __m;
+    }
+
+    const signed char* _M_ctrl;
+#endif
+  };
+
+  template<typename _Value, bool _Const>
+    class _Flat_iterator
+    {
+      template<typename, typename, typename, typename, typename>
+	friend class __gnu_cxx::flat_hash_map;
+      template<typename, bool>
+	friend class _Flat_iterator;
+
+    public:
+      typedef std::forward_iterator_tag			iterator_category;
+      typedef _Value					value_type;
+      typedef std::ptrdiff_t				difference_type;
+      typedef typename std::conditional<_Const, const _Value*,
+					_Value*>::type	pointer;
+      typedef typename std::conditional<_Const, const _Value&,
+					_Value&>::type	reference;
+
+      _Flat_iterator() noexcept
+      : _M_ctrl(), _M_slot() { }
+
+      // Allow conversion from iterator to const_iterator.
+      template<bool _Other, typename = typename
+	       std::enable_if<_Const && !_Other>::type>
+	_Flat_iterator(const _Flat_iterator<_Value, _Other>& __it) noexcept
+	: _M_ctrl(__it._M_ctrl), _M_slot(__it._M_slot) { }
+
+      reference
+      operator*() const noexcept
+      { return *_M_slot; }
+
+      pointer
+      operator->() const noexcept
+      { return _M_slot; }
+
+      _Flat_iterator&
+      operator++() noexcept
+      {
+	++_M_ctrl;
+	++_M_slot;
+	_M_skip_empty();
+	return *this;
+      }
+
+      _Flat_iterator
+      operator++(int) noexcept
+      {
+	_Flat_iterator __tmp(*this);
+	++*this;
+	return __tmp;
+      }
+
+      friend bool
+      operator==(const _Flat_iterator& __x, const _Flat_iterator& __y) noexcept
+      { return __x._M_slot == __y._M_slot; }
+
+      friend bool
+      operator!=(const _Flat_iterator& __x, const _Flat_iterator& __y) noexcept
+      { return __x._M_slot != __y._M_slot; }
+
+    private:
+      _Flat_iterator(const signed char* __ctrl, _Value* __slot) noexcept
+      : _M_ctrl(__ctrl), _M_slot(__slot) { }
+
+      // Advance to the next full slot, or to the sentinel control byte
+      // that follows the last slot.
+      void
+      _M_skip_empty() noexcept
+      {
+	while (*_M_ctrl < _S_ctrl_sentinel)
+	  {
+	    ++_M_ctrl;
+	    ++_M_slot;
+	  }
+      }
+
+      const signed char* _M_ctrl;
+      _Value* _M_slot;
+    };
+
+  template<typename _Tp, typename = void>
+    struct __is_transparent : std::false_type { };
+
+  template<typename _Tp>
+    struct __is_transparent<_Tp, decltype(void(sizeof(typename
+						      _Tp::is_transparent)))>
+    : std::true_type { };
+} // namespace __detail
+
+  /**
+   *  @class flat_hash_map flat_hash_map.h
+   *  @brief  An unordered associative container using open addressing.
+   *  @ingroup extensions
+   *
+   *  Elements are stored inline in a single array of slots rather than
+   *  in separately allocated nodes, and are found by probing groups of
+   *  one-byte tags derived from their hash, using SSE2 to examine a
+   *  whole group at a time where available.  Lookups of keys that are
+   *  present usually touch one cache line of tags and one element.
+   *
+   *  The interface follows std::unordered_map, with these differences:
+   *  - Inserting or erasing elements, and rehashing, invalidates all
+   *    iterators, pointers and references to elements.
+   *  - There is no bucket interface, and the maximum load factor is
+   *    fixed at 7/8.
+   *  - Keys are copied, not moved, when the table grows.
+   *  - If both the hash function and the key equality predicate define
+   *    is_transparent, find, count and equal_range accept any type that
+   *    they can be called with, without constructing a key_type.
+  */
+  template<typename _Key, typename _Tp,
+	   typename _Hash = std::hash<_Key>,
+	   typename _Pred = std::equal_to<_Key>,
+	   typename _Alloc = std::allocator<std::pair<const _Key, _Tp> > >
+    class flat_hash_map
+    {
+      typedef std::allocator_traits<_Alloc>			_Alloc_traits;
+      typedef typename _Alloc_traits::template
+	rebind_alloc<signed char>				_Ctrl_alloc_type;
+      typedef std::allocator_traits<_Ctrl_alloc_type>		_Ctrl_alloc_traits;
+      typedef __detail::_Ctrl_group				_Group;
+
+      template<typename _Kt>
+	using _Transparent = typename std::enable_if<
+	  __detail::__is_transparent<_Hash>::value
+	  && __detail::__is_transparent<_Pred>::value, _Kt>::type;
+
+    public:
+      typedef _Key					key_type;
+      typedef _Tp					mapped_type;
+      typedef std::pair<const _Key, _Tp>		value_type;
+      typedef _Hash					hasher;
+      typedef _Pred					key_equal;
+      typedef _Alloc					allocator_type;
+      typedef std::size_t				size_type;
+      typedef std::ptrdiff_t				difference_type;
+      typedef value_type&				reference;
+      typedef const value_type&				const_reference;
+      typedef typename _Alloc_traits::pointer		pointer;
+      typedef typename _Alloc_traits::const_pointer	const_pointer;
+      typedef __detail::_Flat_iterator<value_type, false>	iterator;
+      typedef __detail::_Flat_iterator<value_type, true>	const_iterator;
+
+      // construct/destroy/copy
+
+      flat_hash_map()
+      : flat_hash_map(0) { }
+
+      explicit
+      flat_hash_map(size_type __n,
+		    const hasher& __hf = hasher(),
+		    const key_equal& __eql = key_equal(),
+		    const allocator_type& __a = allocator_type())
+      : _M_impl(__hf, __eql, __a)
+      { reserve(__n); }
+
+      explicit
+      flat_hash_map(const allocator_type& __a)
+      : _M_impl(hasher(), key_equal(), __a)
+      { }
+
+      template<typename _InputIterator>
+	flat_hash_map(_InputIterator __first, _InputIterator __last,
+		      size_type __n = 0,
+		      const hasher& __hf = hasher(),
+		      const key_equal& __eql = key_equal(),
+		      const allocator_type& __a = allocator_type())
+	: flat_hash_map(__n, __hf, __eql, __a)
+	{ insert(__first, __last); }
+
+      flat_hash_map(std::initializer_list<value_type> __l,
+		    size_type __n = 0,
+		    const hasher& __hf = hasher(),
+		    const key_equal& __eql = key_equal(),
+		    const allocator_type& __a = allocator_type())
+      : flat_hash_map(__n ? __n : __l.size(), __hf, __eql, __a)
+      { insert(__l); }
+
+      flat_hash_map(const flat_hash_map& __x)
+      : _M_impl(__x._M_impl._M_hash, __x._M_impl._M_eq,
+		_Alloc_traits::select_on_container_copy_construction
+		  (__x._M_impl))
+      {
+	reserve(__x.size());
+	for (const value_type& __v : __x)
+	  _M_insert_new(__v.first, __v);
+      }
+
+      flat_hash_map(flat_hash_map&& __x) noexcept
+      : _M_impl(std::move(__x._M_impl))
+      { __x._M_impl._M_reset(); }
+
+      ~flat_hash_map() noexcept
+      { _M_deallocate(); }
+
+      flat_hash_map&
+      operator=(const flat_hash_map& __x)
+      {
+	if (&__x != this)
+	  {
+	    // The table must be freed by the allocator that allocated it.
+	    if (_Alloc_traits::propagate_on_container_copy_assignment::value
+		&& _M_get_allocator() != __x._M_get_allocator())
+	      _M_deallocate();
+	    std::__alloc_on_copy(_M_get_allocator(), __x._M_get_allocator());
+	    clear();
+	    _M_impl._M_hash = __x._M_impl._M_hash;
+	    _M_impl._M_eq = __x._M_impl._M_eq;
+	    reserve(__x.size());
+	    for (const value_type& __v : __x)
+	      _M_insert_new(__v.first, __v);
+	  }
+	return *this;
+      }
+
+      flat_hash_map&
+      operator=(flat_hash_map&& __x)
+      {
+	if (&__x == this)
+	  return *this;
+	if (_Alloc_traits::propagate_on_container_move_assignment::value
+	    || _M_get_allocator() == __x._M_get_allocator())
+	  {
+	    _M_deallocate();
+	    std::__alloc_on_move(_M_get_allocator(), __x._M_get_allocator());
+	    _M_impl._M_steal(__x._M_impl);
+	    __x._M_impl._M_reset();
+	  }
+	else
+	  {
+	    clear();
+	    _M_impl._M_hash = __x._M_impl._M_hash;
+	    _M_impl._M_eq = __x._M_impl._M_eq;
+	    reserve(__x.size());
+	    for (value_type& __v : __x)
+	      _M_insert_new(__v.first, std::move(__v));
+	    __x.clear();
+	  }
+	return *this;
+      }
+
+      flat_hash_map&
+      operator=(std::initializer_list<value_type> __l)
+      {
+	clear();
+	insert(__l);
+	return *this;
+      }
+
+      allocator_type
+      get_allocator() const noexcept
+      { return allocator_type(_M_impl); }
+
+      // size and capacity
+
+      bool
+      empty() const noexcept
+      { return _M_impl._M_size == 0; }
+
+      size_type
+      size() const noexcept
+      { return _M_impl._M_size; }
+
+      size_type
+      max_size() const noexcept
+      { return _Alloc_traits::max_size(_M_impl); }
+
+      /// Number of slots in the table.
+      size_type
+      bucket_count() const noexcept
+      { return _M_impl._M_capacity; }
+
+      float
+      load_factor() const noexcept
+      {
+	return _M_impl._M_capacity
+	       ? float(size()) / float(_M_impl._M_capacity) : 0.0f;
+      }
+
+      float
+      max_load_factor() const noexcept
+      { return 7.0f / 8.0f; }
+
+      // iterators
+
+      iterator
+      begin() noexcept
+      { return _M_iterator_at(0, true); }
+
+      const_iterator
+      begin() const noexcept
+      { return cbegin(); }
+
+      const_iterator
+      cbegin() const noexcept
+      { return const_cast<flat_hash_map*>(this)->begin(); }
+
+      iterator
+      end() noexcept
+      { return _M_iterator_at(_M_impl._M_capacity, false); }
+
+      const_iterator
+      end() const noexcept
+      { return cend(); }
+
+      const_iterator
+      cend() const noexcept
+      { return const_cast<flat_hash_map*>(this)->end(); }
+
+      // modifiers
+
+      template<typename... _Args>
+	std::pair<iterator, bool>
+	emplace(_Args&&... __args)
+	{
+	  // The key is not known until the element is constructed.
+	  value_type __v(std::forward<_Args>(__args)...);
+	  return _M_insert_unique(__v.first, std::move(__v));
+	}
+
+      template<typename... _Args>
+	iterator
+	emplace_hint(const_iterator, _Args&&... __args)
+	{ return emplace(std::forward<_Args>(__args)...).first; }
+
+      std::pair<iterator, bool>
+      insert(const value_type& __v)
+      { return _M_insert_unique(__v.first, __v); }
+
+      std::pair<iterator, bool>
+      insert(value_type&& __v)
+      { return _M_insert_unique(__v.first, std::move(__v)); }
+
+      template<typename _Pair, typename = typename
+	       std::enable_if<std::is_constructible<value_type,
+						    _Pair&&>::value>::type>
+	std::pair<iterator, bool>
+	insert(_Pair&& __v)
+	{ return emplace(std::forward<_Pair>(__v)); }
+
+      iterator
+      insert(const_iterator, const value_type& __v)
+      { return insert(__v).first; }
+
+      iterator
+      insert(const_iterator, value_type&& __v)
+      { return insert(std::move(__v)).first; }
+
+      template<typename _InputIterator>
+	void
+	insert(_InputIterator __first, _InputIterator __last)
+	{
+	  for (; __first != __last; ++__first)
+	    insert(*__first);
+	}
+
+      void
+      insert(std::initializer_list<value_type> __l)
+      { insert(__l.begin(), __l.end()); }
+
+      /**
+       *  @brief Insert a new element with key @a __k and a mapped value
+       *  constructed from @a __args, unless an element with an
+       *  equivalent key already exists.  Unlike emplace, this does not
+       *  construct anything if the key is present.
+       */
+      template<typename... _Args>
+	std::pair<iterator, bool>
+	try_emplace(const key_type& __k, _Args&&... __args)
+	{
+	  return _M_insert_unique(__k, std::piecewise_construct,
+				  std::forward_as_tuple(__k),
+				  std::forward_as_tuple
+				    (std::forward<_Args>(__args)...));
+	}
+
+      template<typename... _Args>
+	std::pair<iterator, bool>
+	try_emplace(key_type&& __k, _Args&&... __args)
+	{
+	  return _M_insert_unique(__k, std::piecewise_construct,
+				  std::forward_as_tuple(std::move(__k)),
+				  std::forward_as_tuple
+				    (std::forward<_Args>(__args)...));
+	}
+
+      iterator
+      erase(const_iterator __position)
+      {
+	iterator __it(__position._M_ctrl,
+		      const_cast<value_type*>(__position._M_slot));
+	_M_erase_at(__it._M_slot - _M_impl._M_slots);
+	++__it;
+	return __it;
+      }
+
+      iterator
+      erase(iterator __position)
+      { return erase(const_iterator(__position)); }
+
+      size_type
+      erase(const key_type& __k)
+      {
+	size_type __i = _M_find_index(__k);
+	if (__i == _M_impl._M_capacity)
+	  return 0;
+	_M_erase_at(__i);
+	return 1;
+      }
+
+      iterator
+      erase(const_iterator __first, const_iterator __last)
+      {
+	while (__first != __last)
+	  __first = erase(__first);
+	return iterator(__last._M_ctrl,
+			const_cast<value_type*>(__last._M_slot));
+      }
+
+      void
+      clear() noexcept
+      {
+	for (size_type __i = 0; __i < _M_impl._M_capacity; ++__i)
+	  if (_M_impl._M_ctrl[__i] >= 0)
+	    {
+	      _Alloc_traits::destroy(_M_get_allocator(),
+				     _M_impl._M_slots + __i);
+	      _M_impl._M_ctrl[__i] = __detail::_S_ctrl_empty;
+	    }
+	_M_impl._M_size = 0;
+	_M_impl._M_growth_left = _S_growth(_M_impl._M_capacity);
+      }
+
+      void
+      swap(flat_hash_map& __x)
+      noexcept(noexcept(std::swap(std::declval<_Hash&>(),
+				  std::declval<_Hash&>()))
+	       && noexcept(std::swap(std::declval<_Pred&>(),
+				     std::declval<_Pred&>())))
+      {
+	using std::swap;
+	if (_Alloc_traits::propagate_on_container_swap::value)
+	  swap(_M_get_allocator(), __x._M_get_allocator());
+	swap(_M_impl._M_hash, __x._M_impl._M_hash);
+	swap(_M_impl._M_eq, __x._M_impl._M_eq);
+	swap(_M_impl._M_ctrl, __x._M_impl._M_ctrl);
+	swap(_M_impl._M_slots, __x._M_impl._M_slots);
+	swap(_M_impl._M_capacity, __x._M_impl._M_capacity);
+	swap(_M_impl._M_size, __x._M_impl._M_size);
+	swap(_M_impl._M_growth_left, __x._M_impl._M_growth_left);
+      }
+
+      // observers
+
+      hasher
+      hash_function() const
+      { return _M_impl._M_hash; }
+
+      key_equal
+      key_eq() const
+      { return _M_impl._M_eq; }
+
+      // lookup
+
+      iterator
+      find(const key_type& __k)
+      { return _M_iterator_at(_M_find_index(__k), false); }
+
+      const_iterator
+      find(const key_type& __k) const
+      { return const_cast<flat_hash_map*>(this)->find(__k); }
+
+      template<typename _Kt, typename = _Transparent<_Kt> >
+	iterator
+	find(const _Kt& __k)
+	{ return _M_iterator_at(_M_find_index(__k), false); }
+
+      template<typename _Kt, typename = _Transparent<_Kt> >
+	const_iterator
+	find(const _Kt& __k) const
+	{ return const_cast<flat_hash_map*>(this)->find(__k); }
+
+      size_type
+      count(const key_type& __k) const
+      { return _M_find_index(__k) != _M_impl._M_capacity; }
+
+      template<typename _Kt, typename = _Transparent<_Kt> >
+	size_type
+	count(const _Kt& __k) const
+	{ return _M_find_index(__k) != _M_impl._M_capacity; }
+
+      std::pair<iterator, iterator>
+      equal_range(const key_type& __k)
+      { return _M_equal_range(find(__k)); }
+
+      std::pair<const_iterator, const_iterator>
+      equal_range(const key_type& __k) const
+      { return const_cast<flat_hash_map*>(this)->equal_range(__k); }
+
+      template<typename _Kt, typename = _Transparent<_Kt> >
+	std::pair<iterator, iterator>
+	equal_range(const _Kt& __k)
+	{ return _M_equal_range(find(__k)); }
+
+      template<typename _Kt, typename = _Transparent<_Kt> >
+	std::pair<const_iterator, const_iterator>
+	equal_range(const _Kt& __k) const
+	{ return const_cast<flat_hash_map*>(this)->equal_range(__k); }
+
+      mapped_type&
+      operator[](const key_type& __k)
+      { return try_emplace(__k).first->second; }
+
+      mapped_type&
+      operator[](key_type&& __k)
+      { return try_emplace(std::move(__k)).first->second; }
+
+      mapped_type&
+      at(const key_type& __k)
+      {
+	size_type __i = _M_find_index(__k);
+	if (__i == _M_impl._M_capacity)
+	  std::__throw_out_of_range(__N("flat_hash_map::at"));
+	return _M_impl._M_slots[__i].second;
+      }
+
+      const mapped_type&
+      at(const key_type& __k) const
+      { return const_cast<flat_hash_map*>(this)->at(__k); }
+
+      // hash policy
+
+      /// Make room for at least @a __n elements without rehashing.
+      void
+      reserve(size_type __n)
+      {
+	if (__n > _S_growth(_M_impl._M_capacity))
+	  _M_rehash(_S_capacity_for(__n));
+      }
+
+      /// Rehash to at least @a __n slots, or fewer if they would not
+      /// leave room for the current elements.
+      void
+      rehash(size_type __n)
+      {
+	size_type __cap = _S_capacity_for(size());
+	while (__cap < __n)
+	  __cap *= 2;
+	if (__cap != _M_impl._M_capacity || size() == 0)
+	  _M_rehash(size() || __n ? __cap : 0);
+      }
+
+    private:
+      // The allocator is the base of _M_impl, to take advantage of the
+      // empty base optimization.
+      struct _Impl : public _Alloc
+      {
+	_Impl(const _Hash& __hf, const _Pred& __eql, const _Alloc& __a)
+	: _Alloc(__a), _M_hash(__hf), _M_eq(__eql)
+	{ _M_reset(); }
+
+	_Impl(_Impl&& __x)
+	: _Alloc(std::move(static_cast<_Alloc&>(__x))),
+	  _M_hash(std::move(__x._M_hash)), _M_eq(std::move(__x._M_eq))
+	{ _M_steal(__x); }
+
+	void
+	_M_reset() noexcept
+	{
+	  _M_ctrl = _S_empty_group();
+	  _M_slots = 0;
+	  _M_capacity = 0;
+	  _M_size = 0;
+	  _M_growth_left = 0;
+	}
+
+	void
+	_M_steal(_Impl& __x) noexcept
+	{
+	  _M_ctrl = __x._M_ctrl;
+	  _M_slots = __x._M_slots;
+	  _M_capacity = __x._M_capacity;
+	  _M_size = __x._M_size;
+	  _M_growth_left = __x._M_growth_left;
+	}
+
+	_Hash _M_hash;
+	_Pred _M_eq;
+	// _M_capacity control bytes, followed by a sentinel for iterators.
+	signed char* _M_ctrl;
+	value_type* _M_slots;
+	size_type _M_capacity;
+	size_type _M_size;
+	// Number of empty slots that can be filled before rehashing.
+	size_type _M_growth_left;
+      };
+
+      _Impl _M_impl;
+
+      // The control bytes of a table with no slots, which consist of just
+      // the sentinel.
+      static signed char*
+      _S_empty_group() noexcept
+      {
+	static signed char __sentinel = __detail::_S_ctrl_sentinel;
+	return &__sentinel;
+      }
+
+      _Alloc&
+      _M_get_allocator() noexcept
+      { return _M_impl; }
+
+      const _Alloc&
+      _M_get_allocator() const noexcept
+      { return _M_impl; }
+
+      // The maximum number of elements in a table of __cap slots.
+      static size_type
+      _S_growth(size_type __cap) noexcept
+      { return __cap - __cap / 8; }
+
+      // The number of slots needed for __n elements.
+      static size_type
+      _S_capacity_for(size_type __n) noexcept
+      {
+	size_type __cap = _Group::_S_width;
+	while (_S_growth(__cap) < __n)
+	  __cap *= 2;
+	return __cap;
+      }
+
+      // Mix the bits of a hash, since std::hash is the identity for
+      // integers.  The low seven bits of the result are the tag stored in
+      // the control byte, and the rest select the first group to probe.
+      template<typename _Kt>
+	std::size_t
+	_M_hash_code(const _Kt& __k) const
+	{ return _S_mix(_M_impl._M_hash(__k)); }
+
+      static std::size_t
+      _S_mix(std::size_t __h) noexcept
+      {
+	const int __bits = sizeof(std::size_t) * __CHAR_BIT__;
+	__h *= std::size_t(0x9e3779b97f4a7c15ULL);
+	return __h ^ (__h >> (__bits / 2));
+      }
+
+      static signed char
+      _S_tag(std::size_t __h) noexcept
+      { return static_cast<signed char>(__h & 0x7f); }
+
+      static std::size_t
+      _S_group(std::size_t __h) noexcept
+      { return __h >> 7; }
+
+      iterator
+      _M_iterator_at(size_type __i, bool __skip) noexcept
+      {
+	iterator __it(_M_impl._M_ctrl + __i, _M_impl._M_slots + __i);
+	if (__skip)
+	  __it._M_skip_empty();
+	return __it;
+      }
+
+      std::pair<iterator, iterator>
+      _M_equal_range(iterator __it)
+      {
+	iterator __next = __it;
+	if (__it != end())
+	  ++__next;
+	return std::make_pair(__it, __next);
+      }
+
+      // Return the index of the element with key __k, or _M_capacity if
+      // there is none.  Groups are probed in a triangular sequence, which
+      // visits every group of a power-of-two sized table.
+      template<typename _Kt>
+	size_type
+	_M_find_index(const _Kt& __k) const
+	{
+	  if (_M_impl._M_size == 0)
+	    return _M_impl._M_capacity;
+	  const std::size_t __h = _M_hash_code(__k);
+	  const signed char __tag = _S_tag(__h);
+	  const size_type __mask = _M_impl._M_capacity / _Group::_S_width - 1;
+	  size_type __g = _S_group(__h) & __mask;
+	  for (size_type __step = 1; ; ++__step)
+	    {
+	      const size_type __base = __g * _Group::_S_width;
+	      _Group __group(_M_impl._M_ctrl + __base);
+	      for (unsigned __m = __group._M_match(__tag); __m; __m &= __m - 1)
+		{
+		  size_type __i = __base + __builtin_ctz(__m);
+		  if (__builtin_expect(_M_impl._M_eq(_M_impl._M_slots[__i].first,
+						     __k), 1))
+		    return __i;
+		}
+	      if (__builtin_expect(__group._M_match_empty() != 0, 1))
+		return _M_impl._M_capacity;
+	      __g = (__g + __step) & __mask;
+	    }
+	}
+
+      // Return the index of the first slot along the probe sequence of
+      // hash __h that is empty or deleted.  There is always one, since
+      // _M_growth_left keeps some slots empty.
+      size_type
+      _M_find_free(std::size_t __h) const noexcept
+      { return _S_find_free(_M_impl._M_ctrl, _M_impl._M_capacity, __h); }
+
+      static size_type
+      _S_find_free(const signed char* __ctrl, size_type __cap,
+		   std::size_t __h) noexcept
+      {
+	const size_type __mask = __cap / _Group::_S_width - 1;
+	size_type __g = _S_group(__h) & __mask;
+	for (size_type __step = 1; ; ++__step)
+	  {
+	    _Group __group(__ctrl + __g * _Group::_S_width);
+	    if (unsigned __m = __group._M_match_empty_or_deleted())
+	      return __g * _Group::_S_width + __builtin_ctz(__m);
+	    __g = (__g + __step) & __mask;
+	  }
+      }
+
+      // Insert a new element, constructed from __args, with key __k,
+      // unless there is an element with key __k already.
+      template<typename... _Args>
+	std::pair<iterator, bool>
+	_M_insert_unique(const key_type& __k, _Args&&... __args)
+	{
+	  size_type __i = _M_find_index(__k);
+	  if (__i != _M_impl._M_capacity)
+	    return std::make_pair(_M_iterator_at(__i, false), false);
+	  __i = _M_insert_new(__k, std::forward<_Args>(__args)...);
+	  return std::make_pair(_M_iterator_at(__i, false), true);
+	}
+
+      // Insert a new element, constructed from __args, with key __k, which
+      // is known not to be present.  Return its index.
+      template<typename... _Args>
+	size_type
+	_M_insert_new(const key_type& __k, _Args&&... __args)
+	{
+	  const std::size_t __h = _M_hash_code(__k);
+	  size_type __i;
+	  if (_M_impl._M_capacity == 0)
+	    _M_rehash(_Group::_S_width);
+	  __i = _M_find_free(__h);
+	  if (_M_impl._M_growth_left == 0
+	      && _M_impl._M_ctrl[__i] == __detail::_S_ctrl_empty)
+	    {
+	      // Grow if the table is getting full of elements, otherwise
+	      // rehash at the same size to get rid of deleted slots.
+	      size_type __cap = _M_impl._M_capacity;
+	      if (_M_impl._M_size >= _S_growth(__cap) / 2)
+		__cap *= 2;
+	      _M_rehash(__cap);
+	      __i = _M_find_free(__h);
+	    }
+	  _Alloc_traits::construct(_M_get_allocator(), _M_impl._M_slots + __i,
+				   std::forward<_Args>(__args)...);
+	  if (_M_impl._M_ctrl[__i] == __detail::_S_ctrl_empty)
+	    --_M_impl._M_growth_left;
+	  _M_impl._M_ctrl[__i] = _S_tag(__h);
+	  ++_M_impl._M_size;
+	  return __i;
+	}
+
+      // Destroy the element at index __i.  Its slot can be marked empty
+      // if its group has an empty slot already, since then no probe
+      // sequence can have continued past that group.  Otherwise it must
+      // be marked deleted, so that lookups keep probing.
+      void
+      _M_erase_at(size_type __i)
+      {
+	_Alloc_traits::destroy(_M_get_allocator(), _M_impl._M_slots + __i);
+	--_M_impl._M_size;
+	size_type __base = __i - __i % _Group::_S_width;
+	if (_Group(_M_impl._M_ctrl + __base)._M_match_empty())
+	  {
+	    _M_impl._M_ctrl[__i] = __detail::_S_ctrl_empty;
+	    ++_M_impl._M_growth_left;
+	  }
+	else
+	  _M_impl._M_ctrl[__i] = __detail::_S_ctrl_deleted;
+      }
+
+      // How rehashing gets mapped values out of the old table.  Keys are
+      // const, so they are copied, and a key copy or hash that throws
+      // after some mapped values have been moved would lose them.  So
+      // mapped values are only moved if nothing can throw, or, as with
+      // std::move_if_noexcept, if they cannot be copied.
+      typedef typename std::conditional<
+	(std::is_nothrow_copy_constructible<key_type>::value
+	 && std::is_nothrow_move_constructible<mapped_type>::value
+	 && noexcept(std::declval<const _Hash&>()
+		       (std::declval<const key_type&>())))
+	|| !std::is_copy_constructible<mapped_type>::value,
+	mapped_type&&, const mapped_type&>::type _Relocated_mapped;
+
+      // Move the elements into a new table of __cap slots, where __cap is
+      // zero or a power of two multiple of the group width.  If an
+      // exception is thrown, the old table is kept.
+      void
+      _M_rehash(size_type __cap)
+      {
+	_Ctrl_alloc_type __ctrl_alloc(_M_get_allocator());
+	signed char* __ctrl = _S_empty_group();
+	value_type* __slots = 0;
+
+	if (__cap)
+	  {
+	    __ctrl = std::__addressof(*_Ctrl_alloc_traits::allocate
+					(__ctrl_alloc, __cap + 1));
+	    __try
+	      {
+		__slots = std::__addressof(*_Alloc_traits::allocate
+					     (_M_get_allocator(), __cap));
+	      }
+	    __catch(...)
+	      {
+		_Ctrl_alloc_traits::deallocate(__ctrl_alloc, __ctrl, __cap + 1);
+		__throw_exception_again;
+	      }
+	    __builtin_memset(__ctrl, __detail::_S_ctrl_empty, __cap);
+	    __ctrl[__cap] = __detail::_S_ctrl_sentinel;
+	  }
+
+	signed char* __old_ctrl = _M_impl._M_ctrl;
+	value_type* __old_slots = _M_impl._M_slots;
+	size_type __old_cap = _M_impl._M_capacity;
+
+	__try
+	  {
+	    for (size_type __j = 0; __j < __old_cap; ++__j)
+	      if (__old_ctrl[__j] >= 0)
+		{
+		  value_type& __v = __old_slots[__j];
+		  const std::size_t __h = _M_hash_code(__v.first);
+		  size_type __i = _S_find_free(__ctrl, __cap, __h);
+		  _Alloc_traits::construct
+		    (_M_get_allocator(), __slots + __i,
+		     std::piecewise_construct,
+		     std::forward_as_tuple(__v.first),
+		     std::forward_as_tuple
+		       (static_cast<_Relocated_mapped>(__v.second)));
+		  __ctrl[__i] = _S_tag(__h);
+		}
+	  }
+	__catch(...)
+	  {
+	    if (__cap)
+	      {
+		for (size_type __i = 0; __i < __cap; ++__i)
+		  if (__ctrl[__i] >= 0)
+		    _Alloc_traits::destroy(_M_get_allocator(), __slots + __i);
+		_Ctrl_alloc_traits::deallocate(__ctrl_alloc, __ctrl, __cap + 1);
+		_Alloc_traits::deallocate(_M_get_allocator(), __slots, __cap);
+	      }
+	    __throw_exception_again;
+	  }
+
+	_M_impl._M_ctrl = __ctrl;
+	_M_impl._M_slots = __slots;
+	_M_impl._M_capacity = __cap;
+	_M_impl._M_growth_left = _S_growth(__cap) - _M_impl._M_size;
+
+	if (__old_cap)
+	  {
+	    for (size_type __j = 0; __j < __old_cap; ++__j)
+	      if (__old_ctrl[__j] >= 0)
+		_Alloc_traits::destroy(_M_get_allocator(), __old_slots + __j);
+	    _Ctrl_alloc_traits::deallocate(__ctrl_alloc, __old_ctrl,
+					   __old_cap + 1);
+	    _Alloc_traits::deallocate(_M_get_allocator(), __old_slots,
+				      __old_cap);
+	  }
+      }
+
+      void
+      _M_deallocate() noexcept
+      {
+	if (_M_impl._M_capacity)
+	  {
+	    clear();
+	    _Ctrl_alloc_type __ctrl_alloc(_M_get_allocator());
+	    _Ctrl_alloc_traits::deallocate(__ctrl_alloc, _M_impl._M_ctrl,
+					   _M_impl._M_capacity + 1);
+	    _Alloc_traits::deallocate(_M_get_allocator(), _M_impl._M_slots,
+				      _M_impl._M_capacity);
+	  }
+	_M_impl._M_reset();
+      }
+    };
+
+  template<typename _Key, typename _Tp, typename _Hash, typename _Pred,
+	   typename _Alloc>
+    inline void
+    swap(flat_hash_map<_Key, _Tp, _Hash, _Pred, _Alloc>& __x,
+	 flat_hash_map<_Key, _Tp, _Hash, _Pred, _Alloc>& __y)
+    noexcept(noexcept(__x.swap(__y)))
+    { __x.swap(__y); }
+
+  template<typename _Key, typename _Tp, typename _Hash, typename _Pred,
+	   typename _Alloc>
+    bool
+    operator==(const flat_hash_map<_Key, _Tp, _Hash, _Pred, _Alloc>& __x,
+	       const flat_hash_map<_Key, _Tp, _Hash, _Pred, _Alloc>& __y)
+    {
+      if (__x.size() != __y.size())
+	return false;
+      for (const auto& __v : __x)
+	{
+	  auto __it = __y.find(__v.first);
+	  if (__it == __y.end() || !bool(__it->second == __v.second))
+	    return false;
+	}
+      return true;
+    }
+
+  template<typename _Key, typename _Tp, typename _Hash, typename _Pred,
+	   typename _Alloc>
+    inline bool
+    operator!=(const flat_hash_map<_Key, _Tp, _Hash, _Pred, _Alloc>& __x,
+	       const flat_hash_map<_Key, _Tp, _Hash, _Pred, _Alloc>& __y)
+    { return !(__x == __y); }
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace
+
+#endif // C++11
+
+#endif /* _FLAT_HASH_MAP_H */
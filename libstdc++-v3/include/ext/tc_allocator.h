@@ -0,0 +1,427 @@
+// Thread-caching allocator -*- C++ -*-
+
+// Copyright (C) 2014 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file ext/tc_allocator.h
+ *  This file is a GNU extension to the Standard C++ Library.
+ */
+
+#ifndef _TC_ALLOCATOR_H
+#define _TC_ALLOCATOR_H 1
+
+#pragma GCC system_header
+
+#if __cplusplus < 201103L
+# include <bits/c++0x_warning.h>
+#else
+
+#include <cstdlib>
+#include <new>
+#include <type_traits>
+#include <bits/functexcept.h>
+#include <bits/move.h>
+#include <ext/atomicity.h>
+#include <ext/concurrence.h>
+
+namespace __gnu_cxx _GLIBCXX_VISIBILITY(default)
+{
+_GLIBCXX_BEGIN_NAMESPACE_VERSION
+
+  using std::size_t;
+  using std::ptrdiff_t;
+
+  /**
+   *  @brief  Base class for __tc_alloc.
+   *
+   *  Small requests are rounded up to one of _S_classes size classes.
+   *  Each thread keeps a private free list for every size class, so
+   *  allocation and deallocation normally take no lock at all.
+   *
+   *  Free blocks move between the thread caches and a set of _S_shards
+   *  central shards in batches of _S_batch blocks.  A thread whose
+   *  list for a class is empty takes a whole batch from its shard (or,
+   *  failing that, from another shard, or by carving new blocks out of
+   *  a chunk obtained from new).  A thread whose list grows to twice
+   *  _S_batch gives a batch back.  Blocks freed by a thread other than
+   *  the one that allocated them go to the freeing thread's cache like
+   *  any other, so cross-thread frees are batched too.  Each batch is
+   *  kept as a linked list whose head links to the next batch, so a
+   *  batch changes hands in constant time under the shard's lock.
+   *
+   *  Threads are spread over the shards round-robin, so that no single
+   *  lock is contended by all threads.  Each shard has a cache line to
+   *  itself.  When a thread exits, its cache is returned to its shard.
+   *  Blocks the thread allocates or frees after that, from the
+   *  destructors of other thread-local objects, go straight to and from
+   *  the first shard under its lock.  As with __pool_alloc, memory is
+   *  never returned to the operating system.
+   *
+   *  Requests larger than _S_max_bytes, and all requests if the
+   *  GLIBCXX_FORCE_NEW environment variable is set, go straight to
+   *  operator new.
+   */
+  class __tc_alloc_base
+  {
+  protected:
+    enum { _S_align = 16 };
+    enum { _S_max_bytes = 1024 };
+    enum { _S_classes = (size_t)_S_max_bytes / (size_t)_S_align };
+    enum { _S_batch = 32 };
+    enum { _S_shards = 8 };
+    enum { _S_chunk_bytes = 64 * 1024 };
+    enum { _S_cache_line = 64 };
+
+    struct _Block
+    {
+      _Block* _M_next;
+      // Only meaningful for the first block of a batch in a shard.
+      _Block* _M_next_batch;
+    };
+
+    struct alignas(_S_cache_line) _Shard
+    {
+      __mutex	_M_mutex;
+      _Block*	_M_batches[_S_classes];
+      // Unused part of the current chunk.
+      char*	_M_start;
+      char*	_M_end;
+    };
+
+    struct _Cache
+    {
+      _Block*	_M_free[_S_classes];
+      size_t	_M_count[_S_classes];
+      // One more than the index of this thread's shard, or zero if none
+      // has been chosen yet.
+      size_t	_M_shard;
+
+      ~_Cache()
+      {
+	_S_cache_destroyed() = true;
+	_Shard& __shard = _S_home_shard(*this);
+	for (size_t __c = 0; __c < _S_classes; ++__c)
+	  while (_M_free[__c])
+	    _S_give_batch(__shard, __c, *this);
+      }
+    };
+
+    static size_t
+    _S_class(size_t __bytes) noexcept
+    { return (__bytes - 1) / (size_t)_S_align; }
+
+    static size_t
+    _S_class_size(size_t __c) noexcept
+    { return (__c + 1) * (size_t)_S_align; }
+
+    static bool
+    _S_force_new()
+    {
+      static const bool __force = std::getenv("GLIBCXX_FORCE_NEW") != 0;
+      return __force;
+    }
+
+    static _Shard*
+    _S_get_shards()
+    {
+      static _Shard __shards[_S_shards];
+      return __shards;
+    }
+
+    static _Cache&
+    _S_get_cache() noexcept
+    {
+      static thread_local _Cache __cache;
+      return __cache;
+    }
+
+    // True once the calling thread's _Cache has been destroyed.  The
+    // flag is trivially destructible, so it stays valid until the
+    // thread is gone.
+    static bool&
+    _S_cache_destroyed() noexcept
+    {
+      static thread_local bool __destroyed;
+      return __destroyed;
+    }
+
+    static void*
+    _S_allocate(size_t __bytes)
+    {
+      const size_t __c = _S_class(__bytes);
+      if (__builtin_expect(_S_cache_destroyed(), false))
+	return _S_allocate_shared(__c);
+
+      _Cache& __cache = _S_get_cache();
+      _Block* __b = __cache._M_free[__c];
+      if (__builtin_expect(__b == 0, false))
+	__b = _S_refill(__cache, __c);
+      __cache._M_free[__c] = __b->_M_next;
+      --__cache._M_count[__c];
+      return __b;
+    }
+
+    static void
+    _S_deallocate(void* __p, size_t __bytes)
+    {
+      const size_t __c = _S_class(__bytes);
+      _Block* __b = static_cast<_Block*>(__p);
+      if (__builtin_expect(_S_cache_destroyed(), false))
+	{
+	  _S_deallocate_shared(__b, __c);
+	  return;
+	}
+
+      _Cache& __cache = _S_get_cache();
+      __b->_M_next = __cache._M_free[__c];
+      __cache._M_free[__c] = __b;
+      if (__builtin_expect(++__cache._M_count[__c] >= 2 * _S_batch, false))
+	_S_give_batch(_S_home_shard(__cache), __c, __cache);
+    }
+
+    // Take one block of class __c from the first shard, for a thread
+    // whose cache is gone.
+    static void*
+    _S_allocate_shared(size_t __c)
+    {
+      _Shard& __shard = _S_get_shards()[0];
+      _Block* __first = _S_take_batch(__shard, __c);
+      if (!__first)
+	__first = _S_carve(__shard, __c);
+      if (__first->_M_next)
+	_S_put_batch(__shard, __c, __first->_M_next);
+      return __first;
+    }
+
+    // Give the block __b of class __c to the first shard as a batch of
+    // its own, for a thread whose cache is gone.
+    static void
+    _S_deallocate_shared(_Block* __b, size_t __c)
+    {
+      __b->_M_next = 0;
+      _S_put_batch(_S_get_shards()[0], __c, __b);
+    }
+
+    // Return the shard of the thread owning __cache, choosing one first
+    // if necessary.
+    static _Shard&
+    _S_home_shard(_Cache& __cache)
+    {
+      if (!__cache._M_shard)
+	{
+	  static _Atomic_word __next_shard;
+	  __cache._M_shard = (__exchange_and_add_dispatch(&__next_shard, 1)
+			      % _S_shards) + 1;
+	}
+      return _S_get_shards()[__cache._M_shard - 1];
+    }
+
+    // Move up to _S_batch blocks of class __c from __cache to __shard.
+    static void
+    _S_give_batch(_Shard& __shard, size_t __c, _Cache& __cache)
+    {
+      _Block* __first = __cache._M_free[__c];
+      _Block* __last = __first;
+      size_t __n = 1;
+      for (; __n < _S_batch && __last->_M_next; ++__n)
+	__last = __last->_M_next;
+      __cache._M_free[__c] = __last->_M_next;
+      __cache._M_count[__c] -= __n;
+      __last->_M_next = 0;
+      _S_put_batch(__shard, __c, __first);
+    }
+
+    // Add the batch starting at __first to the batches of class __c in
+    // __shard.
+    static void
+    _S_put_batch(_Shard& __shard, size_t __c, _Block* __first)
+    {
+      __scoped_lock __sentry(__shard._M_mutex);
+      __first->_M_next_batch = __shard._M_batches[__c];
+      __shard._M_batches[__c] = __first;
+    }
+
+    // Take a batch of class __c from __shard, or return null.
+    static _Block*
+    _S_take_batch(_Shard& __shard, size_t __c)
+    {
+      __scoped_lock __sentry(__shard._M_mutex);
+      _Block* __first = __shard._M_batches[__c];
+      if (__first)
+	__shard._M_batches[__c] = __first->_M_next_batch;
+      return __first;
+    }
+
+    // Fill the empty list of class __c in __cache and return its first
+    // block.
+    static _Block*
+    _S_refill(_Cache& __cache, size_t __c)
+    {
+      _Shard* __shards = _S_get_shards();
+      const size_t __home = &_S_home_shard(__cache) - __shards;
+      _Block* __first = 0;
+      for (size_t __i = 0; __i < _S_shards && !__first; ++__i)
+	__first = _S_take_batch(__shards[(__home + __i) % _S_shards], __c);
+      if (!__first)
+	__first = _S_carve(__shards[__home], __c);
+
+      size_t __n = 0;
+      for (_Block* __b = __first; __b; __b = __b->_M_next)
+	++__n;
+      __cache._M_free[__c] = __first;
+      __cache._M_count[__c] = __n;
+      return __first;
+    }
+
+    // Carve a batch of new blocks of class __c from the current chunk
+    // of __shard, allocating a new chunk if necessary.  The tail of the
+    // old chunk is abandoned.
+    static _Block*
+    _S_carve(_Shard& __shard, size_t __c)
+    {
+      const size_t __size = _S_class_size(__c);
+      const size_t __bytes = __size * _S_batch;
+      char* __p;
+      {
+	__scoped_lock __sentry(__shard._M_mutex);
+	if (size_t(__shard._M_end - __shard._M_start) < __bytes)
+	  {
+	    __shard._M_start
+	      = static_cast<char*>(::operator new(size_t(_S_chunk_bytes)));
+	    __shard._M_end = __shard._M_start + _S_chunk_bytes;
+	  }
+	__p = __shard._M_start;
+	__shard._M_start += __bytes;
+      }
+
+      for (size_t __i = 0; __i < _S_batch - 1; ++__i)
+	reinterpret_cast<_Block*>(__p + __i * __size)->_M_next
+	  = reinterpret_cast<_Block*>(__p + (__i + 1) * __size);
+      reinterpret_cast<_Block*>(__p + (_S_batch - 1) * __size)->_M_next = 0;
+      return reinterpret_cast<_Block*>(__p);
+    }
+  };
+
+  /**
+   *  @brief  Allocator using per-thread caches and sharded free lists.
+   *  @ingroup allocators
+   *
+   *  Like __pool_alloc, this allocator has no state: all instances,
+   *  whatever their value_type, draw on the same pools and compare
+   *  equal.  So memory allocated through one __tc_alloc can be freed
+   *  through any other, containers using it can swap and splice freely,
+   *  and it can be rebound to any type.
+   */
+  template<typename _Tp>
+    class __tc_alloc : private __tc_alloc_base
+    {
+    public:
+      typedef size_t     size_type;
+      typedef ptrdiff_t  difference_type;
+      typedef _Tp*       pointer;
+      typedef const _Tp* const_pointer;
+      typedef _Tp&       reference;
+      typedef const _Tp& const_reference;
+      typedef _Tp        value_type;
+
+      template<typename _Tp1>
+        struct rebind
+        { typedef __tc_alloc<_Tp1> other; };
+
+      // _GLIBCXX_RESOLVE_LIB_DEFECTS
+      // 2103. propagate_on_container_move_assignment
+      typedef std::true_type propagate_on_container_move_assignment;
+
+      __tc_alloc() noexcept { }
+
+      __tc_alloc(const __tc_alloc&) noexcept { }
+
+      template<typename _Tp1>
+        __tc_alloc(const __tc_alloc<_Tp1>&) noexcept { }
+
+      ~__tc_alloc() noexcept { }
+
+      pointer
+      address(reference __x) const noexcept
+      { return std::__addressof(__x); }
+
+      const_pointer
+      address(const_reference __x) const noexcept
+      { return std::__addressof(__x); }
+
+      size_type
+      max_size() const noexcept
+      { return size_t(-1) / sizeof(_Tp); }
+
+      template<typename _Up, typename... _Args>
+        void
+        construct(_Up* __p, _Args&&... __args)
+	{ ::new((void *)__p) _Up(std::forward<_Args>(__args)...); }
+
+      template<typename _Up>
+        void
+        destroy(_Up* __p) { __p->~_Up(); }
+
+      pointer
+      allocate(size_type __n, const void* = 0)
+      {
+	if (__builtin_expect(__n == 0, false))
+	  return 0;
+	if (__n > this->max_size())
+	  std::__throw_bad_alloc();
+
+	const size_t __bytes = __n * sizeof(_Tp);
+	if (__bytes > size_t(_S_max_bytes) || _S_force_new())
+	  return static_cast<_Tp*>(::operator new(__bytes));
+	return static_cast<_Tp*>(_S_allocate(__bytes));
+      }
+
+      void
+      deallocate(pointer __p, size_type __n)
+      {
+	if (__builtin_expect(__n == 0 || __p == 0, false))
+	  return;
+
+	const size_t __bytes = __n * sizeof(_Tp);
+	if (__bytes > size_t(_S_max_bytes) || _S_force_new())
+	  ::operator delete(__p);
+	else
+	  _S_deallocate(__p, __bytes);
+      }
+    };
+
+  template<typename _Tp, typename _Up>
+    inline bool
+    operator==(const __tc_alloc<_Tp>&, const __tc_alloc<_Up>&) noexcept
+    { return true; }
+
+  template<typename _Tp, typename _Up>
+    inline bool
+    operator!=(const __tc_alloc<_Tp>&, const __tc_alloc<_Up>&) noexcept
+    { return false; }
+
+_GLIBCXX_END_NAMESPACE_VERSION
+} // namespace
+
+#endif // C++11
+
+#endif
@@ -34,7 +34,7 @@
 
 #include <bits/c++config.h>
 #include <bits/stl_function.h>
-#include <omp.h>
+#include <parallel/omp_compat.h>
 #include <parallel/features.h>
 #include <parallel/basic_iterator.h>
 #include <parallel/parallel.h>
@@ -84,7 +84,7 @@ namespace __gnu_parallel
   inline _ThreadIndex
   __get_max_threads() 
   { 
-    _ThreadIndex __i = omp_get_max_threads();
+    _ThreadIndex __i = __default_num_threads();
     return __i > 1 ? __i : 1; 
   }
 
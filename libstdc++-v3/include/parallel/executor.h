@@ -0,0 +1,370 @@
+// -*- C++ -*-
+
+// Copyright (C) 2014 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the terms
+// of the GNU General Public License as published by the Free Software
+// Foundation; either version 3, or (at your option) any later
+// version.
+
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file parallel/executor.h
+ *  @brief Executors on which parallel regions of the parallel mode
+ *  algorithms run.
+ *  This file is a GNU parallel extension to the Standard C++ Library.
+ *
+ *  The algorithms that run through an executor are sort and
+ *  stable_sort (multiway mergesort), partial_sum, for_each and the
+ *  other algorithms built on __for_each_template_random_access with
+ *  the balanced or unbalanced parallelism tags, and find and the other
+ *  algorithms built on __find_template.  These do not need -fopenmp
+ *  or libgomp.  The remaining algorithms use OpenMP directly.
+ */
+
+#ifndef _GLIBCXX_PARALLEL_EXECUTOR_H
+#define _GLIBCXX_PARALLEL_EXECUTOR_H 1
+
+#include <exception>
+#include <bits/stl_algobase.h>
+#include <bits/gthr.h>
+#include <ext/concurrence.h>
+#include <parallel/types.h>
+#include <parallel/omp_compat.h>
+#include <parallel/compatibility.h>
+
+namespace __gnu_parallel
+{
+  /** @brief Interface to a pool of threads running parallel regions.
+   *
+   *  A parallel region is a function called once by each thread of a
+   *  team, with the thread's index in the team and the size of the
+   *  team.  Threads of a team wait for each other with a _Barrier, so
+   *  all calls of one region must run concurrently.
+   *
+   *  Parallel mode uses the executor installed with set(), or a
+   *  _ThreadPoolExecutor if there is none.  An executor must stay
+   *  alive while it is installed.
+   */
+  class _Executor
+  {
+  public:
+    /** @brief Function run by each thread of a parallel region. */
+    typedef void (*_Body)(void* __arg, _ThreadIndex __iam,
+			  _ThreadIndex __num_threads);
+
+    virtual
+    ~_Executor() { }
+
+    /** @brief Run a parallel region.
+     *
+     *  Calls @c __body on a team of at least one and at most @c
+     *  __num_threads threads, the calling thread being thread 0, and
+     *  returns when all calls have returned.
+     *  @param __num_threads Largest team size wanted.
+     *  @param __body Function to call.
+     *  @param __arg First argument of @c __body.
+     *  @return Size of the team. */
+    virtual _ThreadIndex
+    _M_run(_ThreadIndex __num_threads, _Body __body, void* __arg) = 0;
+
+    /** @brief Get the current executor. */
+    static _Executor&
+    get();
+
+    /** @brief Install @c __e as the executor, or restore the default
+     *  one if @c __e is null.  Must not be called while a parallel
+     *  mode algorithm is running. */
+    static void
+    set(_Executor* __e)
+    { __atomic_store_n(&_S_current(), __e, __ATOMIC_RELEASE); }
+
+  private:
+    static _Executor*&
+    _S_current()
+    {
+      static _Executor* __current;
+      return __current;
+    }
+  };
+
+#ifdef _OPENMP
+  /** @brief Executor running parallel regions on OpenMP threads.
+   *  Only available with -fopenmp. */
+  class _OpenMPExecutor : public _Executor
+  {
+  public:
+    virtual _ThreadIndex
+    _M_run(_ThreadIndex __num_threads, _Body __body, void* __arg)
+    {
+      _ThreadIndex __team = 1;
+#     pragma omp parallel num_threads(__num_threads)
+      {
+	_ThreadIndex __iam = omp_get_thread_num();
+	_ThreadIndex __n = omp_get_num_threads();
+	if (__iam == 0)
+	  __team = __n;
+	__body(__arg, __iam, __n);
+      }
+      return __team;
+    }
+  };
+#endif
+
+  /** @brief Executor running parallel regions on a pool of threads
+   *  created with gthreads.
+   *
+   *  Threads are created the first time a team of their size is asked
+   *  for, and then wait for further regions.  Only one region runs on
+   *  the pool at a time: a region started while the pool is busy, for
+   *  example from within another region, runs on the calling thread
+   *  alone.  Destroying the pool stops and joins its threads; it must
+   *  not be running a region then.  The default pool is never
+   *  destroyed.
+   *
+   *  An exception leaving a region that runs on more than one thread
+   *  calls std::terminate, as one leaving an OpenMP parallel region
+   *  does: the other threads of the team may be waiting for the
+   *  throwing thread at a _Barrier.
+   */
+  class _ThreadPoolExecutor : public _Executor
+  {
+  public:
+    _ThreadPoolExecutor()
+    : _M_num_workers(0), _M_workers(0), _M_stop(false), _M_generation(0),
+      _M_team(1), _M_body(0), _M_arg(0), _M_pending(0) { }
+
+    virtual
+    ~_ThreadPoolExecutor()
+    {
+#if defined(__GTHREADS_CXX0X) && defined(__GTHREAD_HAS_COND)
+      {
+	__gnu_cxx::__scoped_lock __sentry(_M_mutex);
+	_M_stop = true;
+	_M_cond.broadcast();
+      }
+      while (_M_workers)
+	{
+	  _Worker* __w = _M_workers;
+	  _M_workers = __w->_M_next;
+	  __gthread_join(__w->_M_thread, 0);
+	  delete __w;
+	}
+#endif
+    }
+
+    virtual _ThreadIndex
+    _M_run(_ThreadIndex __num_threads, _Body __body, void* __arg)
+    {
+#if defined(__GTHREADS_CXX0X) && defined(__GTHREAD_HAS_COND)
+      if (__num_threads > 1 && __gthread_active_p()
+	  && __gthread_mutex_trylock(_M_run_mutex.gthread_mutex()) == 0)
+	{
+	  _ThreadIndex __team;
+	  {
+	    __gnu_cxx::__scoped_lock __sentry(_M_mutex);
+	    while (_M_num_workers < __num_threads - 1
+		   && _M_start_worker(_M_num_workers + 1))
+	      ++_M_num_workers;
+	    __team = std::min<_ThreadIndex>(__num_threads,
+					    _M_num_workers + 1);
+	    _M_team = __team;
+	    _M_body = __body;
+	    _M_arg = __arg;
+	    __atomic_store_n(&_M_pending, __team - 1, __ATOMIC_RELAXED);
+	    ++_M_generation;
+	    _M_cond.broadcast();
+	  }
+
+	  __try
+	    {
+	      __body(__arg, 0, __team);
+	    }
+	  __catch(...)
+	    {
+	      std::terminate();
+	    }
+	  _M_join();
+	  return __team;
+	}
+#endif
+      __body(__arg, 0, 1);
+      return 1;
+    }
+
+  private:
+    struct _Worker;
+
+#if defined(__GTHREADS_CXX0X) && defined(__GTHREAD_HAS_COND)
+    // Wait for the workers to finish the current region and release
+    // the pool.
+    void
+    _M_join()
+    {
+      while (__atomic_load_n(&_M_pending, __ATOMIC_ACQUIRE) != 0)
+	__yield();
+      _M_run_mutex.unlock();
+    }
+
+    struct _Worker
+    {
+      _ThreadPoolExecutor* _M_pool;
+      _ThreadIndex _M_iam;
+      unsigned long _M_generation;
+      __gthread_t _M_thread;
+      _Worker* _M_next;
+    };
+
+    // Start the thread that will be thread __iam of each team.  Called
+    // with _M_mutex held.
+    bool
+    _M_start_worker(_ThreadIndex __iam)
+    {
+      _Worker* __w = new _Worker;
+      __w->_M_pool = this;
+      __w->_M_iam = __iam;
+      __w->_M_generation = _M_generation;
+      if (__gthread_create(&__w->_M_thread, &_S_worker_main, __w) != 0)
+	{
+	  delete __w;
+	  return false;
+	}
+      __w->_M_next = _M_workers;
+      _M_workers = __w;
+      return true;
+    }
+
+    static void*
+    _S_worker_main(void* __arg)
+    {
+      _Worker* __w = static_cast<_Worker*>(__arg);
+      _ThreadPoolExecutor* __pool = __w->_M_pool;
+      for (;;)
+	{
+	  _ThreadIndex __team;
+	  _Body __body;
+	  void* __body_arg;
+	  {
+	    __gnu_cxx::__scoped_lock __sentry(__pool->_M_mutex);
+	    while (__pool->_M_generation == __w->_M_generation
+		   && !__pool->_M_stop)
+	      __pool->_M_cond.wait(&__pool->_M_mutex);
+	    if (__pool->_M_stop)
+	      return 0;
+	    __w->_M_generation = __pool->_M_generation;
+	    __team = __pool->_M_team;
+	    __body = __pool->_M_body;
+	    __body_arg = __pool->_M_arg;
+	  }
+
+	  if (__w->_M_iam < __team)
+	    {
+	      __try
+		{
+		  __body(__body_arg, __w->_M_iam, __team);
+		}
+	      __catch(...)
+		{
+		  std::terminate();
+		}
+	      __atomic_sub_fetch(&__pool->_M_pending, 1, __ATOMIC_RELEASE);
+	    }
+	}
+    }
+#endif
+
+    // Held by the thread running a region on the pool.
+    __gnu_cxx::__mutex _M_run_mutex;
+    // Protects the fields below except _M_pending.
+    __gnu_cxx::__mutex _M_mutex;
+#ifdef __GTHREAD_HAS_COND
+    __gnu_cxx::__cond _M_cond;
+#endif
+    _ThreadIndex _M_num_workers;
+    // The threads started, to be joined by the destructor.
+    _Worker* _M_workers;
+    // Set by the destructor to make the workers exit.
+    bool _M_stop;
+    unsigned long _M_generation;
+    _ThreadIndex _M_team;
+    _Body _M_body;
+    void* _M_arg;
+    // Number of workers still running the current region.
+    _ThreadIndex _M_pending;
+  };
+
+  inline _Executor&
+  _Executor::get()
+  {
+    _Executor* __e = __atomic_load_n(&_S_current(), __ATOMIC_ACQUIRE);
+    if (__e)
+      return *__e;
+    static _Executor* __default = new _ThreadPoolExecutor;
+    return *__default;
+  }
+
+  /** @brief Barrier for the threads of a parallel region. */
+  class _Barrier
+  {
+  public:
+    _Barrier() : _M_arrived(0), _M_generation(0) { }
+
+    /** @brief Wait until all @c __num_threads threads of the team
+     *  have called this. */
+    void
+    _M_wait(_ThreadIndex __num_threads)
+    {
+      unsigned int __generation
+	= __atomic_load_n(&_M_generation, __ATOMIC_ACQUIRE);
+      if (__atomic_add_fetch(&_M_arrived, 1, __ATOMIC_ACQ_REL)
+	  == __num_threads)
+	{
+	  __atomic_store_n(&_M_arrived, 0, __ATOMIC_RELAXED);
+	  __atomic_store_n(&_M_generation, __generation + 1,
+			   __ATOMIC_RELEASE);
+	}
+      else
+	while (__atomic_load_n(&_M_generation, __ATOMIC_ACQUIRE)
+	       == __generation)
+	  __yield();
+    }
+
+  private:
+    _ThreadIndex _M_arrived;
+    unsigned int _M_generation;
+  };
+
+  template<typename _Op>
+    void
+    __parallel_region_body(void* __op, _ThreadIndex __iam,
+			   _ThreadIndex __num_threads)
+    { (*static_cast<_Op*>(__op))(__iam, __num_threads); }
+
+  /** @brief Run a parallel region on the current executor.
+   *  @param __num_threads Largest team size wanted.
+   *  @param __op Functor called as @c __op(__iam, __num_threads) by
+   *  each thread of the team.
+   *  @return Size of the team. */
+  template<typename _Op>
+    inline _ThreadIndex
+    __parallel_region(_ThreadIndex __num_threads, _Op& __op)
+    {
+      return _Executor::get()._M_run(__num_threads,
+				     &__parallel_region_body<_Op>, &__op);
+    }
+} // end namespace
+
+#endif /* _GLIBCXX_PARALLEL_EXECUTOR_H */
@@ -38,6 +38,7 @@
 #include <parallel/features.h>
 #include <parallel/parallel.h>
 #include <parallel/compatibility.h>
+#include <parallel/executor.h>
 #include <parallel/equally_split.h>
 
 namespace __gnu_parallel
@@ -77,8 +78,75 @@ namespace __gnu_parallel
 	}
     }
 
+  /** @brief Lower @c *__result to @c __pos, atomically.
+   *  @return Whether @c *__result was lowered. */
+  template<typename _DifferenceTp>
+    inline bool
+    __find_lower_result(volatile _DifferenceTp* __result, _DifferenceTp __pos)
+    {
+      _DifferenceTp __old = *__result;
+      while (__pos < __old)
+	{
+	  if (__compare_and_swap(__result, __old, __pos))
+	    return true;
+	  __old = *__result;
+	}
+      return false;
+    }
+
 #if _GLIBCXX_FIND_EQUAL_SPLIT
 
+  /** @brief Parallel region of the equal splitting variant of
+   *  __find_template(). */
+  template<typename _RAIter1,
+           typename _RAIter2,
+           typename _Pred,
+           typename _Selector>
+    struct _FindEqualSplitRegion
+    {
+      typedef std::iterator_traits<_RAIter1> _TraitsType;
+      typedef typename _TraitsType::difference_type _DifferenceType;
+
+      _RAIter1 _M_begin1;
+      _RAIter2 _M_begin2;
+      _Pred _M_pred;
+      _Selector _M_selector;
+      _DifferenceType _M_length;
+      volatile _DifferenceType _M_result;
+
+      _FindEqualSplitRegion(_RAIter1 __begin1, _RAIter2 __begin2,
+			    _Pred __pred, _Selector __selector,
+			    _DifferenceType __length)
+      : _M_begin1(__begin1), _M_begin2(__begin2), _M_pred(__pred),
+	_M_selector(__selector), _M_length(__length), _M_result(__length) { }
+
+      void
+      operator()(_ThreadIndex __iam, _ThreadIndex __num_threads)
+      {
+	_DifferenceType __start
+	  = __equally_split_point(_M_length, __num_threads, __iam);
+	_DifferenceType __stop
+	  = __equally_split_point(_M_length, __num_threads, __iam + 1);
+
+	_RAIter1 __i1 = _M_begin1 + __start;
+	_RAIter2 __i2 = _M_begin2 + __start;
+	for (_DifferenceType __pos = __start; __pos < __stop; ++__pos)
+	  {
+	    // Result has been set to something lower.
+	    if (_M_result < __pos)
+	      break;
+
+	    if (_M_selector(__i1, __i2, _M_pred))
+	      {
+		__find_lower_result(&_M_result, __pos);
+		break;
+	      }
+	    ++__i1;
+	    ++__i2;
+	  }
+      }
+    };
+
   /**
    *  @brief Parallel std::find, equal splitting variant.
    *  @param __begin1 Begin iterator of first sequence.
@@ -102,61 +170,98 @@ namespace __gnu_parallel
 
       typedef std::iterator_traits<_RAIter1> _TraitsType;
       typedef typename _TraitsType::difference_type _DifferenceType;
-      typedef typename _TraitsType::value_type _ValueType;
 
       _DifferenceType __length = __end1 - __begin1;
-      _DifferenceType __result = __length;
-      _DifferenceType* __borders;
 
-      omp_lock_t __result_lock;
-      omp_init_lock(&__result_lock);
+      _FindEqualSplitRegion<_RAIter1, _RAIter2, _Pred, _Selector>
+	__region(__begin1, __begin2, __pred, __selector, __length);
+      __parallel_region(__get_max_threads(), __region);
+      _DifferenceType __result = __region._M_result;
+
+      return std::pair<_RAIter1, _RAIter2>(__begin1 + __result,
+					   __begin2 + __result);
+    }
+
+#endif
+
+#if _GLIBCXX_FIND_GROWING_BLOCKS
+
+  /** @brief Parallel region of the growing block size variant of
+   *  __find_template(). */
+  template<typename _RAIter1,
+           typename _RAIter2,
+           typename _Pred,
+           typename _Selector>
+    struct _FindGrowingBlocksRegion
+    {
+      typedef std::iterator_traits<_RAIter1> _TraitsType;
+      typedef typename _TraitsType::difference_type _DifferenceType;
 
-      _ThreadIndex __num_threads = __get_max_threads();
-#     pragma omp parallel num_threads(__num_threads)
+      _RAIter1 _M_begin1;
+      _RAIter2 _M_begin2;
+      _Pred _M_pred;
+      _Selector _M_selector;
+      _DifferenceType _M_length;
+      float _M_scale_factor;
+      // Index of beginning of next free block.
+      volatile _DifferenceType _M_next_block_start;
+      volatile _DifferenceType _M_result;
+
+      _FindGrowingBlocksRegion(_RAIter1 __begin1, _RAIter2 __begin2,
+			       _Pred __pred, _Selector __selector,
+			       _DifferenceType __length,
+			       _DifferenceType __next_block_start)
+      : _M_begin1(__begin1), _M_begin2(__begin2), _M_pred(__pred),
+	_M_selector(__selector), _M_length(__length),
+	_M_scale_factor(_Settings::get().find_scale_factor),
+	_M_next_block_start(__next_block_start), _M_result(__length) { }
+
+      void
+      operator()(_ThreadIndex, _ThreadIndex)
       {
-#     pragma omp single
-	{
-	  __num_threads = omp_get_num_threads();
-	  __borders = new _DifferenceType[__num_threads + 1];
-	  __equally_split(__length, __num_threads, __borders);
-	} //single
+	_DifferenceType __block_size = std::max<_DifferenceType>
+	  (1, _M_scale_factor * _M_next_block_start);
+	_DifferenceType __start = __fetch_and_add<_DifferenceType>
+	  (&_M_next_block_start, __block_size);
 
-	_ThreadIndex __iam = omp_get_thread_num();
-	_DifferenceType __start = __borders[__iam],
-	                 __stop = __borders[__iam + 1];
+	// Get new block, update pointer to next block.
+	_DifferenceType __stop =
+	  std::min<_DifferenceType>(_M_length, __start + __block_size);
 
-	_RAIter1 __i1 = __begin1 + __start;
-	_RAIter2 __i2 = __begin2 + __start;
-	for (_DifferenceType __pos = __start; __pos < __stop; ++__pos)
-	  {
-#           pragma omp flush(__result)
-	    // Result has been set to something lower.
-	    if (__result < __pos)
-	      break;
+	std::pair<_RAIter1, _RAIter2> __local_result;
 
-	    if (__selector(__i1, __i2, __pred))
+	while (__start < _M_length)
+	  {
+	    // Get new value of result.
+	    if (_M_result < __start)
 	      {
-		omp_set_lock(&__result_lock);
-		if (__pos < __result)
-		  __result = __pos;
-		omp_unset_lock(&__result_lock);
+		// No chance to find first element.
 		break;
 	      }
-	    ++__i1;
-	    ++__i2;
-	  }
-      } //parallel
 
-      omp_destroy_lock(&__result_lock);
-      delete[] __borders;
+	    __local_result = _M_selector._M_sequential_algorithm
+	      (_M_begin1 + __start, _M_begin1 + __stop,
+	       _M_begin2 + __start, _M_pred);
 
-      return std::pair<_RAIter1, _RAIter2>(__begin1 + __result,
-					   __begin2 + __result);
-    }
+	    if (__local_result.first != (_M_begin1 + __stop)
+		&& __find_lower_result(&_M_result,
+				       _DifferenceType(__local_result.first
+						       - _M_begin1)))
+	      // Result cannot be in future blocks, stop algorithm.
+	      __fetch_and_add<_DifferenceType>(&_M_next_block_start,
+					       _M_length);
 
-#endif
+	    __block_size = std::max<_DifferenceType>
+	      (1, _M_scale_factor * _M_next_block_start);
 
-#if _GLIBCXX_FIND_GROWING_BLOCKS
+	    // Get new block, update pointer to next block.
+	    __start = __fetch_and_add<_DifferenceType>(&_M_next_block_start,
+						       __block_size);
+	    __stop =
+	      std::min<_DifferenceType>(_M_length, __start + __block_size);
+	  }
+      }
+    };
 
   /**
    *  @brief Parallel std::find, growing block size variant.
@@ -209,85 +314,96 @@ namespace __gnu_parallel
       if (__find_seq_result.first != (__begin1 + __sequential_search_size))
 	return __find_seq_result;
 
-      // Index of beginning of next free block (after sequential find).
-      _DifferenceType __next_block_start = __sequential_search_size;
-      _DifferenceType __result = __length;
+      // Not within first __k elements -> start parallel.
+      _FindGrowingBlocksRegion<_RAIter1, _RAIter2, _Pred, _Selector>
+	__region(__begin1, __begin2, __pred, __selector, __length,
+		 __sequential_search_size);
+      __parallel_region(__get_max_threads(), __region);
+      _DifferenceType __result = __region._M_result;
 
-      omp_lock_t __result_lock;
-      omp_init_lock(&__result_lock);
+      // Return iterator on found element.
+      return
+	std::pair<_RAIter1, _RAIter2>(__begin1 + __result,
+				      __begin2 + __result);
+    }
 
-      const float __scale_factor = __s.find_scale_factor;
+#endif
 
-      _ThreadIndex __num_threads = __get_max_threads();
-#     pragma omp parallel shared(__result) num_threads(__num_threads)
-      {
-#       pragma omp single
-	__num_threads = omp_get_num_threads();
+#if _GLIBCXX_FIND_CONSTANT_SIZE_BLOCKS
 
-	// Not within first __k elements -> start parallel.
-	_ThreadIndex __iam = omp_get_thread_num();
+  /** @brief Parallel region of the constant block size variant of
+   *  __find_template(). */
+  template<typename _RAIter1,
+           typename _RAIter2,
+           typename _Pred,
+           typename _Selector>
+    struct _FindConstantSizeBlocksRegion
+    {
+      typedef std::iterator_traits<_RAIter1> _TraitsType;
+      typedef typename _TraitsType::difference_type _DifferenceType;
 
-	_DifferenceType __block_size =
-	  std::max<_DifferenceType>(1, __scale_factor * __next_block_start);
-	_DifferenceType __start = __fetch_and_add<_DifferenceType>
-	  (&__next_block_start, __block_size);
+      _RAIter1 _M_begin1;
+      _RAIter2 _M_begin2;
+      _Pred _M_pred;
+      _Selector _M_selector;
+      _DifferenceType _M_length;
+      _DifferenceType _M_sequential_search_size;
+      volatile _DifferenceType _M_result;
+
+      _FindConstantSizeBlocksRegion(_RAIter1 __begin1, _RAIter2 __begin2,
+				    _Pred __pred, _Selector __selector,
+				    _DifferenceType __length,
+				    _DifferenceType __sequential_search_size)
+      : _M_begin1(__begin1), _M_begin2(__begin2), _M_pred(__pred),
+	_M_selector(__selector), _M_length(__length),
+	_M_sequential_search_size(__sequential_search_size),
+	_M_result(__length) { }
+
+      void
+      operator()(_ThreadIndex __iam, _ThreadIndex __num_threads)
+      {
+	_DifferenceType __block_size = _Settings::get().find_initial_block_size;
 
-	// Get new block, update pointer to next block.
-	_DifferenceType __stop =
-	  std::min<_DifferenceType>(__length, __start + __block_size);
+	// First element of thread's current iteration.
+	_DifferenceType __iteration_start = _M_sequential_search_size;
+
+	// Where to work (initialization).
+	_DifferenceType __start = __iteration_start + __iam * __block_size;
+	_DifferenceType __stop = std::min<_DifferenceType>(_M_length,
+							   __start
+							   + __block_size);
 
 	std::pair<_RAIter1, _RAIter2> __local_result;
 
-	while (__start < __length)
+	while (__start < _M_length)
 	  {
-#           pragma omp flush(__result)
 	    // Get new value of result.
-	    if (__result < __start)
-	      {
-		// No chance to find first element.
-		break;
-	      }
+	    // No chance to find first element.
+	    if (_M_result < __start)
+	      break;
 
-	    __local_result = __selector._M_sequential_algorithm
-	      (__begin1 + __start, __begin1 + __stop,
-	       __begin2 + __start, __pred);
+	    __local_result = _M_selector._M_sequential_algorithm
+	      (_M_begin1 + __start, _M_begin1 + __stop,
+	       _M_begin2 + __start, _M_pred);
 
-	    if (__local_result.first != (__begin1 + __stop))
+	    if (__local_result.first != (_M_begin1 + __stop))
 	      {
-		omp_set_lock(&__result_lock);
-		if ((__local_result.first - __begin1) < __result)
-		  {
-		    __result = __local_result.first - __begin1;
-
-		    // Result cannot be in future blocks, stop algorithm.
-		    __fetch_and_add<_DifferenceType>(&__next_block_start,
-						     __length);
-		  }
-		omp_unset_lock(&__result_lock);
+		__find_lower_result(&_M_result,
+				    _DifferenceType(__local_result.first
+						    - _M_begin1));
+		// Will not find better value in its interval.
+		break;
 	      }
 
-	    _DifferenceType __block_size =
-	     std::max<_DifferenceType>(1, __scale_factor * __next_block_start);
+	    __iteration_start += __num_threads * __block_size;
 
-	    // Get new block, update pointer to next block.
-	    __start = __fetch_and_add<_DifferenceType>(&__next_block_start,
-						       __block_size);
-	    __stop =
-	      std::min<_DifferenceType>(__length, __start + __block_size);
+	    // Where to work.
+	    __start = __iteration_start + __iam * __block_size;
+	    __stop = std::min<_DifferenceType>(_M_length,
+					       __start + __block_size);
 	  }
-      } //parallel
-
-      omp_destroy_lock(&__result_lock);
-
-      // Return iterator on found element.
-      return
-	std::pair<_RAIter1, _RAIter2>(__begin1 + __result,
-				      __begin2 + __result);
-    }
-
-#endif
-
-#if _GLIBCXX_FIND_CONSTANT_SIZE_BLOCKS
+      }
+    };
 
   /**
    *   @brief Parallel std::find, constant block size variant.
@@ -336,64 +452,12 @@ namespace __gnu_parallel
       if (__find_seq_result.first != (__begin1 + __sequential_search_size))
 	return __find_seq_result;
 
-      _DifferenceType __result = __length;
-      omp_lock_t __result_lock;
-      omp_init_lock(&__result_lock);
-
       // Not within first __sequential_search_size elements -> start parallel.
-
-      _ThreadIndex __num_threads = __get_max_threads();
-#     pragma omp parallel shared(__result) num_threads(__num_threads)
-      {
-#       pragma omp single
-	__num_threads = omp_get_num_threads();
-
-	_ThreadIndex __iam = omp_get_thread_num();
-	_DifferenceType __block_size = __s.find_initial_block_size;
-
-	// First element of thread's current iteration.
-	_DifferenceType __iteration_start = __sequential_search_size;
-
-	// Where to work (initialization).
-	_DifferenceType __start = __iteration_start + __iam * __block_size;
-	_DifferenceType __stop = std::min<_DifferenceType>(__length,
-							   __start
-							   + __block_size);
-
-	std::pair<_RAIter1, _RAIter2> __local_result;
-
-	while (__start < __length)
-	  {
-	    // Get new value of result.
-#           pragma omp flush(__result)
-	    // No chance to find first element.
-	    if (__result < __start)
-	      break;
-
-	    __local_result = __selector._M_sequential_algorithm
-	      (__begin1 + __start, __begin1 + __stop,
-	       __begin2 + __start, __pred);
-
-	    if (__local_result.first != (__begin1 + __stop))
-	      {
-		omp_set_lock(&__result_lock);
-		if ((__local_result.first - __begin1) < __result)
-		  __result = __local_result.first - __begin1;
-		omp_unset_lock(&__result_lock);
-		// Will not find better value in its interval.
-		break;
-	      }
-
-	    __iteration_start += __num_threads * __block_size;
-
-	    // Where to work.
-	    __start = __iteration_start + __iam * __block_size;
-	    __stop = std::min<_DifferenceType>(__length,
-					       __start + __block_size);
-	  }
-      } //parallel
-
-      omp_destroy_lock(&__result_lock);
+      _FindConstantSizeBlocksRegion<_RAIter1, _RAIter2, _Pred, _Selector>
+	__region(__begin1, __begin2, __pred, __selector, __length,
+		 __sequential_search_size);
+      __parallel_region(__get_max_threads(), __region);
+      _DifferenceType __result = __region._M_result;
 
       // Return iterator on found element.
       return std::pair<_RAIter1, _RAIter2>(__begin1 + __result,
@@ -242,7 +242,7 @@ namespace __gnu_parallel
 	(__seqs, __seqs + 2, __target, multiway_merge_exact_splitting
 	 < /* __stable = */ true, _IteratorPair*,
 	 _Compare, _DifferenceType1>, __max_length, __comp,
-	 omp_get_max_threads());
+	 __get_max_threads());
 
       return __target_end;
     }
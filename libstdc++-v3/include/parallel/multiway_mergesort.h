@@ -37,6 +37,7 @@
 #include <parallel/basic_iterator.h>
 #include <bits/stl_algo.h>
 #include <parallel/parallel.h>
+#include <parallel/executor.h>
 #include <parallel/multiway_merge.h>
 
 namespace __gnu_parallel
@@ -84,25 +85,28 @@ namespace __gnu_parallel
 
       /** @brief Pieces of data to merge @c [thread][__sequence] */
       std::vector<_Piece<_DifferenceType> >* _M_pieces;
+
+      /** @brief Barrier for the threads sorting. */
+      _Barrier _M_barrier;
   };
 
   /**
    *  @brief Select _M_samples from a sequence.
+   *  @param __iam Index of the calling thread.
    *  @param __sd Pointer to algorithm data. _Result will be placed in
    *  @c __sd->_M_samples.
    *  @param __num_samples Number of _M_samples to select.
    */
   template<typename _RAIter, typename _DifferenceTp>
     void
-    __determine_samples(_PMWMSSortingData<_RAIter>* __sd,
+    __determine_samples(_ThreadIndex __iam,
+			_PMWMSSortingData<_RAIter>* __sd,
 			_DifferenceTp __num_samples)
     {
       typedef std::iterator_traits<_RAIter> _TraitsType;
       typedef typename _TraitsType::value_type _ValueType;
       typedef _DifferenceTp _DifferenceType;
 
-      _ThreadIndex __iam = omp_get_thread_num();
-
       _DifferenceType* __es = new _DifferenceType[__num_samples + 2];
 
       __equally_split(__sd->_M_starts[__iam + 1] - __sd->_M_starts[__iam], 
@@ -135,7 +139,7 @@ namespace __gnu_parallel
 		 std::iterator_traits<_RAIter>::difference_type
 		 __num_samples) const
       {
-#       pragma omp barrier
+	__sd->_M_barrier._M_wait(__sd->_M_num_threads);
 
 	std::vector<std::pair<_SortingPlacesIterator,
 	                      _SortingPlacesIterator> >
@@ -166,7 +170,7 @@ namespace __gnu_parallel
 		__sd->_M_starts[__seq + 1] - __sd->_M_starts[__seq];
 	  }
 
-#       pragma omp barrier
+	__sd->_M_barrier._M_wait(__sd->_M_num_threads);
 
 	for (_ThreadIndex __seq = 0; __seq < __sd->_M_num_threads; __seq++)
 	  {
@@ -198,17 +202,17 @@ namespace __gnu_parallel
 	typedef typename _TraitsType::value_type _ValueType;
 	typedef typename _TraitsType::difference_type _DifferenceType;
 
-	__determine_samples(__sd, __num_samples);
+	__determine_samples(__iam, __sd, __num_samples);
 
-#       pragma omp barrier
+	__sd->_M_barrier._M_wait(__sd->_M_num_threads);
 
-#       pragma omp single
-	__gnu_sequential::sort(__sd->_M_samples,
-			       __sd->_M_samples
-			       + (__num_samples * __sd->_M_num_threads),
-			       __comp);
+	if (__iam == 0)
+	  __gnu_sequential::sort(__sd->_M_samples,
+				 __sd->_M_samples
+				 + (__num_samples * __sd->_M_num_threads),
+				 __comp);
 
-#       pragma omp barrier
+	__sd->_M_barrier._M_wait(__sd->_M_num_threads);
 
 	for (_ThreadIndex __s = 0; __s < __sd->_M_num_threads; ++__s)
 	  {
@@ -299,21 +303,21 @@ namespace __gnu_parallel
     };
 
   /** @brief PMWMS code executed by each thread.
+   *  @param __iam Index of the calling thread.
    *  @param __sd Pointer to algorithm data.
    *  @param __comp Comparator.
    */
   template<bool __stable, bool __exact, typename _RAIter,
 	   typename _Compare>
     void
-    parallel_sort_mwms_pu(_PMWMSSortingData<_RAIter>* __sd,
+    parallel_sort_mwms_pu(_ThreadIndex __iam,
+			  _PMWMSSortingData<_RAIter>* __sd,
 			  _Compare& __comp)
     {
       typedef std::iterator_traits<_RAIter> _TraitsType;
       typedef typename _TraitsType::value_type _ValueType;
       typedef typename _TraitsType::difference_type _DifferenceType;
 
-      _ThreadIndex __iam = omp_get_thread_num();
-
       // Length of this thread's chunk, before merging.
       _DifferenceType __length_local =
 	__sd->_M_starts[__iam + 1] - __sd->_M_starts[__iam];
@@ -376,13 +380,84 @@ namespace __gnu_parallel
 				     __sd->_M_source + __offset, __comp,
 				     __length_am);
 
-#     pragma omp barrier
+      __sd->_M_barrier._M_wait(__sd->_M_num_threads);
 
       for (_DifferenceType __i = 0; __i < __length_local; ++__i)
 	__sd->_M_temporary[__iam][__i].~_ValueType();
       ::operator delete(__sd->_M_temporary[__iam]);
     }
 
+  /** @brief PMWMS parallel region.
+   *
+   *  Thread 0 sets up the algorithm data for the team, then all
+   *  threads sort. */
+  template<bool __stable, bool __exact, typename _RAIter,
+           typename _Compare>
+    struct _PMWMSSortingRegion
+    {
+      typedef std::iterator_traits<_RAIter> _TraitsType;
+      typedef typename _TraitsType::value_type _ValueType;
+      typedef typename _TraitsType::difference_type _DifferenceType;
+
+      _PMWMSSortingData<_RAIter>& _M_sd;
+      _Compare& _M_comp;
+      _DifferenceType _M_n;
+      _DifferenceType _M_size;
+
+      _PMWMSSortingRegion(_PMWMSSortingData<_RAIter>& __sd,
+			  _Compare& __comp, _DifferenceType __n)
+      : _M_sd(__sd), _M_comp(__comp), _M_n(__n), _M_size(0) { }
+
+      void
+      operator()(_ThreadIndex __iam, _ThreadIndex __num_threads)
+      {
+	if (__iam == 0)
+	  _M_init(__num_threads);
+	_M_sd._M_barrier._M_wait(__num_threads);
+
+        // Now sort in parallel.
+        parallel_sort_mwms_pu<__stable, __exact>(__iam, &_M_sd, _M_comp);
+      }
+
+      void
+      _M_init(_ThreadIndex __num_threads)
+      {
+	_M_sd._M_num_threads = __num_threads;
+
+	_M_sd._M_temporary = new _ValueType*[__num_threads];
+
+	if (!__exact)
+	  {
+	    _M_size =
+	      (_Settings::get().sort_mwms_oversampling * __num_threads - 1)
+	      * __num_threads;
+	    _M_sd._M_samples = static_cast<_ValueType*>
+	      (::operator new(_M_size * sizeof(_ValueType)));
+	  }
+	else
+	  _M_sd._M_samples = 0;
+
+	_M_sd._M_offsets = new _DifferenceType[__num_threads - 1];
+	_M_sd._M_pieces
+	  = new std::vector<_Piece<_DifferenceType> >[__num_threads];
+	for (_ThreadIndex __s = 0; __s < __num_threads; ++__s)
+	  _M_sd._M_pieces[__s].resize(__num_threads);
+	_DifferenceType* __starts = _M_sd._M_starts
+	  = new _DifferenceType[__num_threads + 1];
+
+	_DifferenceType __chunk_length = _M_n / __num_threads;
+	_DifferenceType __split = _M_n % __num_threads;
+	_DifferenceType __pos = 0;
+	for (_ThreadIndex __i = 0; __i < __num_threads; ++__i)
+	  {
+	    __starts[__i] = __pos;
+	    __pos += ((__i < __split)
+		      ? (__chunk_length + 1) : __chunk_length);
+	  }
+	__starts[__num_threads] = __pos;
+      }
+    };
+
   /** @brief PMWMS main call.
    *  @param __begin Begin iterator of sequence.
    *  @param __end End iterator of sequence.
@@ -413,60 +488,18 @@ namespace __gnu_parallel
 
       // shared variables
       _PMWMSSortingData<_RAIter> __sd;
-      _DifferenceType* __starts;
-      _DifferenceType __size;
-
-#     pragma omp parallel num_threads(__num_threads)
-      {
-        __num_threads = omp_get_num_threads(); //no more threads than requested
-
-#       pragma omp single
-	{
-	  __sd._M_num_threads = __num_threads;
-	  __sd._M_source = __begin;
-	  
-	  __sd._M_temporary = new _ValueType*[__num_threads];
-
-	  if (!__exact)
-	    {
-	      __size =
-		(_Settings::get().sort_mwms_oversampling * __num_threads - 1)
-		* __num_threads;
-	      __sd._M_samples = static_cast<_ValueType*>
-		(::operator new(__size * sizeof(_ValueType)));
-	    }
-	  else
-	    __sd._M_samples = 0;
-
-	  __sd._M_offsets = new _DifferenceType[__num_threads - 1];
-	  __sd._M_pieces
-	    = new std::vector<_Piece<_DifferenceType> >[__num_threads];
-	  for (_ThreadIndex __s = 0; __s < __num_threads; ++__s)
-	    __sd._M_pieces[__s].resize(__num_threads);
-	  __starts = __sd._M_starts = new _DifferenceType[__num_threads + 1];
-
-	  _DifferenceType __chunk_length = __n / __num_threads;
-	  _DifferenceType __split = __n % __num_threads;
-	  _DifferenceType __pos = 0;
-	  for (_ThreadIndex __i = 0; __i < __num_threads; ++__i)
-	    {
-	      __starts[__i] = __pos;
-	      __pos += ((__i < __split)
-			? (__chunk_length + 1) : __chunk_length);
-	    }
-	  __starts[__num_threads] = __pos;
-	} //single
+      __sd._M_source = __begin;
 
-        // Now sort in parallel.
-        parallel_sort_mwms_pu<__stable, __exact>(&__sd, __comp);
-      } //parallel
+      _PMWMSSortingRegion<__stable, __exact, _RAIter, _Compare>
+	__region(__sd, __comp, __n);
+      __parallel_region(__num_threads, __region);
 
-      delete[] __starts;
+      delete[] __sd._M_starts;
       delete[] __sd._M_temporary;
 
       if (!__exact)
 	{
-	  for (_DifferenceType __i = 0; __i < __size; ++__i)
+	  for (_DifferenceType __i = 0; __i < __region._M_size; ++__i)
 	    __sd._M_samples[__i].~_ValueType();
 	  ::operator delete(__sd._M_samples);
 	}
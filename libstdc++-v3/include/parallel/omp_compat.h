@@ -0,0 +1,112 @@
+// -*- C++ -*-
+
+// Copyright (C) 2014 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the terms
+// of the GNU General Public License as published by the Free Software
+// Foundation; either version 3, or (at your option) any later
+// version.
+
+// This library is distributed in the hope that it will be useful, but
+// WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the GNU
+// General Public License for more details.
+
+// Under Section 7 of GPL version 3, you are granted additional
+// permissions described in the GCC Runtime Library Exception, version
+// 3.1, as published by the Free Software Foundation.
+
+// You should have received a copy of the GNU General Public License and
+// a copy of the GCC Runtime Library Exception along with this program;
+// see the files COPYING3 and COPYING.RUNTIME respectively.  If not, see
+// <http://www.gnu.org/licenses/>.
+
+/** @file parallel/omp_compat.h
+ *  @brief The OpenMP runtime interface used by the parallel mode, or
+ *  serial stand-ins for it when compiling without -fopenmp.
+ *
+ *  Without -fopenmp, OpenMP pragmas are ignored, so the algorithms
+ *  that still use them run each parallel region on the calling thread
+ *  alone, and the stand-ins below describe a team of that one thread.
+ *  The algorithms that run through an executor (see parallel/executor.h)
+ *  stay parallel, and the program does not need libgomp.
+ *
+ *  This file is a GNU parallel extension to the Standard C++ Library
+ *  and contains implementation details for the library's internal use.
+ */
+
+#ifndef _GLIBCXX_PARALLEL_OMP_COMPAT_H
+#define _GLIBCXX_PARALLEL_OMP_COMPAT_H 1
+
+#include <bits/c++config.h>
+#include <parallel/types.h>
+
+#ifdef _OPENMP
+#include <omp.h>
+#else
+#include <ctime>
+#if defined(_GLIBCXX_USE_GET_NPROCS)
+# include <sys/sysinfo.h>
+#elif defined(_GLIBCXX_USE_SC_NPROCESSORS_ONLN) \
+  || defined(_GLIBCXX_USE_SC_NPROC_ONLN)
+# include <unistd.h>
+#endif
+#endif
+
+namespace __gnu_parallel
+{
+#ifndef _OPENMP
+  inline int
+  omp_get_thread_num()
+  { return 0; }
+
+  inline int
+  omp_get_num_threads()
+  { return 1; }
+
+  inline double
+  omp_get_wtime()
+  { return double(std::clock()) / CLOCKS_PER_SEC; }
+
+  typedef int omp_lock_t;
+
+  inline void
+  omp_init_lock(omp_lock_t*)
+  { }
+
+  inline void
+  omp_destroy_lock(omp_lock_t*)
+  { }
+
+  inline void
+  omp_set_lock(omp_lock_t*)
+  { }
+
+  inline void
+  omp_unset_lock(omp_lock_t*)
+  { }
+#endif
+
+  /** @brief Number of threads to use when the caller did not ask for
+   *  a particular number: the OpenMP default with -fopenmp, otherwise
+   *  the number of processors online.  */
+  inline _ThreadIndex
+  __default_num_threads()
+  {
+#ifdef _OPENMP
+    int __n = omp_get_max_threads();
+#elif defined(_GLIBCXX_USE_GET_NPROCS)
+    int __n = get_nprocs();
+#elif defined(_GLIBCXX_USE_SC_NPROCESSORS_ONLN)
+    long __n = sysconf(_SC_NPROCESSORS_ONLN);
+#elif defined(_GLIBCXX_USE_SC_NPROC_ONLN)
+    long __n = sysconf(_SC_NPROC_ONLN);
+#else
+    int __n = 1;
+#endif
+    return __n > 1 ? __n : 1;
+  }
+} // end namespace
+
+#endif /* _GLIBCXX_PARALLEL_OMP_COMPAT_H */
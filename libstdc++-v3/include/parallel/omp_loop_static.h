@@ -33,7 +33,7 @@
 #ifndef _GLIBCXX_PARALLEL_OMP_LOOP_STATIC_H
 #define _GLIBCXX_PARALLEL_OMP_LOOP_STATIC_H 1
 
-#include <omp.h>
+#include <parallel/omp_compat.h>
 
 #include <parallel/settings.h>
 #include <parallel/basic_iterator.h>
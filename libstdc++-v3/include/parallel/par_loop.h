@@ -33,13 +33,79 @@
 #ifndef _GLIBCXX_PARALLEL_PAR_LOOP_H
 #define _GLIBCXX_PARALLEL_PAR_LOOP_H 1
 
-#include <omp.h>
 #include <parallel/settings.h>
 #include <parallel/base.h>
+#include <parallel/executor.h>
 #include <parallel/equally_split.h>
 
 namespace __gnu_parallel
 {
+  /** @brief Parallel region of __for_each_template_random_access_ed(). */
+  template<typename _RAIter,
+	   typename _Op,
+	   typename _Fu,
+	   typename _Red,
+	   typename _Result>
+    struct _ForEachEDRegion
+    {
+      typedef std::iterator_traits<_RAIter> _TraitsType;
+      typedef typename _TraitsType::difference_type _DifferenceType;
+
+      _RAIter _M_begin;
+      _Op& _M_o;
+      _Fu& _M_f;
+      _Red _M_r;
+      _DifferenceType _M_length;
+      _ThreadIndex _M_num_threads;
+      _Result* _M_thread_results;
+      bool* _M_constructed;
+      _Barrier _M_barrier;
+
+      _ForEachEDRegion(_RAIter __begin, _Op& __o, _Fu& __f, _Red __r,
+		       _DifferenceType __length)
+      : _M_begin(__begin), _M_o(__o), _M_f(__f), _M_r(__r),
+	_M_length(__length), _M_num_threads(0), _M_thread_results(0),
+	_M_constructed(0) { }
+
+      void
+      operator()(_ThreadIndex __iam, _ThreadIndex __num_threads)
+      {
+	if (__iam == 0)
+	  {
+	    _M_num_threads = __num_threads;
+	    _M_thread_results = static_cast<_Result*>
+	      (::operator new(__num_threads * sizeof(_Result)));
+	    _M_constructed = new bool[__num_threads];
+	  }
+	_M_barrier._M_wait(__num_threads);
+
+	// Neutral element.
+	_Result* __reduct;
+
+	_DifferenceType
+	  __start = __equally_split_point(_M_length, __num_threads, __iam),
+	  __stop = __equally_split_point(_M_length, __num_threads, __iam + 1);
+
+	if (__start < __stop)
+	  {
+	    __reduct = new _Result(_M_f(_M_o, _M_begin + __start));
+	    ++__start;
+	    _M_constructed[__iam] = true;
+	  }
+	else
+	  _M_constructed[__iam] = false;
+
+	for (; __start < __stop; ++__start)
+	  *__reduct = _M_r(*__reduct, _M_f(_M_o, _M_begin + __start));
+
+	if (_M_constructed[__iam])
+	  {
+	    ::new(&_M_thread_results[__iam]) _Result(*__reduct);
+	    delete __reduct;
+	  }
+      }
+    };
+
   /** @brief Embarrassingly parallel algorithm for random access
    * iterators, using hand-crafted parallelization by equal splitting
    * the work.
@@ -72,64 +138,28 @@ namespace __gnu_parallel
       typedef std::iterator_traits<_RAIter> _TraitsType;
       typedef typename _TraitsType::difference_type _DifferenceType;
       const _DifferenceType __length = __end - __begin;
-      _Result *__thread_results;
-      bool* __constructed;
 
       _ThreadIndex __num_threads = __gnu_parallel::min<_DifferenceType>
 	(__get_max_threads(), __length);
 
-#     pragma omp parallel num_threads(__num_threads)
-      {
-#       pragma omp single
-	{
-	  __num_threads = omp_get_num_threads();
-	  __thread_results = static_cast<_Result*>
-	    (::operator new(__num_threads * sizeof(_Result)));
-	  __constructed = new bool[__num_threads];
-	}
-
-	_ThreadIndex __iam = omp_get_thread_num();
-
-	// Neutral element.
-	_Result* __reduct;
-
-	_DifferenceType
-	  __start = __equally_split_point(__length, __num_threads, __iam),
-	  __stop = __equally_split_point(__length, __num_threads, __iam + 1);
-
-	if (__start < __stop)
-	  {
-	    __reduct = new _Result(__f(__o, __begin + __start));
-	    ++__start;
-	    __constructed[__iam] = true;
-	  }
-	else
-	  __constructed[__iam] = false;
-
-	for (; __start < __stop; ++__start)
-	  *__reduct = __r(*__reduct, __f(__o, __begin + __start));
-
-	if (__constructed[__iam])
-	  {
-	    ::new(&__thread_results[__iam]) _Result(*__reduct);
-	    delete __reduct;
-	  }
-      } //parallel
+      _ForEachEDRegion<_RAIter, _Op, _Fu, _Red, _Result>
+	__region(__begin, __o, __f, __r, __length);
+      __parallel_region(__num_threads, __region);
 
-      for (_ThreadIndex __i = 0; __i < __num_threads; ++__i)
-	if (__constructed[__i])
+      for (_ThreadIndex __i = 0; __i < __region._M_num_threads; ++__i)
+	if (__region._M_constructed[__i])
 	  {
-	    __output = __r(__output, __thread_results[__i]);
-	    __thread_results[__i].~_Result();
+	    __output = __r(__output, __region._M_thread_results[__i]);
+	    __region._M_thread_results[__i].~_Result();
 	  }
 
       // Points to last element processed (needed as return value for
       // some algorithms like transform).
       __f._M_finish_iterator = __begin + __length;
 
-      ::operator delete(__thread_results);
+      ::operator delete(__region._M_thread_results);
 
-      delete[] __constructed;
+      delete[] __region._M_constructed;
 
       return __o;
     }
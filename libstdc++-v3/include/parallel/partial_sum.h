@@ -33,10 +33,10 @@
 #ifndef _GLIBCXX_PARALLEL_PARTIAL_SUM_H
 #define _GLIBCXX_PARALLEL_PARTIAL_SUM_H 1
 
-#include <omp.h>
 #include <new>
 #include <bits/stl_algobase.h>
 #include <parallel/parallel.h>
+#include <parallel/executor.h>
 #include <parallel/numericfwd.h>
 
 namespace __gnu_parallel
@@ -73,6 +73,111 @@ namespace __gnu_parallel
       return __result;
     }
 
+  /** @brief Parallel region of __parallel_partial_sum_linear().
+   *
+   *  Thread 0 splits the input, then each thread sums its part, then
+   *  thread 0 computes the prefix sums of the parts, then each thread
+   *  writes the prefix sums of its part. */
+  template<typename _IIter,
+	   typename _OutputIterator,
+	   typename _BinaryOperation>
+    struct _PartialSumRegion
+    {
+      typedef std::iterator_traits<_IIter> _TraitsType;
+      typedef typename _TraitsType::value_type _ValueType;
+      typedef typename _TraitsType::difference_type _DifferenceType;
+
+      _IIter _M_begin;
+      _OutputIterator _M_result;
+      _BinaryOperation _M_bin_op;
+      _DifferenceType _M_n;
+      _ThreadIndex _M_num_threads;
+      _DifferenceType* _M_borders;
+      _ValueType* _M_sums;
+      _Barrier _M_barrier;
+
+      _PartialSumRegion(_IIter __begin, _OutputIterator __result,
+			_BinaryOperation __bin_op, _DifferenceType __n)
+      : _M_begin(__begin), _M_result(__result), _M_bin_op(__bin_op),
+	_M_n(__n), _M_num_threads(0), _M_borders(0), _M_sums(0) { }
+
+      void
+      operator()(_ThreadIndex __iam, _ThreadIndex __num_threads)
+      {
+	if (__iam == 0)
+	  _M_init(__num_threads);
+	_M_barrier._M_wait(__num_threads);
+
+        if (__iam == 0)
+          {
+            *_M_result = *_M_begin;
+            __parallel_partial_sum_basecase(_M_begin + 1,
+					    _M_begin + _M_borders[1],
+					    _M_result + 1,
+					    _M_bin_op, *_M_begin);
+            ::new(&(_M_sums[__iam]))
+	      _ValueType(*(_M_result + _M_borders[1] - 1));
+          }
+        else
+          {
+            ::new(&(_M_sums[__iam]))
+              _ValueType(__gnu_parallel::accumulate(
+                                         _M_begin + _M_borders[__iam] + 1,
+                                         _M_begin + _M_borders[__iam + 1],
+                                         *(_M_begin + _M_borders[__iam]),
+                                         _M_bin_op,
+                                         __gnu_parallel::sequential_tag()));
+          }
+
+	_M_barrier._M_wait(__num_threads);
+
+	if (__iam == 0)
+	  __parallel_partial_sum_basecase(_M_sums + 1,
+					  _M_sums + __num_threads,
+					  _M_sums + 1, _M_bin_op, _M_sums[0]);
+
+	_M_barrier._M_wait(__num_threads);
+
+	// Still same team.
+        __parallel_partial_sum_basecase(_M_begin + _M_borders[__iam + 1],
+					_M_begin + _M_borders[__iam + 2],
+					_M_result + _M_borders[__iam + 1],
+					_M_bin_op, _M_sums[__iam]);
+      }
+
+      void
+      _M_init(_ThreadIndex __num_threads)
+      {
+	const _Settings& __s = _Settings::get();
+
+	_M_num_threads = __num_threads;
+	_M_borders = new _DifferenceType[__num_threads + 2];
+
+	if (__s.partial_sum_dilation == 1.0f)
+	  __equally_split(_M_n, __num_threads + 1, _M_borders);
+	else
+	  {
+	    _DifferenceType __first_part_length =
+		std::max<_DifferenceType>(1,
+		  _M_n / (1.0f + __s.partial_sum_dilation * __num_threads));
+	    _DifferenceType __chunk_length =
+		(_M_n - __first_part_length) / __num_threads;
+	    _DifferenceType __borderstart =
+		_M_n - __num_threads * __chunk_length;
+	    _M_borders[0] = 0;
+	    for (_ThreadIndex __i = 1; __i < (__num_threads + 1); ++__i)
+	      {
+		_M_borders[__i] = __borderstart;
+		__borderstart += __chunk_length;
+	      }
+	    _M_borders[__num_threads + 1] = _M_n;
+	  }
+
+	_M_sums = static_cast<_ValueType*>(::operator new(sizeof(_ValueType)
+							  * __num_threads));
+      }
+    };
+
   /** @brief Parallel partial sum implementation, two-phase approach,
       no recursion.
       *  @param __begin Begin iterator of input sequence.
@@ -109,85 +214,15 @@ namespace __gnu_parallel
 						 *__begin);
 	}
 
-      _DifferenceType* __borders;
-      _ValueType* __sums;
-
-      const _Settings& __s = _Settings::get();
-
-#     pragma omp parallel num_threads(__num_threads)
-      {
-#       pragma omp single
-	{
-	  __num_threads = omp_get_num_threads();
-	    
-	  __borders = new _DifferenceType[__num_threads + 2];
-
-	  if (__s.partial_sum_dilation == 1.0f)
-	    __equally_split(__n, __num_threads + 1, __borders);
-	  else
-	    {
-	      _DifferenceType __first_part_length =
-		  std::max<_DifferenceType>(1,
-		    __n / (1.0f + __s.partial_sum_dilation * __num_threads));
-	      _DifferenceType __chunk_length =
-		  (__n - __first_part_length) / __num_threads;
-	      _DifferenceType __borderstart =
-		  __n - __num_threads * __chunk_length;
-	      __borders[0] = 0;
-	      for (_ThreadIndex __i = 1; __i < (__num_threads + 1); ++__i)
-		{
-		  __borders[__i] = __borderstart;
-		  __borderstart += __chunk_length;
-		}
-	      __borders[__num_threads + 1] = __n;
-	    }
-
-	  __sums = static_cast<_ValueType*>(::operator new(sizeof(_ValueType)
-                                                           * __num_threads));
-	  _OutputIterator __target_end;
-	} //single
-
-        _ThreadIndex __iam = omp_get_thread_num();
-        if (__iam == 0)
-          {
-            *__result = *__begin;
-            __parallel_partial_sum_basecase(__begin + 1,
-					    __begin + __borders[1],
-					    __result + 1,
-					    __bin_op, *__begin);
-            ::new(&(__sums[__iam])) _ValueType(*(__result + __borders[1] - 1));
-          }
-        else
-          {
-            ::new(&(__sums[__iam]))
-              _ValueType(__gnu_parallel::accumulate(
-                                         __begin + __borders[__iam] + 1,
-                                         __begin + __borders[__iam + 1],
-                                         *(__begin + __borders[__iam]),
-                                         __bin_op,
-                                         __gnu_parallel::sequential_tag()));
-          }
-
-#       pragma omp barrier
-
-#       pragma omp single
-	__parallel_partial_sum_basecase(__sums + 1, __sums + __num_threads,
-					__sums + 1, __bin_op, __sums[0]);
-
-#       pragma omp barrier
-
-	// Still same team.
-        __parallel_partial_sum_basecase(__begin + __borders[__iam + 1],
-					__begin + __borders[__iam + 2],
-					__result + __borders[__iam + 1],
-					__bin_op, __sums[__iam]);
-      } //parallel
+      _PartialSumRegion<_IIter, _OutputIterator, _BinaryOperation>
+	__region(__begin, __result, __bin_op, __n);
+      __parallel_region(__num_threads, __region);
 
-      for (_ThreadIndex __i = 0; __i < __num_threads; ++__i)
-	__sums[__i].~_ValueType();
-      ::operator delete(__sums);
+      for (_ThreadIndex __i = 0; __i < __region._M_num_threads; ++__i)
+	__region._M_sums[__i].~_ValueType();
+      ::operator delete(__region._M_sums);
 
-      delete[] __borders;
+      delete[] __region._M_borders;
 
       return __result + __n;
     }
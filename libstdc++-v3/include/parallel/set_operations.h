@@ -34,7 +34,7 @@
 #ifndef _GLIBCXX_PARALLEL_SET_OPERATIONS_H
 #define _GLIBCXX_PARALLEL_SET_OPERATIONS_H 1
 
-#include <omp.h>
+#include <parallel/omp_compat.h>
 
 #include <parallel/settings.h>
 #include <parallel/multiseq_selection.h>
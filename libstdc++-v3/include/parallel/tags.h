@@ -33,7 +33,7 @@
 #ifndef _GLIBCXX_PARALLEL_TAGS_H
 #define _GLIBCXX_PARALLEL_TAGS_H 1
 
-#include <omp.h>
+#include <parallel/omp_compat.h>
 #include <parallel/types.h>
 
 namespace __gnu_parallel
@@ -63,7 +63,7 @@ namespace __gnu_parallel
       _ThreadIndex __get_num_threads()
       {
         if(_M_num_threads == 0)
-          return omp_get_max_threads();
+          return __default_num_threads();
         else
           return _M_num_threads;
       }
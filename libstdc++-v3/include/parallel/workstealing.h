@@ -43,6 +43,7 @@
 #include <parallel/parallel.h>
 #include <parallel/random_number.h>
 #include <parallel/compatibility.h>
+#include <parallel/executor.h>
 
 namespace __gnu_parallel
 {
@@ -72,90 +73,62 @@ namespace __gnu_parallel
       _GLIBCXX_JOB_VOLATILE _DifferenceType _M_load;
     };
 
-  /** @brief Work stealing algorithm for random access iterators.
-    *
-    *  Uses O(1) additional memory. Synchronization at job lists is
-    *  done with atomic operations.
-    *  @param __begin Begin iterator of element sequence.
-    *  @param __end End iterator of element sequence.
-    *  @param __op User-supplied functor (comparator, predicate, adding
-    *  functor, ...).
-    *  @param __f Functor to @a process an element with __op (depends on
-    *  desired functionality, e. g. for std::for_each(), ...).
-    *  @param __r Functor to @a add a single __result to the already
-    *  processed elements (depends on functionality).
-    *  @param __base Base value for reduction.
-    *  @param __output Pointer to position where final result is written to
-    *  @param __bound Maximum number of elements processed (e. g. for
-    *  std::count_n()).
-    *  @return User-supplied functor (that may contain a part of the result).
-    */
+  /** @brief Parallel region of
+   *  __for_each_template_random_access_workstealing(). */
   template<typename _RAIter,
            typename _Op,
            typename _Fu,
            typename _Red,
            typename _Result>
-    _Op
-    __for_each_template_random_access_workstealing(_RAIter __begin,
-						   _RAIter __end, _Op __op,
-						   _Fu& __f, _Red __r,
-						   _Result __base,
-						   _Result& __output,
-      typename std::iterator_traits<_RAIter>::difference_type __bound)
+    struct _WorkstealingRegion
     {
-      _GLIBCXX_CALL(__end - __begin)
-
       typedef std::iterator_traits<_RAIter> _TraitsType;
       typedef typename _TraitsType::difference_type _DifferenceType;
 
-      const _Settings& __s = _Settings::get();
-
-      _DifferenceType __chunk_size =
-          static_cast<_DifferenceType>(__s.workstealing_chunk_size);
-
-      // How many jobs?
-      _DifferenceType __length = (__bound < 0) ? (__end - __begin) : __bound;
+      _RAIter _M_begin;
+      _Op& _M_op;
+      _Fu& _M_f;
+      _Red _M_r;
+      _Result& _M_output;
+      _DifferenceType _M_length;
+      _DifferenceType _M_chunk_size;
 
       // To avoid false sharing in a cache line.
-      const int __stride = (__s.cache_line_size * 10
-			    / sizeof(_Job<_DifferenceType>) + 1);
+      int _M_stride;
 
       // Total number of threads currently working.
-      _ThreadIndex __busy = 0;
+      volatile _ThreadIndex _M_busy;
 
-      _Job<_DifferenceType> *__job;
+      _Job<_DifferenceType>* _M_job;
 
-      omp_lock_t __output_lock;
-      omp_init_lock(&__output_lock);
+      __gnu_cxx::__mutex _M_output_mutex;
+      _Barrier _M_barrier;
 
-      // Write base value to output.
-      __output = __base;
+      _WorkstealingRegion(_RAIter __begin, _Op& __op, _Fu& __f, _Red __r,
+			  _Result& __output, _DifferenceType __length)
+      : _M_begin(__begin), _M_op(__op), _M_f(__f), _M_r(__r),
+	_M_output(__output), _M_length(__length),
+	_M_chunk_size(static_cast<_DifferenceType>
+		      (_Settings::get().workstealing_chunk_size)),
+	_M_stride(_Settings::get().cache_line_size * 10
+		  / sizeof(_Job<_DifferenceType>) + 1),
+	_M_busy(0), _M_job(0) { }
 
-      // No more threads than jobs, at least one thread.
-      _ThreadIndex __num_threads = __gnu_parallel::max<_ThreadIndex>
-	(1, __gnu_parallel::min<_DifferenceType>(__length,
-						 __get_max_threads()));
-
-#     pragma omp parallel shared(__busy) num_threads(__num_threads)
+      void
+      operator()(_ThreadIndex __iam, _ThreadIndex __num_threads)
       {
-#       pragma omp single
-	{
-	  __num_threads = omp_get_num_threads();
-
+	if (__iam == 0)
 	  // Create job description array.
-	  __job = new _Job<_DifferenceType>[__num_threads * __stride];
-	}
+	  _M_job = new _Job<_DifferenceType>[__num_threads * _M_stride];
+	_M_barrier._M_wait(__num_threads);
 
 	// Initialization phase.
 
 	// Flags for every thread if it is doing productive work.
 	bool __iam_working = false;
 
-	// Thread id.
-	_ThreadIndex __iam = omp_get_thread_num();
-
 	// This job.
-	_Job<_DifferenceType>& __my_job = __job[__iam * __stride];
+	_Job<_DifferenceType>& __my_job = _M_job[__iam * _M_stride];
 
 	// Random number (for work stealing).
 	_ThreadIndex __victim;
@@ -171,18 +144,17 @@ namespace __gnu_parallel
 	_RandomNumber __rand_gen(__iam, __num_threads);
 
 	// This thread is currently working.
-#       pragma omp atomic
-	++__busy;
+	__atomic_add_fetch(&_M_busy, 1, __ATOMIC_ACQ_REL);
 
 	__iam_working = true;
 
 	// How many jobs per thread? last thread gets the rest.
 	__my_job._M_first = static_cast<_DifferenceType>
-	  (__iam * (__length / __num_threads));
+	  (__iam * (_M_length / __num_threads));
 
 	__my_job._M_last = (__iam == (__num_threads - 1)
-			    ? (__length - 1)
-			    : ((__iam + 1) * (__length / __num_threads) - 1));
+			    ? (_M_length - 1)
+			    : ((__iam + 1) * (_M_length / __num_threads) - 1));
 	__my_job._M_load = __my_job._M_last - __my_job._M_first + 1;
 
 	// Init result with _M_first value (to have a base value for reduction)
@@ -190,56 +162,52 @@ namespace __gnu_parallel
 	  {
 	    // Cannot use volatile variable directly.
 	    _DifferenceType __my_first = __my_job._M_first;
-	    __result = __f(__op, __begin + __my_first);
+	    __result = _M_f(_M_op, _M_begin + __my_first);
 	    ++__my_job._M_first;
 	    --__my_job._M_load;
 	  }
 
 	_RAIter __current;
 
-#       pragma omp barrier
+	_M_barrier._M_wait(__num_threads);
 
 	// Actual work phase
 	// Work on own or stolen current start
-	while (__busy > 0)
+	while (_M_busy > 0)
 	  {
 	    // Work until no productive thread left.
-#           pragma omp flush(__busy)
 
 	    // Thread has own work to do
 	    while (__my_job._M_first <= __my_job._M_last)
 	      {
 		// fetch-and-add call
-		// Reserve current job block (size __chunk_size) in my queue.
+		// Reserve current job block (size _M_chunk_size) in my queue.
 		_DifferenceType __current_job =
 		  __fetch_and_add<_DifferenceType>(&(__my_job._M_first),
-						   __chunk_size);
+						   _M_chunk_size);
 
 		// Update _M_load, to make the three values consistent,
 		// _M_first might have been changed in the meantime
 		__my_job._M_load = __my_job._M_last - __my_job._M_first + 1;
 		for (_DifferenceType __job_counter = 0;
-		     __job_counter < __chunk_size
+		     __job_counter < _M_chunk_size
 		       && __current_job <= __my_job._M_last;
 		     ++__job_counter)
 		  {
 		    // Yes: process it!
-		    __current = __begin + __current_job;
+		    __current = _M_begin + __current_job;
 		    ++__current_job;
 
 		    // Do actual work.
-		    __result = __r(__result, __f(__op, __current));
+		    __result = _M_r(__result, _M_f(_M_op, __current));
 		  }
-
-#               pragma omp flush(__busy)
 	      }
 
 	    // After reaching this point, a thread's __job list is empty.
 	    if (__iam_working)
 	      {
 		// This thread no longer has work.
-#               pragma omp atomic
-		--__busy;
+		__atomic_sub_fetch(&_M_busy, 1, __ATOMIC_ACQ_REL);
 
 		__iam_working = false;
 	      }
@@ -250,18 +218,17 @@ namespace __gnu_parallel
 	      {
 		// Find random nonempty deque (not own), do consistency check.
 		__yield();
-#               pragma omp flush(__busy)
 		__victim = __rand_gen();
-		__supposed_first = __job[__victim * __stride]._M_first;
-		__supposed_last = __job[__victim * __stride]._M_last;
-		__supposed_load = __job[__victim * __stride]._M_load;
+		__supposed_first = _M_job[__victim * _M_stride]._M_first;
+		__supposed_last = _M_job[__victim * _M_stride]._M_last;
+		__supposed_load = _M_job[__victim * _M_stride]._M_load;
 	      }
-	    while (__busy > 0
+	    while (_M_busy > 0
 		   && ((__supposed_load <= 0)
 		       || ((__supposed_first + __supposed_load - 1)
 			   != __supposed_last)));
 
-	    if (__busy == 0)
+	    if (_M_busy == 0)
 	      break;
 
 	    if (__supposed_load > 0)
@@ -273,7 +240,7 @@ namespace __gnu_parallel
 		// Push __victim's current start forward.
 		_DifferenceType __stolen_first =
 		  __fetch_and_add<_DifferenceType>
-		  (&(__job[__victim * __stride]._M_first), __steal);
+		  (&(_M_job[__victim * _M_stride]._M_first), __steal);
 		_DifferenceType __stolen_try = (__stolen_first + __steal
 						- _DifferenceType(1));
 
@@ -283,28 +250,73 @@ namespace __gnu_parallel
 		__my_job._M_load = __my_job._M_last - __my_job._M_first + 1;
 
 		// Has potential work again.
-#               pragma omp atomic
-		++__busy;
+		__atomic_add_fetch(&_M_busy, 1, __ATOMIC_ACQ_REL);
 		__iam_working = true;
-
-#               pragma omp flush(__busy)
 	      }
-#           pragma omp flush(__busy)
-	  } // end while __busy > 0
+	  } // end while _M_busy > 0
 	// Add accumulated result to output.
-	omp_set_lock(&__output_lock);
-	__output = __r(__output, __result);
-	omp_unset_lock(&__output_lock);
+	__gnu_cxx::__scoped_lock __sentry(_M_output_mutex);
+	_M_output = _M_r(_M_output, __result);
       }
+    };
+
+  /** @brief Work stealing algorithm for random access iterators.
+    *
+    *  Uses O(1) additional memory. Synchronization at job lists is
+    *  done with atomic operations.
+    *  @param __begin Begin iterator of element sequence.
+    *  @param __end End iterator of element sequence.
+    *  @param __op User-supplied functor (comparator, predicate, adding
+    *  functor, ...).
+    *  @param __f Functor to @a process an element with __op (depends on
+    *  desired functionality, e. g. for std::for_each(), ...).
+    *  @param __r Functor to @a add a single __result to the already
+    *  processed elements (depends on functionality).
+    *  @param __base Base value for reduction.
+    *  @param __output Pointer to position where final result is written to
+    *  @param __bound Maximum number of elements processed (e. g. for
+    *  std::count_n()).
+    *  @return User-supplied functor (that may contain a part of the result).
+    */
+  template<typename _RAIter,
+           typename _Op,
+           typename _Fu,
+           typename _Red,
+           typename _Result>
+    _Op
+    __for_each_template_random_access_workstealing(_RAIter __begin,
+						   _RAIter __end, _Op __op,
+						   _Fu& __f, _Red __r,
+						   _Result __base,
+						   _Result& __output,
+      typename std::iterator_traits<_RAIter>::difference_type __bound)
+    {
+      _GLIBCXX_CALL(__end - __begin)
+
+      typedef std::iterator_traits<_RAIter> _TraitsType;
+      typedef typename _TraitsType::difference_type _DifferenceType;
 
-      delete[] __job;
+      // How many jobs?
+      _DifferenceType __length = (__bound < 0) ? (__end - __begin) : __bound;
+
+      // Write base value to output.
+      __output = __base;
+
+      // No more threads than jobs, at least one thread.
+      _ThreadIndex __num_threads = __gnu_parallel::max<_ThreadIndex>
+	(1, __gnu_parallel::min<_DifferenceType>(__length,
+						 __get_max_threads()));
+
+      _WorkstealingRegion<_RAIter, _Op, _Fu, _Red, _Result>
+	__region(__begin, __op, __f, __r, __output, __length);
+      __parallel_region(__num_threads, __region);
+
+      delete[] __region._M_job;
 
       // Points to last element processed (needed as return value for
       // some algorithms like transform)
       __f._M_finish_iterator = __begin + __length;
 
-      omp_destroy_lock(&__output_lock);
-
       return __op;
     }
 } // end namespace
@@ -0,0 +1,149 @@
+// { dg-options "-std=gnu++11" }
+
+// Copyright (C) 2014 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+#include <ext/flat_hash_map.h>
+#include <string>
+#include <stdexcept>
+#include <testsuite_hooks.h>
+
+void
+test01()
+{
+  bool test __attribute__((unused)) = true;
+
+  __gnu_cxx::flat_hash_map<int, std::string> m;
+  VERIFY( m.empty() );
+  VERIFY( m.begin() == m.end() );
+  VERIFY( m.find(1) == m.end() );
+
+  auto r = m.insert(std::make_pair(1, std::string("one")));
+  VERIFY( r.second );
+  VERIFY( r.first->first == 1 && r.first->second == "one" );
+  r = m.insert(std::make_pair(1, std::string("uno")));
+  VERIFY( !r.second );
+  VERIFY( r.first->second == "one" );
+
+  m[2] = "two";
+  VERIFY( m.size() == 2 );
+  VERIFY( m.at(2) == "two" );
+  VERIFY( m.count(3) == 0 );
+
+  r = m.try_emplace(3, 5, 'x');
+  VERIFY( r.second && r.first->second == "xxxxx" );
+  r = m.try_emplace(3, "no");
+  VERIFY( !r.second && r.first->second == "xxxxx" );
+
+  bool caught = false;
+  try
+    {
+      m.at(4);
+    }
+  catch (std::out_of_range&)
+    {
+      caught = true;
+    }
+  VERIFY( caught );
+
+  VERIFY( m.erase(2) == 1 );
+  VERIFY( m.erase(2) == 0 );
+  VERIFY( m.size() == 2 );
+  VERIFY( m.find(2) == m.end() );
+  VERIFY( m.find(1)->second == "one" );
+}
+
+// Insert and erase enough elements to rehash, grow and reuse deleted
+// slots several times.
+void
+test02()
+{
+  bool test __attribute__((unused)) = true;
+
+  __gnu_cxx::flat_hash_map<int, int> m;
+  const int n = 10000;
+  for (int i = 0; i < n; ++i)
+    m[i] = i * 2;
+  VERIFY( m.size() == std::size_t(n) );
+  VERIFY( m.load_factor() <= m.max_load_factor() );
+
+  for (int i = 0; i < n; i += 2)
+    VERIFY( m.erase(i) == 1 );
+  VERIFY( m.size() == std::size_t(n / 2) );
+
+  for (int round = 0; round < 4; ++round)
+    for (int i = 0; i < n; i += 2)
+      {
+	m.insert(std::make_pair(i + n, i));
+	VERIFY( m.erase(i + n) == 1 );
+      }
+
+  int count = 0;
+  for (auto it = m.begin(); it != m.end(); ++it, ++count)
+    {
+      VERIFY( it->first % 2 == 1 );
+      VERIFY( it->second == it->first * 2 );
+    }
+  VERIFY( count == n / 2 );
+
+  for (auto it = m.begin(); it != m.end(); )
+    it = m.erase(it);
+  VERIFY( m.empty() );
+  VERIFY( m.begin() == m.end() );
+}
+
+// Copy, move, swap and comparison.
+void
+test03()
+{
+  bool test __attribute__((unused)) = true;
+
+  typedef __gnu_cxx::flat_hash_map<std::string, int> map_type;
+  map_type m1 = { { "a", 1 }, { "b", 2 }, { "c", 3 } };
+  map_type m2(m1);
+  VERIFY( m1 == m2 );
+  m2["c"] = 4;
+  VERIFY( m1 != m2 );
+
+  map_type m3(std::move(m2));
+  VERIFY( m2.empty() );
+  VERIFY( m3.size() == 3 && m3["c"] == 4 );
+
+  swap(m1, m3);
+  VERIFY( m1["c"] == 4 && m3["c"] == 3 );
+
+  m2 = m3;
+  VERIFY( m2 == m3 );
+  m2 = std::move(m1);
+  VERIFY( m2["c"] == 4 );
+
+  m2.clear();
+  VERIFY( m2.empty() );
+  m2.rehash(0);
+  VERIFY( m2.bucket_count() == 0 );
+  m2.reserve(100);
+  VERIFY( m2.bucket_count() >= 100 );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+  return 0;
+}
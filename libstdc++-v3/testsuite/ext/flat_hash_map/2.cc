@@ -0,0 +1,77 @@
+// { dg-options "-std=gnu++11" }
+
+// Copyright (C) 2014 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// Heterogeneous lookup with a transparent hash and equality predicate.
+
+#include <ext/flat_hash_map.h>
+#include <string>
+#include <cstring>
+#include <testsuite_hooks.h>
+
+struct str_hash
+{
+  typedef void is_transparent;
+
+  std::size_t
+  operator()(const char* s) const
+  { return std::_Hash_impl::hash(s, std::strlen(s)); }
+
+  std::size_t
+  operator()(const std::string& s) const
+  { return (*this)(s.c_str()); }
+};
+
+struct str_equal
+{
+  typedef void is_transparent;
+
+  bool
+  operator()(const std::string& a, const char* b) const
+  { return a == b; }
+
+  bool
+  operator()(const std::string& a, const std::string& b) const
+  { return a == b; }
+};
+
+void
+test01()
+{
+  bool test __attribute__((unused)) = true;
+
+  __gnu_cxx::flat_hash_map<std::string, int, str_hash, str_equal> m;
+  m["one"] = 1;
+  m["two"] = 2;
+
+  const char* key = "two";
+  VERIFY( m.find(key) != m.end() );
+  VERIFY( m.find(key)->second == 2 );
+  VERIFY( m.count("three") == 0 );
+  VERIFY( m.equal_range("one").first->second == 1 );
+
+  const auto& cm = m;
+  VERIFY( cm.find("one") != cm.end() );
+}
+
+int
+main()
+{
+  test01();
+  return 0;
+}
@@ -0,0 +1,141 @@
+// { dg-options "-std=gnu++11" }
+
+// Copyright (C) 2014 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// A rehash that throws part way through leaves the map unchanged and
+// leaks nothing.
+
+#include <ext/flat_hash_map.h>
+#include <string>
+#include <testsuite_hooks.h>
+
+struct copy_error { };
+
+// A key whose copy constructor throws once a countdown reaches zero,
+// and which counts the live objects.
+struct key
+{
+  static int live;
+  static int countdown;
+
+  explicit key(int v) : value(v) { ++live; }
+
+  key(const key& k) : value(k.value)
+  {
+    if (countdown >= 0 && countdown-- == 0)
+      throw copy_error();
+    ++live;
+  }
+
+  ~key() { --live; }
+
+  bool
+  operator==(const key& k) const
+  { return value == k.value; }
+
+  int value;
+};
+
+int key::live = 0;
+int key::countdown = -1;
+
+struct key_hash
+{
+  std::size_t
+  operator()(const key& k) const
+  { return k.value; }
+};
+
+void
+test01()
+{
+  bool test __attribute__((unused)) = true;
+
+  {
+    __gnu_cxx::flat_hash_map<key, std::string, key_hash> m;
+    const int n = 100;
+    for (int i = 0; i < n; ++i)
+      m.emplace(std::piecewise_construct, std::forward_as_tuple(i),
+		std::forward_as_tuple(std::to_string(i)));
+    VERIFY( key::live == n );
+
+    const std::size_t cap = m.bucket_count();
+    for (int c = 0; c < n; c += 7)
+      {
+	key::countdown = c;
+	bool caught = false;
+	try
+	  {
+	    m.rehash(cap * 4);
+	  }
+	catch (copy_error&)
+	  {
+	    caught = true;
+	  }
+	key::countdown = -1;
+	VERIFY( caught );
+	VERIFY( m.bucket_count() == cap );
+	VERIFY( m.size() == std::size_t(n) );
+	VERIFY( key::live == n );
+	for (int i = 0; i < n; ++i)
+	  {
+	    auto it = m.find(key(i));
+	    VERIFY( it != m.end() );
+	    VERIFY( it->second == std::to_string(i) );
+	  }
+      }
+
+    // A failed insertion that grows the table.
+    while (m.size() < std::size_t(m.bucket_count() - m.bucket_count() / 8))
+      m.emplace(std::piecewise_construct,
+		std::forward_as_tuple(int(m.size())),
+		std::forward_as_tuple("x"));
+    const std::size_t size = m.size();
+    key::countdown = 10;
+    bool caught = false;
+    try
+      {
+	m.emplace(std::piecewise_construct, std::forward_as_tuple(-1),
+		  std::forward_as_tuple("y"));
+      }
+    catch (copy_error&)
+      {
+	caught = true;
+      }
+    key::countdown = -1;
+    VERIFY( caught );
+    VERIFY( m.size() == size );
+    VERIFY( m.find(key(-1)) == m.end() );
+    VERIFY( m.find(key(0)) != m.end() && m.find(key(0))->second == "0" );
+
+    m.rehash(cap * 4);
+    VERIFY( m.bucket_count() >= cap * 4 );
+    VERIFY( m.size() == size );
+    VERIFY( key::live == int(size) );
+    for (int i = 0; i < n; ++i)
+      VERIFY( m.find(key(i))->second == std::to_string(i) );
+  }
+  VERIFY( key::live == 0 );
+}
+
+int
+main()
+{
+  test01();
+  return 0;
+}
@@ -0,0 +1,104 @@
+// { dg-options "-std=gnu++11" }
+
+// Copyright (C) 2014 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// Copy and move assignment propagate the allocator only if the
+// allocator traits say so, and insert with a hint takes rvalues.
+
+#include <ext/flat_hash_map.h>
+#include <memory>
+#include <testsuite_hooks.h>
+#include <testsuite_allocator.h>
+
+using __gnu_test::propagating_allocator;
+
+void
+test01()
+{
+  bool test __attribute__((unused)) = true;
+  typedef propagating_allocator<std::pair<const int, int>, false> alloc_type;
+  typedef __gnu_cxx::flat_hash_map<int, int, std::hash<int>,
+				   std::equal_to<int>, alloc_type> test_type;
+  test_type v1(alloc_type(1));
+  v1.emplace(1, 1);
+  test_type v2(alloc_type(2));
+  v2.emplace(2, 2);
+  v2 = v1;
+  VERIFY( 1 == v1.get_allocator().get_personality() );
+  VERIFY( 2 == v2.get_allocator().get_personality() );
+  VERIFY( v2.size() == 1 && v2.count(1) == 1 );
+}
+
+void
+test02()
+{
+  bool test __attribute__((unused)) = true;
+  typedef propagating_allocator<std::pair<const int, int>, true> alloc_type;
+  typedef __gnu_cxx::flat_hash_map<int, int, std::hash<int>,
+				   std::equal_to<int>, alloc_type> test_type;
+  test_type v1(alloc_type(1));
+  v1.emplace(1, 1);
+  test_type v2(alloc_type(2));
+  v2.emplace(2, 2);
+  v2 = v1;
+  VERIFY( 1 == v1.get_allocator().get_personality() );
+  VERIFY( 1 == v2.get_allocator().get_personality() );
+  VERIFY( v2.size() == 1 && v2.count(1) == 1 );
+  // The new table was allocated with the propagated allocator.
+  for (int i = 2; i < 100; ++i)
+    v2.emplace(i, i);
+  VERIFY( v2.size() == 99 );
+}
+
+void
+test03()
+{
+  bool test __attribute__((unused)) = true;
+  typedef propagating_allocator<std::pair<const int, int>, false> alloc_type;
+  typedef __gnu_cxx::flat_hash_map<int, int, std::hash<int>,
+				   std::equal_to<int>, alloc_type> test_type;
+  test_type v1(alloc_type(1));
+  v1.emplace(1, 1);
+  test_type v2(alloc_type(2));
+  v2.emplace(2, 2);
+  v2 = std::move(v1);
+  VERIFY( 2 == v2.get_allocator().get_personality() );
+  VERIFY( v2.size() == 1 && v2.count(1) == 1 );
+}
+
+void
+test04()
+{
+  bool test __attribute__((unused)) = true;
+  typedef __gnu_cxx::flat_hash_map<int, std::unique_ptr<int> > test_type;
+  test_type m;
+  test_type::value_type v(1, std::unique_ptr<int>(new int(10)));
+  test_type::iterator it = m.insert(m.cend(), std::move(v));
+  VERIFY( it->first == 1 && *it->second == 10 );
+  VERIFY( !v.second );
+}
+
+int
+main()
+{
+  test01();
+  test02();
+  test03();
+  test04();
+  return 0;
+}
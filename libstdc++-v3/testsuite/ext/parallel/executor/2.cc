@@ -0,0 +1,104 @@
+// Copyright (C) 2014 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// Destroying a _ThreadPoolExecutor joins its threads, and an exception
+// leaving a region on the calling thread calls std::terminate rather
+// than leave the other threads of the team waiting at a barrier.
+
+#include <cstdlib>
+#include <exception>
+#include <testsuite_hooks.h>
+
+#if _GLIBCXX_PARALLEL
+#include <parallel/executor.h>
+
+struct region_error { };
+
+struct region
+{
+  region() : finished(0) { }
+
+  static void
+  count(void* arg, __gnu_parallel::_ThreadIndex,
+	__gnu_parallel::_ThreadIndex)
+  {
+    region* r = static_cast<region*>(arg);
+    __atomic_add_fetch(&r->finished, 1, __ATOMIC_RELAXED);
+  }
+
+  static void
+  body(void* arg, __gnu_parallel::_ThreadIndex iam,
+       __gnu_parallel::_ThreadIndex num_threads)
+  {
+    region* r = static_cast<region*>(arg);
+    if (iam == 0)
+      throw region_error();
+    r->barrier._M_wait(num_threads);
+  }
+
+  int finished;
+  __gnu_parallel::_Barrier barrier;
+};
+
+void
+test01()
+{
+  bool test __attribute__((unused)) = true;
+
+  for (int n = 0; n < 10; ++n)
+    {
+      __gnu_parallel::_ThreadPoolExecutor pool;
+      region r;
+      __gnu_parallel::_ThreadIndex team = pool._M_run(4, &region::count, &r);
+      VERIFY( r.finished == team );
+    }
+}
+
+void
+terminated()
+{ std::exit(0); }
+
+void
+test02()
+{
+  __gnu_parallel::_ThreadPoolExecutor pool;
+  region r0;
+  if (pool._M_run(4, &region::count, &r0) == 1)
+    std::exit(0);
+
+  std::set_terminate(terminated);
+  region r;
+  pool._M_run(4, &region::body, &r);
+  std::abort();
+}
+#else
+void
+test01()
+{ }
+
+void
+test02()
+{ }
+#endif
+
+int
+main()
+{
+  test01();
+  test02();
+  return 0;
+}
@@ -0,0 +1,100 @@
+// { dg-do run { target *-*-freebsd* *-*-netbsd* *-*-linux* *-*-gnu* *-*-solaris* *-*-cygwin *-*-darwin* powerpc-ibm-aix* } }
+// { dg-options " -pthread" { target *-*-freebsd* *-*-netbsd* *-*-linux* *-*-gnu* powerpc-ibm-aix* } }
+// { dg-options " -pthreads" { target *-*-solaris* } }
+// { dg-require-cstdint "" }
+// { dg-require-gthreads "" }
+
+// Copyright (C) 2014 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// The algorithms that run through an executor work, and link, without
+// -fopenmp.
+
+#include <parallel/algorithm>
+#include <parallel/numeric>
+#include <parallel/executor.h>
+#include <vector>
+#include <testsuite_hooks.h>
+
+struct counting_executor : __gnu_parallel::_ThreadPoolExecutor
+{
+  counting_executor() : regions(0) { }
+
+  virtual __gnu_parallel::_ThreadIndex
+  _M_run(__gnu_parallel::_ThreadIndex num_threads, _Body body, void* arg)
+  {
+    ++regions;
+    return __gnu_parallel::_ThreadPoolExecutor::_M_run(num_threads,
+							 body, arg);
+  }
+
+  int regions;
+};
+
+struct add_one
+{
+  void operator()(int& x) const { ++x; }
+};
+
+void
+test01()
+{
+  bool test __attribute__((unused)) = true;
+
+  __gnu_parallel::_Settings s;
+  s.algorithm_strategy = __gnu_parallel::force_parallel;
+  __gnu_parallel::_Settings::set(s);
+
+  counting_executor counting;
+  __gnu_parallel::_Executor::set(&counting);
+
+  const int N = 100000;
+  std::vector<int> v(N);
+  for (int i = 0; i < N; ++i)
+    v[i] = (i * 7919) % N;
+
+  std::vector<int> w(v);
+  __gnu_parallel::sort(v.begin(), v.end(), __gnu_parallel::parallel_tag(4));
+  for (int i = 0; i < N; ++i)
+    VERIFY( v[i] == i );
+  VERIFY( counting.regions > 0 );
+
+  __gnu_parallel::stable_sort(w.begin(), w.end());
+  VERIFY( w == v );
+
+  std::vector<long> sums(N);
+  __gnu_parallel::partial_sum(v.begin(), v.end(), sums.begin());
+  for (int i = 0; i < N; ++i)
+    VERIFY( sums[i] == long(i) * (i + 1) / 2 );
+
+  __gnu_parallel::for_each(v.begin(), v.end(), add_one());
+  for (int i = 0; i < N; ++i)
+    VERIFY( v[i] == i + 1 );
+
+  VERIFY( __gnu_parallel::find(v.begin(), v.end(), N / 2)
+	  == v.begin() + N / 2 - 1 );
+  VERIFY( __gnu_parallel::find(v.begin(), v.end(), 0) == v.end() );
+
+  __gnu_parallel::_Executor::set(0);
+}
+
+int
+main()
+{
+  test01();
+  return 0;
+}
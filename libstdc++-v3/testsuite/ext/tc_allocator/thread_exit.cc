@@ -0,0 +1,88 @@
+// { dg-do run { target *-*-freebsd* *-*-netbsd* *-*-linux* *-*-gnu* *-*-solaris* *-*-cygwin *-*-darwin* powerpc-ibm-aix* } }
+// { dg-options " -std=gnu++11 -pthread" { target *-*-freebsd* *-*-netbsd* *-*-linux* *-*-gnu* powerpc-ibm-aix* } }
+// { dg-options " -std=gnu++11 -pthreads" { target *-*-solaris* } }
+// { dg-options " -std=gnu++11 " { target *-*-cygwin *-*-darwin* } }
+// { dg-require-cstdint "" }
+// { dg-require-gthreads "" }
+
+// Copyright (C) 2014 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// Thread-local objects destroyed after the thread's cache can still
+// allocate and free.
+
+#include <ext/tc_allocator.h>
+#include <list>
+#include <vector>
+#include <thread>
+#include <testsuite_hooks.h>
+
+typedef __gnu_cxx::__tc_alloc<int> alloc_type;
+typedef std::list<int, alloc_type> list_type;
+
+struct holder
+{
+  list_type* l = nullptr;
+
+  ~holder()
+  {
+    bool test __attribute__((unused)) = true;
+
+    // The cache was created after this object, so it is already gone.
+    for (int i = 0; i < 1000; ++i)
+      l->push_back(i);
+    VERIFY( l->size() == 2000 );
+    delete l;
+  }
+};
+
+thread_local holder h;
+
+void
+run()
+{
+  holder& mine = h;
+  mine.l = new list_type;
+  for (int i = 0; i < 1000; ++i)
+    mine.l->push_back(i);
+}
+
+void test01()
+{
+  bool test __attribute__((unused)) = true;
+
+  for (int round = 0; round < 10; ++round)
+    {
+      std::vector<std::thread> threads;
+      for (int t = 0; t < 4; ++t)
+	threads.push_back(std::thread(run));
+      for (auto& th : threads)
+	th.join();
+    }
+
+  // The blocks freed at thread exit are reused.
+  list_type l;
+  for (int i = 0; i < 100000; ++i)
+    l.push_back(i);
+  VERIFY( l.size() == 100000 );
+}
+
+int main()
+{
+  test01();
+  return 0;
+}
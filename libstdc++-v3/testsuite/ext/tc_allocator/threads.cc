@@ -0,0 +1,87 @@
+// { dg-do run { target *-*-freebsd* *-*-netbsd* *-*-linux* *-*-gnu* *-*-solaris* *-*-cygwin *-*-darwin* powerpc-ibm-aix* } }
+// { dg-options " -std=gnu++11 -pthread" { target *-*-freebsd* *-*-netbsd* *-*-linux* *-*-gnu* powerpc-ibm-aix* } }
+// { dg-options " -std=gnu++11 -pthreads" { target *-*-solaris* } }
+// { dg-options " -std=gnu++11 " { target *-*-cygwin *-*-darwin* } }
+// { dg-require-cstdint "" }
+// { dg-require-gthreads "" }
+
+// Copyright (C) 2014 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// Blocks allocated in one thread and freed in another, and blocks
+// left in the cache of a thread that has exited, are reused correctly.
+
+#include <ext/tc_allocator.h>
+#include <list>
+#include <vector>
+#include <thread>
+#include <testsuite_hooks.h>
+
+typedef __gnu_cxx::__tc_alloc<int> alloc_type;
+typedef std::list<int, alloc_type> list_type;
+
+void
+fill(list_type& l, int base, int n)
+{
+  for (int i = 0; i < n; ++i)
+    l.push_back(base + i);
+}
+
+void
+check(const list_type& l, int base, int n)
+{
+  bool test __attribute__((unused)) = true;
+
+  int i = 0;
+  for (auto it = l.begin(); it != l.end(); ++it, ++i)
+    VERIFY( *it == base + i );
+  VERIFY( i == n );
+}
+
+void test01()
+{
+  const int nthreads = 4;
+  const int n = 10000;
+
+  // Each list is filled by one thread and destroyed by another.
+  std::vector<list_type> lists(nthreads);
+  std::vector<std::thread> threads;
+  for (int t = 0; t < nthreads; ++t)
+    threads.push_back(std::thread(fill, std::ref(lists[t]), t * n, n));
+  for (auto& th : threads)
+    th.join();
+  threads.clear();
+
+  for (int t = 0; t < nthreads; ++t)
+    threads.push_back(std::thread([&lists, t, n, nthreads]
+				  {
+				    list_type l;
+				    l.swap(lists[(t + 1) % nthreads]);
+				    fill(lists[(t + 1) % nthreads], -n, n);
+				  }));
+  for (auto& th : threads)
+    th.join();
+
+  for (int t = 0; t < nthreads; ++t)
+    check(lists[t], -n, n);
+}
+
+int main()
+{
+  test01();
+  return 0;
+}
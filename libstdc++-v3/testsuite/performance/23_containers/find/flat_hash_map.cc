@@ -0,0 +1,78 @@
+// { dg-options "-std=gnu++11" }
+
+// Copyright (C) 2014 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// Compare lookups and insertions in __gnu_cxx::flat_hash_map and
+// std::unordered_map, from tables that fit in cache to ones that don't.
+
+#include <ext/flat_hash_map.h>
+#include <unordered_map>
+#include <sstream>
+#include <vector>
+#include <cstdlib>
+#include <testsuite_performance.h>
+
+namespace
+{
+  template<typename _ContType>
+    void
+    bench(const char* desc, const std::vector<int>& keys)
+    {
+      using namespace __gnu_test;
+
+      time_counter time;
+      resource_counter resource;
+      const std::size_t lookups = 10000000;
+      std::ostringstream ostr;
+
+      start_counters(time, resource);
+      _ContType m;
+      for (std::size_t i = 0; i != keys.size(); ++i)
+	m[keys[i]] = i;
+      stop_counters(time, resource);
+      ostr << desc << " " << keys.size() << ": insert";
+      report_performance(__FILE__, ostr.str().c_str(), time, resource);
+
+      std::size_t found = 0;
+      start_counters(time, resource);
+      for (std::size_t i = 0; i != lookups; ++i)
+	found += m.count(keys[i % keys.size()] + (i & 1));
+      stop_counters(time, resource);
+      ostr.str("");
+      ostr << desc << " " << keys.size() << ": find (" << found << " hits)";
+      report_performance(__FILE__, ostr.str().c_str(), time, resource);
+    }
+}
+
+int
+main()
+{
+  const std::size_t sizes[] = { 1000, 100000, 10000000, 100000000 };
+  for (std::size_t n : sizes)
+    {
+      std::vector<int> keys;
+      keys.reserve(n);
+      for (std::size_t i = 0; i != n; ++i)
+	keys.push_back(std::rand() & ~1);
+
+      bench<std::unordered_map<int, int> >("std::unordered_map", keys);
+      bench<__gnu_cxx::flat_hash_map<int, int> >("__gnu_cxx::flat_hash_map",
+						 keys);
+    }
+  return 0;
+}
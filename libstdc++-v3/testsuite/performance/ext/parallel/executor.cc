@@ -0,0 +1,113 @@
+// Copyright (C) 2014 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// Compare the parallel mode algorithms on the gthreads thread pool and
+// on OpenMP threads.
+
+#include <algorithm>
+#include <numeric>
+#include <vector>
+#include <testsuite_performance.h>
+
+#if _GLIBCXX_PARALLEL
+#include <parallel/executor.h>
+
+struct add_one
+{
+  void operator()(int& x) const { ++x; }
+};
+
+void
+run(const char* backend)
+{
+  using namespace __gnu_test;
+
+  time_counter time;
+  resource_counter resource;
+
+  const int max_size = 4000000;
+  const int iterations = 10;
+  char name[64];
+
+  std::vector<int> v(max_size);
+  std::vector<int> sums(max_size);
+
+  start_counters(time, resource);
+  for (int j = 0; j < iterations; ++j)
+    {
+      v[0] = j;
+      for (int i = 1; i < max_size; ++i)
+	v[i] = (v[i - 1] + 110211473) * 745988807;
+      std::sort(v.begin(), v.end());
+    }
+  stop_counters(time, resource);
+  __builtin_sprintf(name, "%s sort", backend);
+  report_performance(__FILE__, name, time, resource);
+  clear_counters(time, resource);
+
+  start_counters(time, resource);
+  for (int j = 0; j < iterations; ++j)
+    std::partial_sum(v.begin(), v.end(), sums.begin());
+  stop_counters(time, resource);
+  __builtin_sprintf(name, "%s partial_sum", backend);
+  report_performance(__FILE__, name, time, resource);
+  clear_counters(time, resource);
+
+  start_counters(time, resource);
+  for (int j = 0; j < iterations; ++j)
+    std::for_each(v.begin(), v.end(), add_one());
+  stop_counters(time, resource);
+  __builtin_sprintf(name, "%s for_each", backend);
+  report_performance(__FILE__, name, time, resource);
+  clear_counters(time, resource);
+
+  start_counters(time, resource);
+  for (int j = 0; j < iterations * 10; ++j)
+    std::find(v.begin(), v.end(), v[max_size - 1 - j]);
+  stop_counters(time, resource);
+  __builtin_sprintf(name, "%s find", backend);
+  report_performance(__FILE__, name, time, resource);
+  clear_counters(time, resource);
+}
+
+int
+main()
+{
+  __gnu_parallel::_Settings s;
+  s.algorithm_strategy = __gnu_parallel::force_parallel;
+  __gnu_parallel::_Settings::set(s);
+
+  __gnu_parallel::_ThreadPoolExecutor pool;
+  __gnu_parallel::_Executor::set(&pool);
+  run("pool");
+
+#ifdef _OPENMP
+  __gnu_parallel::_OpenMPExecutor omp;
+  __gnu_parallel::_Executor::set(&omp);
+  run("OpenMP");
+#endif
+
+  __gnu_parallel::_Executor::set(0);
+  return 0;
+}
+#else
+int
+main()
+{
+  return 0;
+}
+#endif
@@ -0,0 +1,119 @@
+// { dg-options "-std=gnu++11 -pthread" { target *-*-freebsd* *-*-netbsd* *-*-linux* *-*-gnu* } }
+// { dg-require-gthreads "" }
+
+// Copyright (C) 2014 Free Software Foundation, Inc.
+//
+// This file is part of the GNU ISO C++ Library.  This library is free
+// software; you can redistribute it and/or modify it under the
+// terms of the GNU General Public License as published by the
+// Free Software Foundation; either version 3, or (at your option)
+// any later version.
+
+// This library is distributed in the hope that it will be useful,
+// but WITHOUT ANY WARRANTY; without even the implied warranty of
+// MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+// GNU General Public License for more details.
+
+// You should have received a copy of the GNU General Public License along
+// with this library; see the file COPYING3.  If not see
+// <http://www.gnu.org/licenses/>.
+
+// Container churn in several threads at once: each thread repeatedly
+// fills and empties a list and a map, and hands half of its list to
+// the next thread so that some blocks are freed by a thread other than
+// the one that allocated them.
+
+#include <list>
+#include <map>
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <sstream>
+#include <ext/pool_allocator.h>
+#include <ext/mt_allocator.h>
+#include <ext/tc_allocator.h>
+#include <testsuite_performance.h>
+
+namespace
+{
+  const int rounds = 200;
+  const int elements = 2000;
+
+  template<typename _Alloc>
+    void
+    churn(std::vector<std::list<int, _Alloc> >& mailboxes,
+	  std::vector<std::mutex>& locks, int self)
+    {
+      typedef typename _Alloc::template rebind<std::pair<const int, int> >
+	::other map_alloc;
+      typedef std::list<int, _Alloc> list_type;
+      std::map<int, int, std::less<int>, map_alloc> m;
+      list_type l;
+      const int next = (self + 1) % mailboxes.size();
+
+      for (int r = 0; r < rounds; ++r)
+	{
+	  for (int i = 0; i < elements; ++i)
+	    {
+	      l.push_back(i);
+	      m[i * 7919 % elements] = i;
+	    }
+	  m.clear();
+
+	  // Pass half of the list on, and free what was passed to us.
+	  list_type out;
+	  auto mid = l.begin();
+	  std::advance(mid, elements / 2);
+	  out.splice(out.end(), l, l.begin(), mid);
+	  list_type in;
+	  {
+	    std::lock_guard<std::mutex> g(locks[next]);
+	    mailboxes[next].splice(mailboxes[next].end(), out);
+	  }
+	  {
+	    std::lock_guard<std::mutex> g(locks[self]);
+	    in.swap(mailboxes[self]);
+	  }
+	  l.clear();
+	}
+    }
+
+  template<typename _Alloc>
+    void
+    bench(const char* desc, int nthreads)
+    {
+      using namespace __gnu_test;
+
+      time_counter time;
+      resource_counter resource;
+
+      std::vector<std::list<int, _Alloc> > mailboxes(nthreads);
+      std::vector<std::mutex> locks(nthreads);
+      std::vector<std::thread> threads;
+
+      start_counters(time, resource);
+      for (int t = 0; t < nthreads; ++t)
+	threads.push_back(std::thread(churn<_Alloc>, std::ref(mailboxes),
+				      std::ref(locks), t));
+      for (auto& th : threads)
+	th.join();
+      stop_counters(time, resource);
+
+      std::ostringstream ostr;
+      ostr << desc << " " << nthreads << " threads";
+      report_performance(__FILE__, ostr.str().c_str(), time, resource);
+    }
+}
+
+int
+main()
+{
+  for (int n = 1; n <= 16; n *= 2)
+    {
+      bench<std::allocator<int> >("std::allocator", n);
+      bench<__gnu_cxx::__pool_alloc<int> >("__gnu_cxx::__pool_alloc", n);
+      bench<__gnu_cxx::__mt_alloc<int> >("__gnu_cxx::__mt_alloc", n);
+      bench<__gnu_cxx::__tc_alloc<int> >("__gnu_cxx::__tc_alloc", n);
+    }
+  return 0;
+}